@@ -1,32 +1,563 @@
 #include "src/net/WebSocketClient.hpp"
+#include "src/net/MarketDataGateway.hpp"
+#include "src/net/MetricsServer.hpp"
 #include "src/core/MarketState.hpp"
 #include "src/core/ArbitrageDetector.hpp"
+#include "src/core/MarketUpdatePipeline.hpp"
+#include "src/core/SharedBookSegment.hpp"
+#include "src/core/UniverseScanner.hpp"
+#include "src/core/OpportunityTracker.hpp"
+#ifndef ARB_NO_UI
 #include "src/ui/ArbitrageUI.hpp"
+#endif
 #include "src/util/ArbitrageLogger.hpp"
+#include "src/util/EngineMetrics.hpp"
+#include "src/util/LatencyHistogram.hpp"
+#include "src/util/OpportunityBroadcaster.hpp"
+#include "src/util/OpportunityJournal.hpp"
+#include "src/util/PrometheusWriter.hpp"
+#include "src/util/TickCapture.hpp"
 #include "src/config/Symbols.hpp"
+#include "src/config/EngineConfig.hpp"
+#include "src/config/ExchangeInfo.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
 #include <chrono>
+#include <csignal>
+#include <filesystem>
 #include <thread>
 #include <vector>
 #include <memory>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
 
-int main() {
+namespace {
+    // Binance allows up to 1024 streams per connection; stay well below it
+    constexpr size_t STREAMS_PER_CONNECTION = 200;
+    
+    // How often pipeline latency percentiles are appended to the latency file
+    constexpr std::chrono::seconds LATENCY_DUMP_INTERVAL{10};
+    
+    // How often the config file is checked for changes and SIGHUP
+    constexpr std::chrono::milliseconds CONFIG_POLL_INTERVAL{500};
+    
+    struct Options {
+        std::string config_path;  // Empty: built-in routes and symbols, nothing to reload
+        std::string exchange_info_path;  // Empty: use the built-in ARB symbol set
+        UniverseFilter filter;
+        size_t scan_threads = 1;
+        std::string capture_path;  // Empty: no tick capture
+        std::string broadcast_name; // Empty: no shared-memory opportunity broadcast
+        std::string shm_books_name; // Empty: books are not mirrored to shared memory
+        int gateway_port = 0;       // 0: no TCP market-data gateway (127.0.0.1 only)
+        std::string gateway_socket; // Empty: no Unix-socket market-data gateway
+        int metrics_port = 0;       // 0: no Prometheus endpoint (127.0.0.1 only)
+        std::string feed_host;      // Empty: stream.binance.com:443
+        std::string feed_port;
+        int ui_fps = 5;            // Redraw cap; the UI redraws only on change
+#ifdef ARB_NO_UI
+        bool headless = true;      // Built without the UI
+#else
+        bool headless = false;     // No UI: run until SIGINT/SIGTERM
+#endif
+        int stats_interval_s = 10; // Headless stats line period
+        bool single_writer = false; // Feeds hand updates to one market-state thread over SPSC rings
+    };
+    
+    // Set from the signal handler; lock-free, so async-signal-safe
+    std::atomic<bool> shutdown_requested{false};
+    
+    extern "C" void onShutdownSignal(int) {
+        shutdown_requested.store(true);
+    }
+    
+    // Set on SIGHUP, taken by the config reload thread
+    std::atomic<bool> reload_requested{false};
+    
+    extern "C" void onReloadSignal(int) {
+        reload_requested.store(true);
+    }
+    
+    // Wall clock in epoch milliseconds, same base as book timestamps
+    int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    
+    // Track an opportunity; the first sighting of an episode is journaled right away
+    void observeOpportunity(OpportunityTracker& tracker, OpportunityJournal& journal,
+                            const ArbitrageOpportunity& opp, int64_t now_ms) {
+        if (tracker.observe(opp, now_ms)) {
+            journal.appendOpportunity(opp, now_ms);
+        }
+    }
+    
+    // Journal episodes closed by a tracker pass
+    void journalEpisodes(OpportunityJournal& journal, std::vector<OpportunityEpisode>& closed) {
+        for (const auto& episode : closed) {
+            journal.appendEpisode(episode);
+        }
+        closed.clear();
+    }
+    
+    std::vector<std::string> splitAssets(const std::string& list) {
+        std::vector<std::string> assets;
+        std::istringstream iss(list);
+        std::string asset;
+        while (std::getline(iss, asset, ',')) {
+            if (!asset.empty()) {
+                assets.push_back(asset);
+            }
+        }
+        return assets;
+    }
+    
+    // Whole-string integer in [min_value, max_value]; nullopt on junk, overflow or out of range
+    std::optional<int> parseInt(const std::string& text, int min_value, int max_value) {
+        int value = 0;
+        const char* last = text.data() + text.size();
+        auto result = std::from_chars(text.data(), last, value);
+        if (result.ec != std::errc() || result.ptr != last || value < min_value || value > max_value) {
+            return std::nullopt;
+        }
+        return value;
+    }
+    
+    // False on a missing value, an unknown option or a numeric value that does not parse
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; ++i) {
+            std::string flag = argv[i];
+            if (flag == "--headless") {
+                options.headless = true;
+                continue;
+            }
+            if (flag == "--single-writer") {
+                options.single_writer = true;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                std::cerr << "Missing value for option: " << flag << std::endl;
+                return false;
+            }
+            std::string value = argv[++i];
+            if (flag == "--config") {
+                options.config_path = value;
+            } else if (flag == "--exchange-info") {
+                options.exchange_info_path = value;
+            } else if (flag == "--include") {
+                options.filter.include_assets = splitAssets(value);
+            } else if (flag == "--exclude") {
+                options.filter.exclude_assets = splitAssets(value);
+            } else if (flag == "--capture") {
+                options.capture_path = value;
+            } else if (flag == "--broadcast") {
+                options.broadcast_name = value;
+            } else if (flag == "--shm-books") {
+                options.shm_books_name = value;
+            } else if (flag == "--gateway-port") {
+                auto port = parseInt(value, 0, 65535);
+                if (!port.has_value()) {
+                    std::cerr << "Invalid port for " << flag << ": " << value << std::endl;
+                    return false;
+                }
+                options.gateway_port = port.value();
+            } else if (flag == "--gateway-socket") {
+                options.gateway_socket = value;
+            } else if (flag == "--feed") {
+                // host:port of a Binance-compatible stream server, e.g. arb_mock_exchange
+                size_t colon = value.rfind(':');
+                if (colon == std::string::npos || colon == 0 || !parseInt(value.substr(colon + 1), 1, 65535)) {
+                    std::cerr << "Expected HOST:PORT for " << flag << ": " << value << std::endl;
+                    return false;
+                }
+                options.feed_host = value.substr(0, colon);
+                options.feed_port = value.substr(colon + 1);
+            } else if (flag == "--metrics-port") {
+                auto port = parseInt(value, 0, 65535);
+                if (!port.has_value()) {
+                    std::cerr << "Invalid port for " << flag << ": " << value << std::endl;
+                    return false;
+                }
+                options.metrics_port = port.value();
+            } else if (flag == "--scan-threads" || flag == "--ui-fps" || flag == "--stats-interval") {
+                auto count = parseInt(value, 1, std::numeric_limits<int>::max());
+                if (!count.has_value()) {
+                    std::cerr << "Expected a positive integer for " << flag << ": " << value << std::endl;
+                    return false;
+                }
+                if (flag == "--scan-threads") {
+                    options.scan_threads = static_cast<size_t>(count.value());
+                } else if (flag == "--ui-fps") {
+                    options.ui_fps = count.value();
+                } else {
+                    options.stats_interval_s = count.value();
+                }
+            } else {
+                std::cerr << "Unknown option: " << flag << std::endl;
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    EngineStats sampleStats(const std::vector<std::unique_ptr<WebSocketClient>>& clients, const ArbitrageDetector& detector,
+                            const OpportunityJournal& journal, const TickCapture* capture,
+                            const MarketUpdatePipeline* pipeline) {
+        EngineStats stats;
+        stats.feeds = clients.size();
+        for (const auto& client : clients) {
+            FeedStats feed = client->getStats();
+            stats.feeds_connected += feed.connected ? 1 : 0;
+            stats.messages += feed.messages;
+            stats.bytes += feed.bytes;
+            stats.parse_failures += feed.parse_failures;
+            stats.reconnects += feed.reconnects;
+        }
+        stats.check_count = detector.getCheckCount();
+        stats.journal_written = journal.getWrittenCount();
+        stats.journal_dropped = journal.getDroppedCount();
+        stats.ticks_captured = capture != nullptr ? capture->getRecordCount() : 0;
+        stats.ring_overflows = pipeline != nullptr ? pipeline->getStats().overflows : 0;
+        stats.snapshot_ns = static_cast<int64_t>(PipelineLatency::nowNs());
+        return stats;
+    }
+    
+    // Config file modification time; min() if it cannot be read
+    std::filesystem::file_time_type configWriteTime(const std::string& path) {
+        std::error_code error;
+        auto write_time = std::filesystem::last_write_time(path, error);
+        return error ? std::filesystem::file_time_type::min() : write_time;
+    }
+    
+    // Move the feeds to a new symbol set without reconnecting: removed streams
+    // are unsubscribed on the connection carrying them, added streams go to the
+    // least loaded live connection. connections[i] mirrors clients[i]
+    // Returns the number of streams added and removed
+    std::pair<size_t, size_t> applySubscriptionDelta(const std::vector<std::string>& symbols,
+                                                     std::vector<std::vector<std::string>>& connections,
+                                                     const std::vector<std::unique_ptr<WebSocketClient>>& clients) {
+        std::vector<std::string> wanted;
+        for (const auto& symbol : symbols) {
+            wanted.push_back(Symbols::toBinanceStream(symbol));
+        }
+        
+        size_t removed = 0;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            std::vector<std::string> dropped;
+            for (const auto& stream : connections[i]) {
+                if (std::find(wanted.begin(), wanted.end(), stream) == wanted.end()) {
+                    dropped.push_back(stream);
+                }
+            }
+            if (dropped.empty()) {
+                continue;
+            }
+            clients[i]->unsubscribe(dropped);
+            for (const auto& stream : dropped) {
+                connections[i].erase(std::find(connections[i].begin(), connections[i].end(), stream));
+            }
+            removed += dropped.size();
+        }
+        
+        size_t added = 0;
+        std::vector<std::vector<std::string>> additions(connections.size());
+        for (const auto& stream : wanted) {
+            bool present = std::any_of(connections.begin(), connections.end(), [&stream](const auto& streams) {
+                return std::find(streams.begin(), streams.end(), stream) != streams.end();
+            });
+            if (present || connections.empty()) {
+                continue;
+            }
+            // Requests go out after the next frame, so an idle connection is only a last resort
+            size_t target = 0;
+            for (size_t i = 1; i < connections.size(); ++i) {
+                bool better_idle = connections[target].empty() && !connections[i].empty();
+                bool less_loaded = !connections[i].empty() && connections[i].size() < connections[target].size();
+                if (better_idle || less_loaded) {
+                    target = i;
+                }
+            }
+            connections[target].push_back(stream);
+            additions[target].push_back(stream);
+            ++added;
+        }
+        for (size_t i = 0; i < additions.size(); ++i) {
+            if (!additions[i].empty()) {
+                clients[i]->subscribe(additions[i]);
+            }
+        }
+        
+        return {added, removed};
+    }
+    
+    // Validate the config file off the detection path and apply it; a file that
+    // does not load leaves the running configuration untouched
+    void reloadConfig(const std::string& path, ArbitrageDetector& detector, bool manage_streams,
+                      std::vector<std::vector<std::string>>& connections,
+                      const std::vector<std::unique_ptr<WebSocketClient>>& clients, bool verbose) {
+        std::string error;
+        auto config = EngineConfig::loadFromFile(path, &error);
+        if (!config.has_value()) {
+            if (verbose) {
+                std::cout << "Config reload rejected (" << path << "): " << error << std::endl;
+            }
+            return;
+        }
+        
+        // Subscribe first, so the new routes' books start filling before they are checked
+        std::pair<size_t, size_t> delta{0, 0};
+        if (manage_streams) {
+            delta = applySubscriptionDelta(config->getSubscriptionSymbols(), connections, clients);
+        }
+        uint64_t version = detector.applyConfig(config->detector);
+        
+        if (verbose) {
+            std::cout << "Config " << version << " applied: " << config->detector.routes.size() << " routes, threshold "
+                      << config->detector.threshold_percent << "%, fee " << config->detector.fee_percent << "%";
+            if (manage_streams) {
+                std::cout << ", +" << delta.first << "/-" << delta.second << " streams";
+            }
+            std::cout << std::endl;
+        }
+    }
+    
+    // Headless main loop: no terminal rendering, one stats line per interval
+    // Returns once SIGINT or SIGTERM was received
+    void runHeadless(const std::vector<std::unique_ptr<WebSocketClient>>& clients, const ArbitrageDetector& detector,
+                     const OpportunityJournal& journal, const TickCapture* capture,
+                     const MarketUpdatePipeline* pipeline, ArbitrageLogger& logger, std::chrono::seconds stats_interval) {
+        EngineStats last_stats = sampleStats(clients, detector, journal, capture, pipeline);
+        auto next_stats = std::chrono::steady_clock::now() + stats_interval;
+        while (!shutdown_requested.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (std::chrono::steady_clock::now() >= next_stats) {
+                EngineStats stats = sampleStats(clients, detector, journal, capture, pipeline);
+                logger.logStats(stats, last_stats);
+                last_stats = stats;
+                next_stats += stats_interval;
+            }
+        }
+        std::cout << "Shutdown requested" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "usage: arb_engine [--config FILE] [--exchange-info FILE] [--include A,B,...] [--exclude A,B,...]\n"
+                     "                  [--scan-threads N] [--capture FILE] [--broadcast NAME] [--shm-books NAME]\n"
+                     "                  [--gateway-port PORT] [--gateway-socket PATH] [--metrics-port PORT]\n"
+                     "                  [--feed HOST:PORT] [--ui-fps N] [--stats-interval SECONDS] [--headless] [--single-writer]"
+                  << std::endl;
+        return 2;
+    }
+    if (options.headless) {
+        // Under systemd, SIGTERM stops the engine through the normal shutdown path
+        std::signal(SIGINT, onShutdownSignal);
+        std::signal(SIGTERM, onShutdownSignal);
+    }
+    
+    // Routes, threshold and fees; re-read on change or SIGHUP when loaded from a file
+    EngineConfig config = EngineConfig::defaults();
+    auto config_write_time = std::filesystem::file_time_type::min();
+    if (!options.config_path.empty()) {
+        config_write_time = configWriteTime(options.config_path);
+        std::string error;
+        auto loaded = EngineConfig::loadFromFile(options.config_path, &error);
+        if (!loaded.has_value()) {
+            std::cerr << "Failed to load config " << options.config_path << ": " << error << std::endl;
+            return 1;
+        }
+        config = std::move(loaded.value());
+        std::cout << "Loaded " << config.detector.routes.size() << " routes from " << options.config_path << std::endl;
+#ifdef SIGHUP
+        std::signal(SIGHUP, onReloadSignal);
+#endif
+    }
+    
+    // Optional shared-memory mirror of every book for external readers (C shim: shim/arb_books.h)
+    // Declared before MarketState so that it outlives the books writing into it
+    std::unique_ptr<SharedBookSegment> book_segment;
+    if (!options.shm_books_name.empty()) {
+        book_segment = SharedBookSegment::create(options.shm_books_name);
+        if (!book_segment) {
+            std::cerr << "Failed to create shared book segment " << options.shm_books_name << std::endl;
+            return 1;
+        }
+        std::cout << "Mirroring books to shared memory " << options.shm_books_name << std::endl;
+    }
     MarketState market_state;
+    market_state.attachSharedSegment(book_segment.get());
+    
+    // Optional full symbol universe from a local exchangeInfo file
+    std::optional<SymbolUniverse> universe;
+    if (!options.exchange_info_path.empty()) {
+        auto load_start = std::chrono::steady_clock::now();
+        universe = SymbolUniverse::loadFromFile(options.exchange_info_path, options.filter);
+        auto load_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - load_start).count();
+        
+        if (!universe.has_value()) {
+            std::cerr << "Failed to load exchangeInfo from " << options.exchange_info_path << std::endl;
+            return 1;
+        }
+        std::cout << "Loaded " << universe->getSymbols().size() << " pairs from "
+                  << options.exchange_info_path << " in " << load_ms << " ms" << std::endl;
+    }
+    
+    ArbitrageDetector detector(market_state, config.detector);
+    
+    // Optional shared-memory ring of event-path opportunities for local execution processes
+    std::unique_ptr<OpportunityBroadcaster> broadcaster;
+    if (!options.broadcast_name.empty()) {
+        broadcaster = OpportunityBroadcaster::create(options.broadcast_name, market_state);
+        if (!broadcaster) {
+            std::cerr << "Failed to create opportunity broadcast " << options.broadcast_name << std::endl;
+            return 1;
+        }
+        std::cout << "Broadcasting opportunities to shared memory " << options.broadcast_name << std::endl;
+    }
+    
+    // Event path: an opportunity is emitted as soon as the update that produced it is checked
+    detector.setOpportunityCallback([&broadcaster](const ArbitrageOpportunity& opp, uint64_t receive_ns) {
+        if (broadcaster) {
+            broadcaster->publish(opp, receive_ns, nowMs());
+        }
+        if (receive_ns != 0) {
+            PipelineLatency::record(PipelineStage::ReceiveToEmit, PipelineLatency::nowNs() - receive_ns);
+        }
+    });
+    
+    // Optional binary capture of every applied book update
+    std::unique_ptr<TickCapture> capture;
+    if (!options.capture_path.empty()) {
+        capture = TickCapture::create(options.capture_path, market_state);
+        if (!capture) {
+            std::cerr << "Failed to create tick capture " << options.capture_path << std::endl;
+            return 1;
+        }
+        std::cout << "Capturing ticks to " << options.capture_path << std::endl;
+    }
+    
+    // Optional local fan-out of every normalized update to subscriber processes
+    std::unique_ptr<MarketDataGateway> gateway;
+    if (options.gateway_port != 0 || !options.gateway_socket.empty()) {
+        GatewayConfig gateway_config;
+        gateway_config.tcp_port = static_cast<uint16_t>(options.gateway_port);
+        gateway_config.unix_path = options.gateway_socket;
+        gateway = MarketDataGateway::create(market_state, gateway_config);
+        if (!gateway) {
+            std::cerr << "Failed to start market-data gateway" << std::endl;
+            return 1;
+        }
+        gateway->start();
+        std::cout << "Market-data gateway listening on";
+        if (options.gateway_port != 0) {
+            std::cout << " 127.0.0.1:" << options.gateway_port;
+        }
+        if (!options.gateway_socket.empty()) {
+            std::cout << " " << options.gateway_socket;
+        }
+        std::cout << std::endl;
+    }
+    
+    // Opportunities and episodes go to an append-only journal written off the detection threads
+    OpportunityJournal journal(market_state);
+    
+    // Logger for periodic latency dumps (detector thread) and headless stats (main thread)
+    ArbitrageLogger logger;
     
     // Get all symbols to monitor
-    auto all_symbols = Symbols::getAllSymbols();
+    auto all_symbols = universe.has_value() ? universe->getPairs() : config.getSubscriptionSymbols();
     
     std::cout << "Starting WebSocket clients for " << all_symbols.size() << " symbols..." << std::endl;
     
-    // Start WebSocket clients for all symbols
+    // Without a universe every symbol gets its own connection;
+    // a loaded universe is multiplexed over combined-stream connections
+    std::vector<std::vector<std::string>> connections;
+    size_t streams_per_connection = universe.has_value() ? STREAMS_PER_CONNECTION : 1;
+    for (const auto& symbol : all_symbols) {
+        if (connections.empty() || connections.back().size() >= streams_per_connection) {
+            connections.emplace_back();
+        }
+        connections.back().push_back(Symbols::toBinanceStream(symbol));
+    }
+    
+    // Single-writer mode: feeds publish into per-feed rings, one thread owns book writes and detection
+    std::unique_ptr<MarketUpdatePipeline> pipeline;
+    if (options.single_writer) {
+        pipeline = std::make_unique<MarketUpdatePipeline>(market_state, &detector);
+    }
+    
+    // Create WebSocket clients; pipeline producers must all be registered before it starts
     std::vector<std::unique_ptr<WebSocketClient>> clients;
     
-    for (const auto& symbol : all_symbols) {
-        std::string stream = Symbols::toBinanceStream(symbol);
-        std::cout << "  Connecting to: " << symbol << " (" << stream << ")" << std::endl;
+    for (const auto& streams : connections) {
+        clients.push_back(std::make_unique<WebSocketClient>(streams, market_state));
+        if (!options.feed_host.empty()) {
+            clients.back()->setEndpoint(options.feed_host, options.feed_port);
+        }
+        if (universe.has_value()) {
+            clients.back()->setSymbolUniverse(&universe.value());
+        }
+        if (capture) {
+            clients.back()->setTickCapture(capture.get());
+        }
+        if (gateway) {
+            clients.back()->setGateway(gateway.get());
+        }
+        
+        if (pipeline) {
+            clients.back()->setUpdatePipeline(pipeline.get());
+        } else {
+            // Arbitrage checks are driven by book updates through the trigger index
+            clients.back()->setUpdateCallback([&detector](const std::string& updated, uint64_t receive_ns) {
+                detector.onBookUpdate(updated, receive_ns);
+            });
+        }
+    }
+    
+    // Optional Prometheus endpoint; scrapes are rendered on its own thread from lock-free state
+    EngineMetrics engine_metrics(market_state, detector);
+    std::unique_ptr<MetricsServer> metrics_server;
+    if (options.metrics_port != 0) {
+        for (const auto& client : clients) {
+            engine_metrics.addFeed(client.get());
+        }
+        engine_metrics.setPipeline(pipeline.get());
+        engine_metrics.setJournal(&journal);
+        engine_metrics.setGateway(gateway.get());
+        metrics_server = MetricsServer::create(static_cast<uint16_t>(options.metrics_port),
+                                               [&engine_metrics](PrometheusWriter& writer) {
+            engine_metrics.write(writer);
+        });
+        if (!metrics_server) {
+            std::cerr << "Failed to bind metrics endpoint on port " << options.metrics_port << std::endl;
+            return 1;
+        }
+        metrics_server->start();
+        std::cout << "Serving metrics on http://127.0.0.1:" << metrics_server->getPort() << "/metrics" << std::endl;
+    }
+    
+    if (pipeline) {
+        pipeline->start();
+        std::cout << "Single-writer pipeline: " << clients.size() << " feed rings" << std::endl;
+    }
+    
+    // Start WebSocket clients
+    for (size_t i = 0; i < clients.size(); ++i) {
+        const auto& streams = connections[i];
+        std::cout << "  Connecting to: " << streams.front();
+        if (streams.size() > 1) {
+            std::cout << " (+" << streams.size() - 1 << " streams)";
+        }
+        std::cout << std::endl;
         
-        clients.push_back(std::make_unique<WebSocketClient>(stream, market_state));
-        clients.back()->start();
+        clients[i]->start();
         
         // Small delay between connections to avoid rate limiting
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -37,37 +568,159 @@ int main() {
     // Wait a bit for initial data
     std::this_thread::sleep_for(std::chrono::milliseconds(2000));
     
-    // Create arbitrage detector with 0.10% threshold
-    ArbitrageDetector detector(market_state, 0.10);
-    
-    // Create logger for saving opportunities to JSON
-    ArbitrageLogger logger;
+    std::atomic<bool> scanning{true};
     
-    // Create and run UI
-    ArbitrageUI ui(market_state, detector);
-    
-    // Start arbitrage checking thread
-    std::thread check_thread([&detector, &logger]() {
-        while (true) {
-            detector.incrementCheckCount();
-            auto opportunity = detector.checkOpportunities();
-            if (opportunity.has_value() && opportunity.value().valid) {
-                // Log opportunity to JSON file
-                logger.logOpportunity(opportunity.value());
+    // Detector thread: publish one results snapshot per period for the UI and logger
+    // Opportunities become episodes; one record is written when an episode closes
+    std::thread detector_thread([&detector, &scanning, &journal, &logger]() {
+        OpportunityTracker tracker;
+        std::vector<OpportunityEpisode> closed;
+        std::array<HistogramSnapshot, PIPELINE_STAGE_COUNT> last_latency;
+        auto next_latency_dump = std::chrono::steady_clock::now() + LATENCY_DUMP_INTERVAL;
+        while (scanning.load()) {
+            detector.publishResults();
+            auto results = detector.getResults();
+            int64_t now_ms = nowMs();
+            for (const auto& route : results->routes) {
+                if (route.has_opportunity) {
+                    observeOpportunity(tracker, journal, route.opportunity, now_ms);
+                }
+            }
+            if (results->best_from_event_path) {
+                // Crossings between publications may already be gone
+                observeOpportunity(tracker, journal, results->best.value(), now_ms);
+            }
+            tracker.endPass(now_ms, closed);
+            journalEpisodes(journal, closed);
+            
+            // Periodic latency dump, percentiles over the last interval
+            if (std::chrono::steady_clock::now() >= next_latency_dump) {
+                auto latency = PipelineLatency::merge();
+                logger.logLatency(latency, last_latency);
+                last_latency = std::move(latency);
+                next_latency_dump += LATENCY_DUMP_INTERVAL;
             }
-            std::this_thread::sleep_for(std::chrono::seconds(1));
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
+        tracker.closeAll(nowMs(), closed);
+        journalEpisodes(journal, closed);
     });
     
-    // Run UI (blocking)
-    ui.run();
+    // Universe-wide triangle scan, evaluated in parallel
+    std::thread scan_thread;
+    if (universe.has_value()) {
+        auto scanner = std::make_shared<UniverseScanner>(market_state, universe.value(), "USDT",
+                                                          config.detector.threshold_percent, config.detector.fee_percent,
+                                                          options.scan_threads);
+        std::cout << "Scanning " << scanner->getRouteCount() << " triangle routes over "
+                  << scanner->getBookCount() << " books" << std::endl;
+        
+        scan_thread = std::thread([scanner, &scanning, &journal]() {
+            OpportunityTracker tracker;
+            std::vector<OpportunityEpisode> closed;
+            while (scanning.load()) {
+                auto opportunity = scanner->scan();
+                int64_t now_ms = nowMs();
+                if (opportunity.has_value()) {
+                    observeOpportunity(tracker, journal, opportunity.value(), now_ms);
+                }
+                tracker.endPass(now_ms, closed);
+                journalEpisodes(journal, closed);
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            tracker.closeAll(nowMs(), closed);
+            journalEpisodes(journal, closed);
+        });
+    }
+    
+    // Config reload: validated and applied here, never on a feed or detection thread
+    // With a universe every pair is already streamed, so only the detector changes
+    std::thread reload_thread;
+    if (!options.config_path.empty()) {
+        reload_thread = std::thread([&options, &detector, &connections, &clients, &scanning, &universe,
+                                     last_write = config_write_time]() mutable {
+            while (scanning.load()) {
+                std::this_thread::sleep_for(CONFIG_POLL_INTERVAL);
+                auto write_time = configWriteTime(options.config_path);
+                bool signalled = reload_requested.exchange(false);
+                if (!signalled && write_time == last_write) {
+                    continue;
+                }
+                last_write = write_time;
+                reloadConfig(options.config_path, detector, !universe.has_value(), connections, clients, options.headless);
+            }
+        });
+    }
+    
+    if (options.headless) {
+        std::cout << "Running headless; stats every " << options.stats_interval_s << " s. SIGINT/SIGTERM to stop." << std::endl;
+        runHeadless(clients, detector, journal, capture.get(), pipeline.get(), logger, std::chrono::seconds(options.stats_interval_s));
+    } else {
+#ifndef ARB_NO_UI
+        // Create and run UI
+        ArbitrageUI ui(market_state, detector);
+        ui.setMaxFrameRate(options.ui_fps);
+        for (const auto& client : clients) {
+            ui.addFeed(client.get());
+        }
+        
+        // Run UI (blocking)
+        ui.run();
+#endif
+    }
     
     // Cleanup
-    check_thread.detach();
+    if (metrics_server) {
+        metrics_server->stop();
+    }
+    scanning = false;
+    detector_thread.join();
+    if (scan_thread.joinable()) {
+        scan_thread.join();
+    }
+    if (reload_thread.joinable()) {
+        reload_thread.join();
+    }
     std::cout << "Stopping WebSocket clients..." << std::endl;
     for (auto& client : clients) {
         client->stop();
     }
+    if (pipeline) {
+        pipeline->stop();
+        PipelineStats pipeline_stats = pipeline->getStats();
+        std::cout << "Pipeline applied " << pipeline_stats.applied << " updates in " << pipeline_stats.batches
+                  << " batches (max " << pipeline_stats.max_batch << ")";
+        if (pipeline_stats.overflows > 0) {
+            std::cout << ", " << pipeline_stats.overflows << " dropped on full rings";
+        }
+        std::cout << std::endl;
+    }
+    
+    if (capture) {
+        capture->flush();
+        std::cout << "Captured " << capture->getRecordCount() << " ticks to " << capture->getPath();
+        if (capture->getDroppedCount() > 0) {
+            std::cout << " (" << capture->getDroppedCount() << " dropped, file full)";
+        }
+        std::cout << std::endl;
+    }
+    
+    if (gateway) {
+        gateway->stop();
+        GatewayStats gateway_stats = gateway->getStats();
+        std::cout << "Gateway sent " << gateway_stats.quotes_sent << " quotes to " << gateway_stats.accepted
+                  << " clients (" << gateway_stats.quotes_conflated << " conflated)" << std::endl;
+    }
+    
+    if (broadcaster) {
+        std::cout << "Broadcast " << broadcaster->getPublishedCount() << " opportunities" << std::endl;
+    }
+    
+    // Drain and close the journal
+    journal.stop();
+    if (journal.getDroppedCount() > 0) {
+        std::cout << "Journal dropped " << journal.getDroppedCount() << " records (queue full)" << std::endl;
+    }
     
     return 0;
 }
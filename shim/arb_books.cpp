@@ -0,0 +1,65 @@
+#define ARB_BOOKS_BUILD
+#include "arb_books.h"
+#include "src/core/SharedBookSegment.hpp"
+#include <cstring>
+#include <new>
+#include <string>
+#include <utility>
+
+struct arb_books {
+    SharedBookReader reader;
+};
+
+arb_books* arb_books_open(const char* name) {
+    if (name == nullptr) {
+        return nullptr;
+    }
+    auto reader = SharedBookReader::open(name);
+    if (!reader.has_value()) {
+        return nullptr;
+    }
+    return new (std::nothrow) arb_books{std::move(reader.value())};
+}
+
+void arb_books_close(arb_books* books) {
+    delete books;
+}
+
+uint32_t arb_books_count(const arb_books* books) {
+    return books != nullptr ? books->reader.size() : 0;
+}
+
+int arb_books_symbol(const arb_books* books, uint32_t slot, char* buffer, size_t size) {
+    if (books == nullptr || slot >= books->reader.size()) {
+        return -1;
+    }
+    std::string name = books->reader.symbolName(slot);
+    if (buffer != nullptr && size > 0) {
+        size_t length = name.size() < size - 1 ? name.size() : size - 1;
+        std::memcpy(buffer, name.data(), length);
+        buffer[length] = '\0';
+    }
+    return static_cast<int>(name.size());
+}
+
+int64_t arb_books_find(const arb_books* books, const char* symbol) {
+    if (books == nullptr || symbol == nullptr) {
+        return -1;
+    }
+    auto slot = books->reader.find(symbol);
+    return slot.has_value() ? static_cast<int64_t>(slot.value()) : -1;
+}
+
+int arb_books_read(const arb_books* books, uint32_t slot, arb_book_quote* quote) {
+    SharedBookQuote copy;
+    if (books == nullptr || quote == nullptr || !books->reader.read(slot, copy)) {
+        return 0;
+    }
+    quote->bid_price = copy.bid_price;
+    quote->bid_qty = copy.bid_qty;
+    quote->ask_price = copy.ask_price;
+    quote->ask_qty = copy.ask_qty;
+    quote->timestamp_ms = copy.timestamp_ms;
+    quote->update_count = copy.update_count;
+    return 1;
+}
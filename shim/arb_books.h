@@ -0,0 +1,56 @@
+#ifndef ARB_BOOKS_H
+#define ARB_BOOKS_H
+
+/* C interface to the engine's shared-memory top-of-book mirror
+ * (arb_engine --shm-books <name>). Reads are plain loads from the mapped
+ * segment; a read that races a write is retried, never blocked. Handles may
+ * be shared between threads of one process. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(ARB_BOOKS_BUILD)
+#define ARB_BOOKS_API __declspec(dllexport)
+#elif defined(_WIN32)
+#define ARB_BOOKS_API __declspec(dllimport)
+#else
+#define ARB_BOOKS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct arb_books arb_books;
+
+typedef struct arb_book_quote {
+    double bid_price;
+    double bid_qty;
+    double ask_price;
+    double ask_qty;
+    int64_t timestamp_ms;   /* Engine wall clock at the last update, epoch ms */
+    uint64_t update_count;  /* 0: no data yet */
+} arb_book_quote;
+
+/* NULL if the segment does not exist or has an unknown layout */
+ARB_BOOKS_API arb_books* arb_books_open(const char* name);
+ARB_BOOKS_API void arb_books_close(arb_books* books);
+
+/* Published slots; grows while the engine discovers symbols */
+ARB_BOOKS_API uint32_t arb_books_count(const arb_books* books);
+
+/* Copy the symbol name of a slot ("ARB/USDT") into buffer, NUL terminated;
+ * returns the name length, 0 for an unused slot, -1 if out of range */
+ARB_BOOKS_API int arb_books_symbol(const arb_books* books, uint32_t slot, char* buffer, size_t size);
+
+/* Slot of a symbol, -1 if not published */
+ARB_BOOKS_API int64_t arb_books_find(const arb_books* books, const char* symbol);
+
+/* Consistent snapshot of one book; 1 on success, 0 if out of range or busy */
+ARB_BOOKS_API int arb_books_read(const arb_books* books, uint32_t slot, arb_book_quote* quote);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ARB_BOOKS_H */
@@ -0,0 +1,176 @@
+#include "EngineConfig.hpp"
+#include "Symbols.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+namespace {
+    std::string trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) {
+            return std::string();
+        }
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool parseNumber(const std::string& text, double& value) {
+        if (text.empty()) {
+            return false;
+        }
+        char* end = nullptr;
+        value = std::strtod(text.c_str(), &end);
+        return end == text.c_str() + text.size();
+    }
+
+    bool fail(std::string* error, size_t line_number, const std::string& message) {
+        if (error != nullptr) {
+            *error = line_number > 0 ? "line " + std::to_string(line_number) + ": " + message : message;
+        }
+        return false;
+    }
+
+    // "cross ARB/BTC BTC/USDT [ARB/USDT]", "direct A/S A/Q", "multi A/Q0 A/I I/Q"
+    std::optional<RouteDefinition> parseRoute(const std::string& value) {
+        std::istringstream stream(value);
+        std::string kind;
+        stream >> kind;
+
+        RouteDefinition route;
+        if (kind == "cross") {
+            route.kind = RouteKind::CrossPair;
+        } else if (kind == "direct") {
+            route.kind = RouteKind::DirectComparison;
+        } else if (kind == "multi") {
+            route.kind = RouteKind::MultiLeg;
+        } else {
+            return std::nullopt;
+        }
+
+        std::string pair;
+        while (stream >> pair) {
+            route.pairs.push_back(pair);
+        }
+
+        // ARB/XXX, XXX/USDT -> ARB/USDT
+        if (route.kind == RouteKind::CrossPair && route.pairs.size() == 2) {
+            size_t first = route.pairs[0].find('/');
+            size_t second = route.pairs[1].find('/');
+            if (first != std::string::npos && second != std::string::npos) {
+                route.pairs.push_back(route.pairs[0].substr(0, first) + route.pairs[1].substr(second));
+            }
+        }
+        return route;
+    }
+}
+
+EngineConfig EngineConfig::defaults() {
+    EngineConfig config;
+    config.detector = DetectorConfig::defaults();
+    config.symbols = Symbols::getAllSymbols();
+    return config;
+}
+
+std::optional<EngineConfig> EngineConfig::loadFromFile(const std::string& path, std::string* error) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        fail(error, 0, "cannot open " + path);
+        return std::nullopt;
+    }
+
+    std::string text;
+    char buffer[4096];
+    size_t read_bytes;
+    while ((read_bytes = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        text.append(buffer, read_bytes);
+    }
+    std::fclose(file);
+
+    return parse(text, error);
+}
+
+std::optional<EngineConfig> EngineConfig::parse(const std::string& text, std::string* error) {
+    EngineConfig config;
+    config.symbols = Symbols::getAllSymbols();
+    bool has_symbols = false;
+    bool has_routes = false;
+
+    std::istringstream stream(text);
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(stream, line)) {
+        ++line_number;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            fail(error, line_number, "expected key = value");
+            return std::nullopt;
+        }
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+
+        if (key == "threshold_percent" || key == "fee_percent") {
+            double number;
+            if (!parseNumber(value, number)) {
+                fail(error, line_number, "invalid number '" + value + "'");
+                return std::nullopt;
+            }
+            (key == "threshold_percent" ? config.detector.threshold_percent : config.detector.fee_percent) = number;
+        } else if (key == "symbols") {
+            if (!has_symbols) {
+                config.symbols.clear();
+                has_symbols = true;
+            }
+            std::istringstream list(value);
+            std::string symbol;
+            while (std::getline(list, symbol, ',')) {
+                symbol = trim(symbol);
+                if (symbol.find('/') == std::string::npos) {
+                    fail(error, line_number, "invalid pair '" + symbol + "'");
+                    return std::nullopt;
+                }
+                if (std::find(config.symbols.begin(), config.symbols.end(), symbol) == config.symbols.end()) {
+                    config.symbols.push_back(symbol);
+                }
+            }
+        } else if (key == "route") {
+            auto route = parseRoute(value);
+            std::string route_error = "unknown route kind (cross, direct, multi)";
+            if (!route.has_value() || !route->validate(&route_error)) {
+                fail(error, line_number, route_error);
+                return std::nullopt;
+            }
+            config.detector.routes.push_back(std::move(route.value()));
+            has_routes = true;
+        } else {
+            fail(error, line_number, "unknown key '" + key + "'");
+            return std::nullopt;
+        }
+    }
+
+    if (!has_routes) {
+        config.detector.routes = DetectorConfig::defaults().routes;
+    }
+
+    std::string detector_error;
+    if (!config.detector.validate(&detector_error)) {
+        fail(error, 0, detector_error);
+        return std::nullopt;
+    }
+    return config;
+}
+
+std::vector<std::string> EngineConfig::getSubscriptionSymbols() const {
+    std::vector<std::string> result = symbols;
+    for (const auto& pair : detector.allPairs()) {
+        if (std::find(result.begin(), result.end(), pair) == result.end()) {
+            result.push_back(pair);
+        }
+    }
+    return result;
+}
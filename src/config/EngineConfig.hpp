@@ -0,0 +1,32 @@
+#pragma once
+
+#include "../core/ArbitrageDetector.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+// Engine settings loaded from a text file; reloadable while the engine runs
+// One "key = value" per line, '#' starts a comment:
+//   threshold_percent = 0.10
+//   fee_percent = 0.075                  taker fee per trade
+//   symbols = ARB/USDT, SOL/USDT         extra pairs to stream
+//   route = cross ARB/BTC BTC/USDT       third leg (ARB/USDT) may be omitted
+//   route = direct ARB/FDUSD ARB/USDT
+//   route = multi ARB/EUR ARB/BTC BTC/USDT
+// A file without route lines keeps the built-in route table
+struct EngineConfig {
+    DetectorConfig detector;
+    std::vector<std::string> symbols;  // Streamed in addition to the route pairs
+
+    // Built-in routes and symbols, as used without a config file
+    static EngineConfig defaults();
+
+    // Returns nullopt (and a "line N: ..." message in error) if the file
+    // cannot be read, does not parse or describes an invalid route table
+    static std::optional<EngineConfig> loadFromFile(const std::string& path, std::string* error = nullptr);
+
+    static std::optional<EngineConfig> parse(const std::string& text, std::string* error = nullptr);
+
+    // Pairs to subscribe: symbols, then route pairs not listed there
+    std::vector<std::string> getSubscriptionSymbols() const;
+};
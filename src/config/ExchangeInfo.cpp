@@ -0,0 +1,309 @@
+#include "ExchangeInfo.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <string_view>
+
+namespace {
+    // Single-pass scanner over the exchangeInfo document
+    // Only the fields we need are materialized; everything else is skipped in place
+    class Scanner {
+    public:
+        explicit Scanner(std::string_view json) : json_(json), pos_(0) {}
+
+        bool atEnd() const { return pos_ >= json_.size(); }
+
+        void skipWhitespace() {
+            while (pos_ < json_.size() &&
+                   (json_[pos_] == ' ' || json_[pos_] == '\n' || json_[pos_] == '\r' || json_[pos_] == '\t')) {
+                ++pos_;
+            }
+        }
+
+        // Consume one expected character (after whitespace)
+        bool consume(char c) {
+            skipWhitespace();
+            if (pos_ < json_.size() && json_[pos_] == c) {
+                ++pos_;
+                return true;
+            }
+            return false;
+        }
+
+        bool peek(char c) {
+            skipWhitespace();
+            return pos_ < json_.size() && json_[pos_] == c;
+        }
+
+        // Read a string value; escapes are kept verbatim (exchangeInfo strings never need them)
+        std::optional<std::string_view> readString() {
+            if (!consume('"')) {
+                return std::nullopt;
+            }
+            size_t start = pos_;
+            while (pos_ < json_.size() && json_[pos_] != '"') {
+                pos_ += json_[pos_] == '\\' ? 2 : 1;
+            }
+            if (pos_ >= json_.size()) {
+                return std::nullopt;
+            }
+            return json_.substr(start, pos_++ - start);
+        }
+
+        // Skip any value: object, array, string, number or literal
+        bool skipValue() {
+            skipWhitespace();
+            if (pos_ >= json_.size()) {
+                return false;
+            }
+
+            char c = json_[pos_];
+            if (c == '"') {
+                return readString().has_value();
+            }
+
+            if (c == '{' || c == '[') {
+                // Depth scan; strings are stepped over so braces inside them are ignored
+                int depth = 0;
+                while (pos_ < json_.size()) {
+                    char d = json_[pos_];
+                    if (d == '"') {
+                        if (!readString()) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    ++pos_;
+                    if (d == '{' || d == '[') {
+                        ++depth;
+                    } else if (d == '}' || d == ']') {
+                        if (--depth == 0) {
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            }
+
+            // Number or literal
+            while (pos_ < json_.size() && json_[pos_] != ',' && json_[pos_] != '}' && json_[pos_] != ']') {
+                ++pos_;
+            }
+            return true;
+        }
+
+    private:
+        std::string_view json_;
+        size_t pos_;
+    };
+
+    double toDouble(std::string_view text) {
+        double value = 0.0;
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        return result.ec == std::errc() ? value : 0.0;
+    }
+
+    bool contains(const std::vector<std::string>& assets, const std::string& asset) {
+        return std::find(assets.begin(), assets.end(), asset) != assets.end();
+    }
+
+    bool accepted(const SymbolInfo& info, const UniverseFilter& filter) {
+        if (info.symbol.empty() || info.base.empty() || info.quote.empty()) {
+            return false;
+        }
+        if (filter.trading_only && info.status != "TRADING") {
+            return false;
+        }
+        if (contains(filter.exclude_assets, info.base) || contains(filter.exclude_assets, info.quote)) {
+            return false;
+        }
+        if (!filter.include_assets.empty() &&
+            !contains(filter.include_assets, info.base) && !contains(filter.include_assets, info.quote)) {
+            return false;
+        }
+        return true;
+    }
+
+    // Parse one element of "filters": we only care about tick and lot size
+    bool parseFilter(Scanner& scanner, SymbolInfo& info) {
+        if (!scanner.consume('{')) {
+            return false;
+        }
+
+        std::string_view type;
+        std::string_view tick_size;
+        std::string_view step_size;
+
+        while (!scanner.peek('}')) {
+            auto key = scanner.readString();
+            if (!key || !scanner.consume(':')) {
+                return false;
+            }
+
+            if (*key == "filterType" || *key == "tickSize" || *key == "stepSize") {
+                auto value = scanner.readString();
+                if (!value) {
+                    return false;
+                }
+                if (*key == "filterType") {
+                    type = *value;
+                } else if (*key == "tickSize") {
+                    tick_size = *value;
+                } else {
+                    step_size = *value;
+                }
+            } else if (!scanner.skipValue()) {
+                return false;
+            }
+
+            scanner.consume(',');
+        }
+        scanner.consume('}');
+
+        if (type == "PRICE_FILTER") {
+            info.tick_size = toDouble(tick_size);
+        } else if (type == "LOT_SIZE") {
+            info.step_size = toDouble(step_size);
+        }
+        return true;
+    }
+
+    bool parseSymbol(Scanner& scanner, SymbolInfo& info) {
+        if (!scanner.consume('{')) {
+            return false;
+        }
+
+        while (!scanner.peek('}')) {
+            auto key = scanner.readString();
+            if (!key || !scanner.consume(':')) {
+                return false;
+            }
+
+            std::string* target = nullptr;
+            if (*key == "symbol") {
+                target = &info.symbol;
+            } else if (*key == "status") {
+                target = &info.status;
+            } else if (*key == "baseAsset") {
+                target = &info.base;
+            } else if (*key == "quoteAsset") {
+                target = &info.quote;
+            }
+
+            if (target != nullptr) {
+                auto value = scanner.readString();
+                if (!value) {
+                    return false;
+                }
+                target->assign(value->data(), value->size());
+            } else if (*key == "filters" && scanner.consume('[')) {
+                while (!scanner.peek(']')) {
+                    if (!parseFilter(scanner, info)) {
+                        return false;
+                    }
+                    scanner.consume(',');
+                }
+                scanner.consume(']');
+            } else if (!scanner.skipValue()) {
+                return false;
+            }
+
+            scanner.consume(',');
+        }
+        scanner.consume('}');
+        return true;
+    }
+}
+
+std::optional<SymbolUniverse> SymbolUniverse::loadFromFile(const std::string& path, const UniverseFilter& filter) {
+    // Read the whole file in one go; exchangeInfo is a few MB at most
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return std::nullopt;
+    }
+
+    std::string json;
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (size > 0) {
+        json.resize(static_cast<size_t>(size));
+        json.resize(std::fread(json.data(), 1, json.size(), file));
+    }
+    std::fclose(file);
+
+    return parse(json, filter);
+}
+
+std::optional<SymbolUniverse> SymbolUniverse::parse(const std::string& json, const UniverseFilter& filter) {
+    Scanner scanner(json);
+
+    if (!scanner.consume('{')) {
+        return std::nullopt;
+    }
+
+    // Walk the top-level object until the "symbols" array
+    while (!scanner.peek('}')) {
+        auto key = scanner.readString();
+        if (!key || !scanner.consume(':')) {
+            return std::nullopt;
+        }
+
+        if (*key != "symbols") {
+            if (!scanner.skipValue()) {
+                return std::nullopt;
+            }
+            scanner.consume(',');
+            continue;
+        }
+
+        if (!scanner.consume('[')) {
+            return std::nullopt;
+        }
+
+        SymbolUniverse universe;
+        while (!scanner.peek(']')) {
+            SymbolInfo info;
+            if (!parseSymbol(scanner, info)) {
+                return std::nullopt;
+            }
+            if (accepted(info, filter)) {
+                universe.add(std::move(info));
+            }
+            scanner.consume(',');
+        }
+
+        return universe;
+    }
+
+    return std::nullopt; // No "symbols" array
+}
+
+const SymbolInfo* SymbolUniverse::findBySymbol(const std::string& symbol) const {
+    auto it = by_symbol_.find(symbol);
+    return it != by_symbol_.end() ? &symbols_[it->second] : nullptr;
+}
+
+const SymbolInfo* SymbolUniverse::findByPair(const std::string& pair) const {
+    auto it = by_pair_.find(pair);
+    return it != by_pair_.end() ? &symbols_[it->second] : nullptr;
+}
+
+std::vector<std::string> SymbolUniverse::getPairs() const {
+    std::vector<std::string> pairs;
+    pairs.reserve(symbols_.size());
+    for (const auto& info : symbols_) {
+        pairs.push_back(info.pair());
+    }
+    return pairs;
+}
+
+void SymbolUniverse::add(SymbolInfo info) {
+    if (by_symbol_.count(info.symbol) != 0) {
+        return; // Duplicate entry
+    }
+    size_t index = symbols_.size();
+    by_symbol_.emplace(info.symbol, index);
+    by_pair_.emplace(info.pair(), index);
+    symbols_.push_back(std::move(info));
+}
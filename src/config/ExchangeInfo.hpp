@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <unordered_map>
+
+// One spot trading pair from Binance exchangeInfo
+struct SymbolInfo {
+    std::string symbol;  // Exchange symbol, e.g. "ARBUSDT"
+    std::string base;    // e.g. "ARB"
+    std::string quote;   // e.g. "USDT"
+    std::string status;  // e.g. "TRADING", "BREAK"
+    double tick_size;    // PRICE_FILTER tickSize (0 if absent)
+    double step_size;    // LOT_SIZE stepSize (0 if absent)
+
+    SymbolInfo() : tick_size(0.0), step_size(0.0) {}
+
+    // Internal pair name: "ARB/USDT"
+    std::string pair() const { return base + "/" + quote; }
+};
+
+// Which pairs to keep when loading the universe
+struct UniverseFilter {
+    std::vector<std::string> include_assets;  // If non-empty, base or quote must be listed
+    std::vector<std::string> exclude_assets;  // Pairs touching any of these are dropped
+    bool trading_only;                        // Drop pairs whose status is not TRADING
+
+    UniverseFilter() : trading_only(true) {}
+};
+
+// Symbol universe loaded from a local exchangeInfo JSON file
+class SymbolUniverse {
+public:
+    // Load and filter exchangeInfo from disk
+    // Returns nullopt if the file cannot be read or has no "symbols" array
+    static std::optional<SymbolUniverse> loadFromFile(const std::string& path, const UniverseFilter& filter);
+
+    // Parse an exchangeInfo document already in memory
+    static std::optional<SymbolUniverse> parse(const std::string& json, const UniverseFilter& filter);
+
+    const std::vector<SymbolInfo>& getSymbols() const { return symbols_; }
+
+    // Lookup by exchange symbol ("ARBUSDT"); nullptr if unknown
+    const SymbolInfo* findBySymbol(const std::string& symbol) const;
+
+    // Lookup by pair name ("ARB/USDT"); nullptr if unknown
+    const SymbolInfo* findByPair(const std::string& pair) const;
+
+    // All pair names in load order
+    std::vector<std::string> getPairs() const;
+
+private:
+    std::vector<SymbolInfo> symbols_;
+    std::unordered_map<std::string, size_t> by_symbol_;
+    std::unordered_map<std::string, size_t> by_pair_;
+
+    void add(SymbolInfo info);
+};
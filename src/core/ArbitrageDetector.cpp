@@ -1,106 +1,532 @@
 #include "ArbitrageDetector.hpp"
 #include <limits>
+#include <cmath>
 #include <algorithm>
+#include <tuple>
+#include <utility>
+
+namespace {
+    // "ARB/BTC" -> ("ARB", "BTC"); false unless both sides are non-empty
+    bool splitPair(const std::string& pair, std::string& base, std::string& quote) {
+        size_t slash_pos = pair.find('/');
+        if (slash_pos == std::string::npos || slash_pos == 0 || slash_pos + 1 >= pair.length() ||
+            pair.find('/', slash_pos + 1) != std::string::npos) {
+            return false;
+        }
+        base = pair.substr(0, slash_pos);
+        quote = pair.substr(slash_pos + 1);
+        return true;
+    }
+    
+    bool fail(std::string* error, const std::string& message) {
+        if (error != nullptr) {
+            *error = message;
+        }
+        return false;
+    }
+    
+    size_t expectedPairCount(RouteKind kind) {
+        return kind == RouteKind::DirectComparison ? 2 : 3;
+    }
+}
+
+std::vector<std::string> RouteDefinition::allPairs() const {
+    std::vector<std::string> result = pairs;
+    if (kind == RouteKind::MultiLeg && pairs.size() == 3) {
+        // Starting capital in QUOTE is valued through QUOTE/USDT (final quote)
+        std::string start_base, start_quote, final_base, final_quote;
+        if (splitPair(pairs[0], start_base, start_quote) && splitPair(pairs[2], final_base, final_quote)) {
+            result.push_back(start_quote + "/" + final_quote);
+        }
+    }
+    return result;
+}
+
+bool RouteDefinition::validate(std::string* error) const {
+    if (pairs.size() != expectedPairCount(kind)) {
+        return fail(error, "expected " + std::to_string(expectedPairCount(kind)) + " pairs, got " +
+                    std::to_string(pairs.size()));
+    }
+    
+    std::array<std::string, 3> base;
+    std::array<std::string, 3> quote;
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        if (!splitPair(pairs[i], base[i], quote[i])) {
+            return fail(error, "invalid pair '" + pairs[i] + "'");
+        }
+    }
+    
+    switch (kind) {
+        case RouteKind::CrossPair:
+            // ARB/XXX, XXX/USDT, ARB/USDT
+            if (base[1] != quote[0] || base[2] != base[0] || quote[2] != quote[1]) {
+                return fail(error, "cross route must read A/X, X/Q, A/Q");
+            }
+            break;
+        case RouteKind::DirectComparison:
+            // ARB/STABLE, ARB/USDT
+            if (base[1] != base[0] || quote[1] == quote[0]) {
+                return fail(error, "direct route must read A/S, A/Q with S != Q");
+            }
+            break;
+        case RouteKind::MultiLeg:
+            // ARB/QUOTE, ARB/INTERMEDIATE, INTERMEDIATE/USDT
+            if (base[1] != base[0] || base[2] != quote[1] || quote[0] == quote[2]) {
+                return fail(error, "multi route must read A/Q0, A/I, I/Q with Q0 != Q");
+            }
+            break;
+    }
+    return true;
+}
+
+DetectorConfig DetectorConfig::defaults(double threshold_percent) {
+    DetectorConfig config;
+    config.threshold_percent = threshold_percent;
+    
+    // Cross-pair routes
+    config.routes.push_back({RouteKind::CrossPair, {"ARB/BTC", "BTC/USDT", "ARB/USDT"}});
+    config.routes.push_back({RouteKind::CrossPair, {"ARB/ETH", "ETH/USDT", "ARB/USDT"}});
+    config.routes.push_back({RouteKind::CrossPair, {"ARB/EUR", "EUR/USDT", "ARB/USDT"}});
+    config.routes.push_back({RouteKind::CrossPair, {"ARB/TRY", "TRY/USDT", "ARB/USDT"}});
+    
+    // Direct comparisons for stablecoins
+    config.routes.push_back({RouteKind::DirectComparison, {"ARB/FDUSD", "ARB/USDT"}});
+    config.routes.push_back({RouteKind::DirectComparison, {"ARB/USDC", "ARB/USDT"}});
+    config.routes.push_back({RouteKind::DirectComparison, {"ARB/TUSD", "ARB/USDT"}});
+    
+    // Multi-leg routes (3+ legs)
+    config.routes.push_back({RouteKind::MultiLeg, {"ARB/EUR", "ARB/BTC", "BTC/USDT"}});
+    config.routes.push_back({RouteKind::MultiLeg, {"ARB/EUR", "ARB/ETH", "ETH/USDT"}});
+    config.routes.push_back({RouteKind::MultiLeg, {"ARB/TRY", "ARB/BTC", "BTC/USDT"}});
+    config.routes.push_back({RouteKind::MultiLeg, {"ARB/TRY", "ARB/ETH", "ETH/USDT"}});
+    
+    return config;
+}
+
+bool DetectorConfig::validate(std::string* error) const {
+    if (!std::isfinite(threshold_percent) || threshold_percent <= -100.0) {
+        return fail(error, "threshold_percent out of range");
+    }
+    if (!std::isfinite(fee_percent) || fee_percent < 0.0 || fee_percent >= 100.0) {
+        return fail(error, "fee_percent must be in [0, 100)");
+    }
+    if (routes.empty()) {
+        return fail(error, "no routes");
+    }
+    for (size_t i = 0; i < routes.size(); ++i) {
+        std::string route_error;
+        if (!routes[i].validate(&route_error)) {
+            return fail(error, "route " + std::to_string(i + 1) + ": " + route_error);
+        }
+    }
+    return true;
+}
+
+std::vector<std::string> DetectorConfig::allPairs() const {
+    std::vector<std::string> result;
+    for (const auto& route : routes) {
+        for (const auto& pair : route.allPairs()) {
+            if (std::find(result.begin(), result.end(), pair) == result.end()) {
+                result.push_back(pair);
+            }
+        }
+    }
+    return result;
+}
 
 ArbitrageDetector::ArbitrageDetector(MarketState& market_state, double threshold_percent)
-    : market_state_(market_state),
-      threshold_percent_(threshold_percent),
-      check_count_(0) {}
+    : ArbitrageDetector(market_state, DetectorConfig::defaults(threshold_percent)) {}
 
-std::optional<ArbitrageOpportunity> ArbitrageDetector::checkOpportunities() const {
-    return checkAllRoutes();
+ArbitrageDetector::ArbitrageDetector(MarketState& market_state, const DetectorConfig& config)
+    : market_state_(market_state),
+      check_count_(0),
+      opportunity_count_(0),
+      table_(std::make_shared<const RouteTable>()),
+      config_version_(0),
+      trigger_index_({}, config.threshold_percent),
+      results_(std::make_shared<const DetectorResults>()),
+      results_sequence_(0) {
+    applyConfig(config);
 }
 
-std::optional<ArbitrageOpportunity> ArbitrageDetector::checkAllRoutes() const {
-    std::optional<ArbitrageOpportunity> best_opp;
-    double best_profit = -1.0;
+uint64_t ArbitrageDetector::applyConfig(const DetectorConfig& config) {
+    if (!config.validate()) {
+        return 0;
+    }
+    
+    // Everything that allocates or resolves symbols happens before the lock
+    auto table = buildRouteTable(config, config_version_ + 1);
+    TriggerIndex trigger_index(buildTriggerRoutes(*table), table->threshold_percent);
+    
+    // Seed the matrix and the trigger index with the current books so the first
+    // update after the swap is compared against real co-leg prices instead of "no data"
+    table->rates->sync();
+    for (uint32_t pair = 0; pair < table->pairs->size(); ++pair) {
+        auto quote = getValidQuote(*table->rates, table->rates->pairIndex((*table->pairs)[pair]));
+        if (quote.has_value()) {
+            trigger_index.update((*table->pairs)[pair], quote->bid_price, quote->ask_price);
+        }
+    }
     
-    // Check all cross-pair routes
-    // ARB/BTC -> BTC/USDT
-    auto opp_btc = checkRoute("ARB/BTC", "BTC/USDT");
-    if (opp_btc.has_value() && opp_btc.value().profit_percent > best_profit) {
-        best_opp = opp_btc;
-        best_profit = opp_btc.value().profit_percent;
+    // Only pointer swaps under the lock: a pair updated since the sync above is
+    // caught up by its next onBookUpdate or by the next publishResults() sync
+    {
+        std::lock_guard<std::mutex> lock(trigger_mutex_);
+        trigger_index_ = std::move(trigger_index);
+        std::atomic_store(&table_, table);
     }
     
-    // ARB/ETH -> ETH/USDT
-    auto opp_eth = checkRoute("ARB/ETH", "ETH/USDT");
-    if (opp_eth.has_value() && opp_eth.value().profit_percent > best_profit) {
-        best_opp = opp_eth;
-        best_profit = opp_eth.value().profit_percent;
+    config_version_ = table->version;
+    return config_version_;
+}
+
+uint64_t ArbitrageDetector::getConfigVersion() const {
+    return std::atomic_load(&table_)->version;
+}
+
+std::shared_ptr<const ImpliedRateMatrix> ArbitrageDetector::getRates() const {
+    auto table = std::atomic_load(&table_);
+    const ImpliedRateMatrix* rates = table->rates.get();
+    return std::shared_ptr<const ImpliedRateMatrix>(std::move(table), rates);
+}
+
+std::shared_ptr<const ArbitrageDetector::RouteTable> ArbitrageDetector::buildRouteTable(const DetectorConfig& config,
+                                                                                      uint64_t version) const {
+    auto table = std::make_shared<RouteTable>();
+    table->version = version;
+    table->threshold_percent = config.threshold_percent;
+    table->fee_percent = config.fee_percent;
+    table->pairs = std::make_shared<const std::vector<std::string>>(config.allPairs());
+    
+    // Rates are expressed in USDT and in every other final quote of a route
+    std::vector<std::string> quote_assets = {"USDT"};
+    for (const auto& definition : config.routes) {
+        std::string base, quote;
+        if (definition.kind != RouteKind::DirectComparison && splitPair(definition.pairs.back(), base, quote) &&
+            std::find(quote_assets.begin(), quote_assets.end(), quote) == quote_assets.end()) {
+            quote_assets.push_back(quote);
+        }
     }
     
-    // ARB/EUR -> EUR/USDT
-    auto opp_eur = checkRoute("ARB/EUR", "EUR/USDT");
-    if (opp_eur.has_value() && opp_eur.value().profit_percent > best_profit) {
-        best_opp = opp_eur;
-        best_profit = opp_eur.value().profit_percent;
+    std::vector<std::pair<std::string, const OrderBook*>> books;
+    books.reserve(table->pairs->size());
+    for (const auto& pair : *table->pairs) {
+        books.emplace_back(pair, &market_state_.get(pair));
+    }
+    table->rates = std::make_shared<ImpliedRateMatrix>(books, quote_assets);
+    const ImpliedRateMatrix& rates = *table->rates;
+    
+    double fee_per_trade = 1.0 - config.fee_percent / 100.0;
+    table->routes.reserve(config.routes.size());
+    for (const auto& definition : config.routes) {
+        auto pairs = definition.allPairs();
+        
+        Route route;
+        route.kind = definition.kind;
+        route.legs = {};
+        route.quotes.fill(ImpliedRateMatrix::NPOS);
+        for (size_t i = 0; i < definition.pairs.size(); ++i) {
+            route.legs[i] = market_state_.getSymbolId(definition.pairs[i]);
+        }
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            route.quotes[i] = rates.pairIndex(pairs[i]);
+        }
+        
+        std::array<std::string, 3> base;
+        std::array<std::string, 3> quote;
+        for (size_t i = 0; i < definition.pairs.size(); ++i) {
+            splitPair(definition.pairs[i], base[i], quote[i]);
+        }
+        route.implied_path = ImpliedRateMatrix::NPOS;
+        route.valuation_path = ImpliedRateMatrix::NPOS;
+        if (definition.kind == RouteKind::CrossPair) {
+            // ARB/XXX, XXX/USDT
+            route.implied_path = rates.pathIndex(base[0], quote[1], quote[0]);
+        } else if (definition.kind == RouteKind::MultiLeg) {
+            // ARB/INTERMEDIATE, INTERMEDIATE/USDT, and QUOTE/USDT on its own
+            route.implied_path = rates.pathIndex(base[1], quote[2], quote[1]);
+            route.valuation_path = rates.pathIndex(quote[0], quote[2]);
+        }
+        
+        // Direct comparisons trade twice, cross-pair and multi-leg routes three times
+        route.fee_factor = std::pow(fee_per_trade, definition.kind == RouteKind::DirectComparison ? 2 : 3);
+        table->routes.push_back(route);
     }
     
-    // ARB/TRY -> TRY/USDT
-    auto opp_try = checkRoute("ARB/TRY", "TRY/USDT");
-    if (opp_try.has_value() && opp_try.value().profit_percent > best_profit) {
-        best_opp = opp_try;
-        best_profit = opp_try.value().profit_percent;
+    return table;
+}
+
+std::optional<ArbitrageOpportunity> ArbitrageDetector::checkOpportunities() const {
+    std::shared_ptr<const RouteTable> table;
+    {
+        std::lock_guard<std::mutex> lock(trigger_mutex_);
+        table = table_;
+        table->rates->sync();
     }
+    return checkAllRoutes(*table);
+}
+
+void ArbitrageDetector::setOpportunityCallback(OpportunityCallback callback) {
+    on_opportunity_ = std::move(callback);
+}
+
+std::optional<ArbitrageOpportunity> ArbitrageDetector::onBookUpdate(const std::string& symbol, uint64_t receive_ns) {
+    return onBookUpdate(symbol, market_state_.get(symbol), receive_ns);
+}
+
+std::optional<ArbitrageOpportunity> ArbitrageDetector::onBookUpdate(const std::string& symbol, const OrderBook& book,
+                                                                    uint64_t receive_ns) {
+    auto snap = book.snapshot();
+    bool valid = isValidSnapshot(snap);
     
-    // Check direct comparisons for stablecoins
-    auto opp_fdusd = checkDirectComparison("ARB/FDUSD");
-    if (opp_fdusd.has_value() && opp_fdusd.value().profit_percent > best_profit) {
-        best_opp = opp_fdusd;
-        best_profit = opp_fdusd.value().profit_percent;
+    std::lock_guard<std::mutex> lock(trigger_mutex_);
+    check_count_.store(check_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    
+    // Recomputes only the implied rates that read this pair
+    uint32_t pair = table_->rates->pairIndex(symbol);
+    if (pair != ImpliedRateMatrix::NPOS) {
+        table_->rates->update(pair, snap);
     }
     
-    auto opp_usdc = checkDirectComparison("ARB/USDC");
-    if (opp_usdc.has_value() && opp_usdc.value().profit_percent > best_profit) {
-        best_opp = opp_usdc;
-        best_profit = opp_usdc.value().profit_percent;
+    bool crossed = valid
+        ? trigger_index_.update(symbol, snap.bid_price, snap.ask_price)
+        : trigger_index_.update(symbol, 0.0, 0.0);
+    
+    if (!crossed) {
+        return std::nullopt; // Common case: nothing moved across a trigger
     }
     
-    auto opp_tusd = checkDirectComparison("ARB/TUSD");
-    if (opp_tusd.has_value() && opp_tusd.value().profit_percent > best_profit) {
-        best_opp = opp_tusd;
-        best_profit = opp_tusd.value().profit_percent;
+    // Only the routes whose trigger this update crossed; table_ is only replaced
+    // under this lock, so a plain read is enough here
+    std::optional<ArbitrageOpportunity> opp;
+    for (size_t route_id : trigger_index_.crossedRoutes()) {
+        auto route_opp = checkRoute(*table_, static_cast<uint32_t>(route_id));
+        if (route_opp.has_value() && (!opp.has_value() || route_opp->profit_percent > opp->profit_percent)) {
+            opp = route_opp;
+        }
+    }
+    if (opp.has_value()) {
+        opportunity_count_.store(opportunity_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    if (opp.has_value() && (!pending_best_.has_value() || opp->profit_percent > pending_best_->profit_percent)) {
+        pending_best_ = opp;
+    }
+    if (opp.has_value() && on_opportunity_) {
+        on_opportunity_(opp.value(), receive_ns);
     }
+    return opp;
+}
+
+void ArbitrageDetector::publishResults() {
+    std::shared_ptr<const RouteTable> table;
+    {
+        std::lock_guard<std::mutex> lock(trigger_mutex_);
+        table = table_;
+        table->rates->sync();
+    }
+    
+    auto results = std::make_shared<DetectorResults>();
+    results->config_version = table->version;
+    results->threshold_percent = table->threshold_percent;
+    results->fee_percent = table->fee_percent;
+    results->pairs = table->pairs;
+    results->sequence = ++results_sequence_;
+    
+    // Same selection as checkAllRoutes, from the statuses just computed
+    double best_profit = -1.0;
+    results->routes.reserve(table->routes.size());
+    for (uint32_t route_id = 0; route_id < table->routes.size(); ++route_id) {
+        results->routes.push_back(evaluateRouteStatus(*table, route_id));
+        const auto& status = results->routes.back();
+        if (status.has_opportunity && status.opportunity.profit_percent > best_profit) {
+            best_profit = status.opportunity.profit_percent;
+            results->best = status.opportunity;
+        }
+    }
+    
+    results->implied_rates = table->rates->summarize();
     
-    // Check multi-leg routes (3+ legs)
-    // ARB/EUR -> ARB/BTC -> BTC/USDT
-    auto opp_eur_btc = checkMultiLegRoute("ARB/EUR", "ARB/BTC", "BTC/USDT");
-    if (opp_eur_btc.has_value() && opp_eur_btc.value().profit_percent > best_profit) {
-        best_opp = opp_eur_btc;
-        best_profit = opp_eur_btc.value().profit_percent;
+    {
+        std::lock_guard<std::mutex> lock(trigger_mutex_);
+        if (pending_best_.has_value() &&
+            (!results->best.has_value() || pending_best_->profit_percent > results->best->profit_percent)) {
+            results->best = pending_best_;
+            results->best_from_event_path = true;
+        }
+        pending_best_.reset();
+        results->check_count = check_count_.load(std::memory_order_relaxed);
     }
     
-    // ARB/EUR -> ARB/ETH -> ETH/USDT
-    auto opp_eur_eth = checkMultiLegRoute("ARB/EUR", "ARB/ETH", "ETH/USDT");
-    if (opp_eur_eth.has_value() && opp_eur_eth.value().profit_percent > best_profit) {
-        best_opp = opp_eur_eth;
-        best_profit = opp_eur_eth.value().profit_percent;
+    std::atomic_store(&results_, std::shared_ptr<const DetectorResults>(std::move(results)));
+}
+
+std::shared_ptr<const DetectorResults> ArbitrageDetector::getResults() const {
+    return std::atomic_load(&results_);
+}
+
+DetectorResults::RouteStatus ArbitrageDetector::evaluateRouteStatus(const RouteTable& table, uint32_t route_id) const {
+    const Route& route = table.routes[route_id];
+    
+    DetectorResults::RouteStatus status;
+    status.kind = route.kind;
+    status.legs = route.legs;
+    
+    const ImpliedRateMatrix& rates = *table.rates;
+    PairQuote quotes[4];
+    status.has_data = true;
+    for (size_t i = 0; i < route.quotes.size() && route.quotes[i] != ImpliedRateMatrix::NPOS; ++i) {
+        quotes[i] = rates.quote(route.quotes[i]);
+        status.has_data = status.has_data && quotes[i].has_data;
+    }
+    
+    if (!status.has_data) {
+        return status;
+    }
+    
+    auto route_opp = checkRoute(table, route_id);
+    if (route_opp.has_value() && route_opp.value().valid) {
+        status.has_opportunity = true;
+        status.profit_percent = route_opp.value().profit_percent;
+        status.opportunity = route_opp.value();
+        return status;
+    }
+    
+    // Calculate current profit even if below threshold
+    switch (route.kind) {
+        case RouteKind::CrossPair: {
+            const auto& usdt_snap = quotes[2];
+            ImpliedRate implied = rates.rate(route.implied_path);
+            
+            // Direction 1: Buy implied, sell direct
+            double cost1 = implied.ask;
+            double final1 = usdt_snap.bid_price;
+            double profit1 = cost1 > 0 ? (final1 * route.fee_factor / cost1 - 1.0) * 100.0 : 0.0;
+            
+            // Direction 2: Buy direct, sell implied
+            double cost2 = usdt_snap.ask_price;
+            double final2 = implied.bid;
+            double profit2 = cost2 > 0 ? (final2 * route.fee_factor / cost2 - 1.0) * 100.0 : 0.0;
+            
+            status.profit_percent = std::max(profit1, profit2);
+            break;
+        }
+        case RouteKind::DirectComparison: {
+            const auto& stable_snap = quotes[0];
+            const auto& usdt_snap = quotes[1];
+            
+            double cost1 = stable_snap.ask_price;
+            double final1 = usdt_snap.bid_price;
+            double profit1 = cost1 > 0 ? (final1 * route.fee_factor / cost1 - 1.0) * 100.0 : 0.0;
+            
+            double cost2 = usdt_snap.ask_price;
+            double final2 = stable_snap.bid_price;
+            double profit2 = cost2 > 0 ? (final2 * route.fee_factor / cost2 - 1.0) * 100.0 : 0.0;
+            
+            status.profit_percent = std::max(profit1, profit2);
+            break;
+        }
+        case RouteKind::MultiLeg: {
+            const auto& start_snap = quotes[0];
+            
+            double cost_quote = start_snap.ask_price;
+            if (cost_quote > 0.0) {
+                double final_usdt = rates.rate(route.implied_path).bid / cost_quote;
+                double initial_usdt = rates.rate(route.valuation_path).ask;
+                
+                if (initial_usdt > 0.0) {
+                    status.profit_percent = (final_usdt * route.fee_factor / initial_usdt - 1.0) * 100.0;
+                }
+            }
+            break;
+        }
     }
     
-    // ARB/TRY -> ARB/BTC -> BTC/USDT
-    auto opp_try_btc = checkMultiLegRoute("ARB/TRY", "ARB/BTC", "BTC/USDT");
-    if (opp_try_btc.has_value() && opp_try_btc.value().profit_percent > best_profit) {
-        best_opp = opp_try_btc;
-        best_profit = opp_try_btc.value().profit_percent;
+    return status;
+}
+
+std::vector<TriggerRoute> ArbitrageDetector::buildTriggerRoutes(const RouteTable& table) const {
+    std::vector<TriggerRoute> routes;
+    
+    for (uint32_t route_id = 0; route_id < table.routes.size(); ++route_id) {
+        const Route& route = table.routes[route_id];
+        const std::string& leg0 = market_state_.getSymbolName(route.legs[0]);
+        const std::string& leg1 = market_state_.getSymbolName(route.legs[1]);
+        
+        switch (route.kind) {
+            case RouteKind::CrossPair: {
+                const std::string& arb_usdt = market_state_.getSymbolName(route.legs[2]);
+                // Direction 1: bid(ARB/USDT) / (ask(ARB/XXX) * ask(XXX/USDT))
+                routes.push_back({{
+                    {arb_usdt, QuoteSide::Bid, true},
+                    {leg0, QuoteSide::Ask, false},
+                    {leg1, QuoteSide::Ask, false}
+                }, route.fee_factor, route_id});
+                // Direction 2: bid(ARB/XXX) * bid(XXX/USDT) / ask(ARB/USDT)
+                routes.push_back({{
+                    {leg0, QuoteSide::Bid, true},
+                    {leg1, QuoteSide::Bid, true},
+                    {arb_usdt, QuoteSide::Ask, false}
+                }, route.fee_factor, route_id});
+                break;
+            }
+            case RouteKind::DirectComparison:
+                // bid(ARB/USDT) / ask(ARB/STABLE) and bid(ARB/STABLE) / ask(ARB/USDT)
+                routes.push_back({{
+                    {leg1, QuoteSide::Bid, true},
+                    {leg0, QuoteSide::Ask, false}
+                }, route.fee_factor, route_id});
+                routes.push_back({{
+                    {leg0, QuoteSide::Bid, true},
+                    {leg1, QuoteSide::Ask, false}
+                }, route.fee_factor, route_id});
+                break;
+            case RouteKind::MultiLeg: {
+                // bid(ARB/INTERMEDIATE) * bid(INTERMEDIATE/USDT) / (ask(ARB/QUOTE) * ask(QUOTE/USDT))
+                const std::string& final_pair = market_state_.getSymbolName(route.legs[2]);
+                std::string final_quote = final_pair.substr(final_pair.find('/') + 1);
+                std::string quote_usdt = leg0.substr(leg0.find('/') + 1) + "/" + final_quote;
+                routes.push_back({{
+                    {leg1, QuoteSide::Bid, true},
+                    {final_pair, QuoteSide::Bid, true},
+                    {leg0, QuoteSide::Ask, false},
+                    {quote_usdt, QuoteSide::Ask, false}
+                }, route.fee_factor, route_id});
+                break;
+            }
+        }
     }
     
-    // ARB/TRY -> ARB/ETH -> ETH/USDT
-    auto opp_try_eth = checkMultiLegRoute("ARB/TRY", "ARB/ETH", "ETH/USDT");
-    if (opp_try_eth.has_value() && opp_try_eth.value().profit_percent > best_profit) {
-        best_opp = opp_try_eth;
-        best_profit = opp_try_eth.value().profit_percent;
+    return routes;
+}
+
+std::optional<ArbitrageOpportunity> ArbitrageDetector::checkAllRoutes(const RouteTable& table) const {
+    std::optional<ArbitrageOpportunity> best_opp;
+    double best_profit = -1.0;
+    
+    // Route table order
+    for (uint32_t route_id = 0; route_id < table.routes.size(); ++route_id) {
+        auto opp = checkRoute(table, route_id);
+        if (opp.has_value() && opp->profit_percent > best_profit) {
+            best_profit = opp->profit_percent;
+            best_opp = opp;
+        }
     }
     
     return best_opp;
 }
 
-std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRoute(
-    const std::string& arb_pair,
-    const std::string& cross_pair
-) const {
-    auto opp1 = checkRouteDirection1(arb_pair, cross_pair);
-    auto opp2 = checkRouteDirection2(arb_pair, cross_pair);
+std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRoute(const RouteTable& table, uint32_t route_id) const {
+    switch (table.routes[route_id].kind) {
+        case RouteKind::DirectComparison:
+            return checkDirectComparison(table, route_id);
+        case RouteKind::MultiLeg:
+            return checkMultiLegRoute(table, route_id);
+        case RouteKind::CrossPair:
+            break;
+    }
+    
+    auto opp1 = checkRouteDirection1(table, route_id);
+    auto opp2 = checkRouteDirection2(table, route_id);
     
     // Return the opportunity with higher profit if both are valid
     if (opp1.has_value() && opp2.has_value()) {
@@ -122,20 +548,19 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRoute(
     return std::nullopt;
 }
 
-std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection1(
-    const std::string& arb_pair,
-    const std::string& cross_pair
-) const {
+std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection1(const RouteTable& table, uint32_t route_id) const {
     // Direction 1: Buy implied, sell direct
     // cost_usdt  = ask(ARB/XXX) * ask(XXX/USDT)
     // final_usdt = bid(ARB/USDT)
-    // profit%    = (final_usdt / cost_usdt - 1) * 100
+    // profit%    = (final_usdt * fee_factor / cost_usdt - 1) * 100
     
-    auto arb_other_snap = getValidSnapshot(arb_pair);
-    auto other_usdt_snap = getValidSnapshot(cross_pair);
-    auto arb_usdt_snap = getValidSnapshot("ARB/USDT");
+    const Route& route = table.routes[route_id];
+    auto arb_other_snap = getValidQuote(*table.rates, route.quotes[0]);
+    auto other_usdt_snap = getValidQuote(*table.rates, route.quotes[1]);
+    auto arb_usdt_snap = getValidQuote(*table.rates, route.quotes[2]);
+    ImpliedRate implied = table.rates->rate(route.implied_path);
     
-    if (!arb_other_snap.has_value() || !other_usdt_snap.has_value() || !arb_usdt_snap.has_value()) {
+    if (!arb_other_snap.has_value() || !other_usdt_snap.has_value() || !arb_usdt_snap.has_value() || !implied.valid) {
         return std::nullopt;
     }
     
@@ -143,8 +568,8 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection1(
     const auto& other_usdt = other_usdt_snap.value();
     const auto& arb_usdt = arb_usdt_snap.value();
     
-    // Calculate cost and final
-    double cost_usdt = arb_other.ask_price * other_usdt.ask_price;
+    // Calculate cost and final; the implied ask is shared with every route through ARB/XXX
+    double cost_usdt = implied.ask;
     double final_usdt = arb_usdt.bid_price;
     
     // Validate calculations
@@ -153,10 +578,10 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection1(
     }
     
     // Calculate profit percentage
-    double profit_percent = (final_usdt / cost_usdt - 1.0) * 100.0;
+    double profit_percent = (final_usdt * route.fee_factor / cost_usdt - 1.0) * 100.0;
     
     // Check threshold
-    if (profit_percent < threshold_percent_) {
+    if (profit_percent < table.threshold_percent) {
         return std::nullopt;
     }
     
@@ -189,9 +614,10 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection1(
     
     // Create opportunity
     ArbitrageOpportunity opp;
+    opp.route_id = route_id;
+    opp.kind = route.kind;
     opp.direction = 1;
-    opp.route_name = arb_pair + " -> " + cross_pair;
-    opp.trade_sequence = "Buy " + arb_pair + " -> Buy " + cross_pair + " -> Sell ARB/USDT";
+    opp.legs = route.legs;
     opp.profit_percent = profit_percent;
     opp.arb_usdt_bid = arb_usdt.bid_price;
     opp.arb_usdt_ask = arb_usdt.ask_price;
@@ -200,26 +626,24 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection1(
     opp.other_usdt_bid = other_usdt.bid_price;
     opp.other_usdt_ask = other_usdt.ask_price;
     opp.max_tradable_amount = max_tradable_arb;
-    opp.max_tradable_currency = "ARB";
     opp.valid = true;
     
     return opp;
 }
 
-std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection2(
-    const std::string& arb_pair,
-    const std::string& cross_pair
-) const {
+std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection2(const RouteTable& table, uint32_t route_id) const {
     // Direction 2: Buy direct, sell implied
     // cost_usdt  = ask(ARB/USDT)
     // final_usdt = bid(ARB/XXX) * bid(XXX/USDT)
-    // profit%    = (final_usdt / cost_usdt - 1) * 100
+    // profit%    = (final_usdt * fee_factor / cost_usdt - 1) * 100
     
-    auto arb_usdt_snap = getValidSnapshot("ARB/USDT");
-    auto arb_other_snap = getValidSnapshot(arb_pair);
-    auto other_usdt_snap = getValidSnapshot(cross_pair);
+    const Route& route = table.routes[route_id];
+    auto arb_usdt_snap = getValidQuote(*table.rates, route.quotes[2]);
+    auto arb_other_snap = getValidQuote(*table.rates, route.quotes[0]);
+    auto other_usdt_snap = getValidQuote(*table.rates, route.quotes[1]);
+    ImpliedRate implied = table.rates->rate(route.implied_path);
     
-    if (!arb_usdt_snap.has_value() || !arb_other_snap.has_value() || !other_usdt_snap.has_value()) {
+    if (!arb_usdt_snap.has_value() || !arb_other_snap.has_value() || !other_usdt_snap.has_value() || !implied.valid) {
         return std::nullopt;
     }
     
@@ -227,9 +651,9 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection2(
     const auto& arb_other = arb_other_snap.value();
     const auto& other_usdt = other_usdt_snap.value();
     
-    // Calculate cost and final
+    // Calculate cost and final; the implied bid is shared with every route through ARB/XXX
     double cost_usdt = arb_usdt.ask_price;
-    double final_usdt = arb_other.bid_price * other_usdt.bid_price;
+    double final_usdt = implied.bid;
     
     // Validate calculations
     if (!isValidPrice(cost_usdt) || !isValidPrice(final_usdt) || cost_usdt <= 0.0) {
@@ -237,10 +661,10 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection2(
     }
     
     // Calculate profit percentage
-    double profit_percent = (final_usdt / cost_usdt - 1.0) * 100.0;
+    double profit_percent = (final_usdt * route.fee_factor / cost_usdt - 1.0) * 100.0;
     
     // Check threshold
-    if (profit_percent < threshold_percent_) {
+    if (profit_percent < table.threshold_percent) {
         return std::nullopt;
     }
     
@@ -269,9 +693,10 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection2(
     
     // Create opportunity
     ArbitrageOpportunity opp;
+    opp.route_id = route_id;
+    opp.kind = route.kind;
     opp.direction = 2;
-    opp.route_name = arb_pair + " -> " + cross_pair;
-    opp.trade_sequence = "Buy ARB/USDT -> Sell " + arb_pair + " -> Sell " + cross_pair;
+    opp.legs = route.legs;
     opp.profit_percent = profit_percent;
     opp.arb_usdt_bid = arb_usdt.bid_price;
     opp.arb_usdt_ask = arb_usdt.ask_price;
@@ -280,21 +705,19 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRouteDirection2(
     opp.other_usdt_bid = other_usdt.bid_price;
     opp.other_usdt_ask = other_usdt.ask_price;
     opp.max_tradable_amount = max_tradable_arb;
-    opp.max_tradable_currency = "ARB";
     opp.valid = true;
     
     return opp;
 }
 
-std::optional<ArbitrageOpportunity> ArbitrageDetector::checkDirectComparison(
-    const std::string& arb_stable_pair
-) const {
+std::optional<ArbitrageOpportunity> ArbitrageDetector::checkDirectComparison(const RouteTable& table, uint32_t route_id) const {
     // Direct comparison: ARB/STABLE vs ARB/USDT
     // Direction 1: Buy ARB/STABLE, sell ARB/USDT
     // Direction 2: Buy ARB/USDT, sell ARB/STABLE
     
-    auto arb_stable_snap = getValidSnapshot(arb_stable_pair);
-    auto arb_usdt_snap = getValidSnapshot("ARB/USDT");
+    const Route& route = table.routes[route_id];
+    auto arb_stable_snap = getValidQuote(*table.rates, route.quotes[0]);
+    auto arb_usdt_snap = getValidQuote(*table.rates, route.quotes[1]);
     
     if (!arb_stable_snap.has_value() || !arb_usdt_snap.has_value()) {
         return std::nullopt;
@@ -306,18 +729,18 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkDirectComparison(
     // Direction 1: Buy ARB/STABLE, sell ARB/USDT
     double cost1 = arb_stable.ask_price;
     double final1 = arb_usdt.bid_price;
-    double profit1 = (final1 / cost1 - 1.0) * 100.0;
+    double profit1 = (final1 * route.fee_factor / cost1 - 1.0) * 100.0;
     
     // Direction 2: Buy ARB/USDT, sell ARB/STABLE
     double cost2 = arb_usdt.ask_price;
     double final2 = arb_stable.bid_price;
-    double profit2 = (final2 / cost2 - 1.0) * 100.0;
+    double profit2 = (final2 * route.fee_factor / cost2 - 1.0) * 100.0;
     
     // Choose best direction
     bool use_direction1 = profit1 >= profit2;
     double best_profit = use_direction1 ? profit1 : profit2;
     
-    if (best_profit < threshold_percent_) {
+    if (best_profit < table.threshold_percent) {
         return std::nullopt;
     }
     
@@ -337,11 +760,10 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkDirectComparison(
     }
     
     ArbitrageOpportunity opp;
+    opp.route_id = route_id;
+    opp.kind = route.kind;
     opp.direction = use_direction1 ? 1 : 2;
-    opp.route_name = arb_stable_pair + " vs ARB/USDT";
-    opp.trade_sequence = use_direction1 
-        ? "Buy " + arb_stable_pair + " -> Sell ARB/USDT"
-        : "Buy ARB/USDT -> Sell " + arb_stable_pair;
+    opp.legs = route.legs;
     opp.profit_percent = best_profit;
     opp.arb_usdt_bid = arb_usdt.bid_price;
     opp.arb_usdt_ask = arb_usdt.ask_price;
@@ -350,7 +772,6 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkDirectComparison(
     opp.other_usdt_bid = 0.0;  // Not applicable for direct comparison
     opp.other_usdt_ask = 0.0;  // Not applicable for direct comparison
     opp.max_tradable_amount = max_tradable_arb;
-    opp.max_tradable_currency = "ARB";
     opp.valid = true;
     
     return opp;
@@ -381,90 +802,64 @@ bool ArbitrageDetector::isValidPrice(double price) const {
     return true;
 }
 
-std::optional<OrderBook::Snapshot> ArbitrageDetector::getValidSnapshot(const std::string& symbol) const {
-    auto snap = market_state_.get(symbol).snapshot();
-    
+bool ArbitrageDetector::isValidSnapshot(const OrderBook::Snapshot& snap) const {
     if (!snap.has_data) {
-        return std::nullopt;
+        return false;
     }
     
     // Validate bid and ask prices
     if (!isValidPrice(snap.bid_price) || !isValidPrice(snap.ask_price)) {
-        return std::nullopt;
+        return false;
     }
     
     // Ensure bid <= ask (market sanity check)
-    if (snap.bid_price > snap.ask_price) {
-        return std::nullopt;
-    }
-    
-    return snap;
-}
-
-std::optional<ArbitrageOpportunity> ArbitrageDetector::checkRoutePublic(
-    const std::string& arb_pair,
-    const std::string& cross_pair
-) const {
-    return checkRoute(arb_pair, cross_pair);
+    return snap.bid_price <= snap.ask_price;
 }
 
-std::optional<ArbitrageOpportunity> ArbitrageDetector::checkDirectComparisonPublic(
-    const std::string& arb_stable_pair
-) const {
-    return checkDirectComparison(arb_stable_pair);
+std::optional<PairQuote> ArbitrageDetector::getValidQuote(const ImpliedRateMatrix& rates, uint32_t pair) const {
+    // The matrix applies the same checks as isValidSnapshot when a pair is fed
+    PairQuote quote = rates.quote(pair);
+    if (!quote.valid) {
+        return std::nullopt;
+    }
+    return quote;
 }
 
-std::optional<ArbitrageOpportunity> ArbitrageDetector::checkMultiLegRoute(
-    const std::string& start_pair,
-    const std::string& intermediate_pair,
-    const std::string& final_pair
-) const {
+std::optional<ArbitrageOpportunity> ArbitrageDetector::checkMultiLegRoute(const RouteTable& table, uint32_t route_id) const {
     // Multi-leg route: Start -> Intermediate -> Final
     // Example: ARB/EUR -> ARB/BTC -> BTC/USDT
     // Trade sequence: Buy ARB with EUR -> Sell ARB for BTC -> Sell BTC for USDT
     // Compare final USDT with initial EUR value (via EUR/USDT)
     
-    auto start_snap = getValidSnapshot(start_pair);        // ARB/EUR
-    auto intermediate_snap = getValidSnapshot(intermediate_pair); // ARB/BTC
-    auto final_snap = getValidSnapshot(final_pair);        // BTC/USDT
-    
-    // Determine quote currency from start_pair (e.g., "ARB/EUR" -> "EUR")
-    std::string quote_currency;
-    size_t slash_pos = start_pair.find('/');
-    if (slash_pos != std::string::npos && slash_pos + 1 < start_pair.length()) {
-        quote_currency = start_pair.substr(slash_pos + 1); // "EUR"
-    } else {
-        return std::nullopt;
-    }
-    
-    // Get quote/USDT pair for comparison
-    std::string quote_usdt_pair = quote_currency + "/USDT";
-    auto quote_usdt_snap = getValidSnapshot(quote_usdt_pair); // EUR/USDT
+    const Route& route = table.routes[route_id];
+    const ImpliedRateMatrix& rates = *table.rates;
+    auto start_snap = getValidQuote(rates, route.quotes[0]);        // ARB/EUR
+    auto intermediate_snap = getValidQuote(rates, route.quotes[1]); // ARB/BTC
+    auto final_snap = getValidQuote(rates, route.quotes[2]);        // BTC/USDT
+    ImpliedRate implied = rates.rate(route.implied_path);           // ARB via BTC into USDT
+    ImpliedRate quote_usdt = rates.rate(route.valuation_path);      // EUR/USDT, shared by every EUR route
     
-    if (!start_snap.has_value() || !intermediate_snap.has_value() || 
-        !final_snap.has_value() || !quote_usdt_snap.has_value()) {
+    if (!start_snap.has_value() || !intermediate_snap.has_value() || !final_snap.has_value() ||
+        !implied.valid || !quote_usdt.valid) {
         return std::nullopt;
     }
     
     const auto& start = start_snap.value();
     const auto& intermediate = intermediate_snap.value();
     const auto& final = final_snap.value();
-    const auto& quote_usdt = quote_usdt_snap.value();
     
     // Calculate: Start with 1 unit of quote currency (e.g., 1 EUR)
     // Step 1: Buy ARB with quote currency
     //   cost_quote = ask(ARB/QUOTE)  (QUOTE per ARB)
     //   arb_amount = 1.0 / cost_quote  (ARB amount for 1 QUOTE)
     
-    // Step 2: Sell ARB for intermediate currency (e.g., BTC)
-    //   intermediate_amount = arb_amount * bid(ARB/INTERMEDIATE)  (INTERMEDIATE amount)
-    
-    // Step 3: Sell intermediate for USDT
-    //   final_usdt = intermediate_amount * bid(INTERMEDIATE/USDT)  (USDT amount)
+    // Steps 2 and 3: Sell ARB for intermediate currency (e.g., BTC), then intermediate for USDT
+    //   final_usdt = arb_amount * bid(ARB/INTERMEDIATE) * bid(INTERMEDIATE/USDT)
+    //   The product is the matrix's implied bid of ARB via INTERMEDIATE
     
     // Compare: final_usdt vs 1 QUOTE in USDT
     //   initial_usdt = 1.0 * ask(QUOTE/USDT)  (1 QUOTE in USDT)
-    //   profit% = (final_usdt / initial_usdt - 1) * 100
+    //   profit% = (final_usdt * fee_factor / initial_usdt - 1) * 100
     
     double cost_quote = start.ask_price; // QUOTE per ARB
     if (cost_quote <= 0.0) {
@@ -472,10 +867,9 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkMultiLegRoute(
     }
     
     double arb_amount = 1.0 / cost_quote; // ARB amount for 1 QUOTE
-    double intermediate_amount = arb_amount * intermediate.bid_price; // INTERMEDIATE amount
-    double final_usdt = intermediate_amount * final.bid_price; // Final USDT
+    double final_usdt = arb_amount * implied.bid; // Final USDT
     
-    double initial_usdt = 1.0 * quote_usdt.ask_price; // 1 QUOTE in USDT
+    double initial_usdt = 1.0 * quote_usdt.ask; // 1 QUOTE in USDT
     
     // Validate calculations
     if (!isValidPrice(final_usdt) || !isValidPrice(initial_usdt) || initial_usdt <= 0.0) {
@@ -483,10 +877,10 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkMultiLegRoute(
     }
     
     // Calculate profit percentage
-    double profit_percent = (final_usdt / initial_usdt - 1.0) * 100.0;
+    double profit_percent = (final_usdt * route.fee_factor / initial_usdt - 1.0) * 100.0;
     
     // Check threshold
-    if (profit_percent < threshold_percent_) {
+    if (profit_percent < table.threshold_percent) {
         return std::nullopt;
     }
     
@@ -515,9 +909,10 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkMultiLegRoute(
     
     // Create opportunity
     ArbitrageOpportunity opp;
+    opp.route_id = route_id;
+    opp.kind = route.kind;
     opp.direction = 1; // Multi-leg is always one direction
-    opp.route_name = start_pair + " -> " + intermediate_pair + " -> " + final_pair;
-    opp.trade_sequence = "Buy " + start_pair + " -> Sell " + intermediate_pair + " -> Sell " + final_pair;
+    opp.legs = route.legs;
     opp.profit_percent = profit_percent;
     
     // Store prices for display
@@ -528,16 +923,7 @@ std::optional<ArbitrageOpportunity> ArbitrageDetector::checkMultiLegRoute(
     opp.other_usdt_bid = final.bid_price;
     opp.other_usdt_ask = final.ask_price;
     opp.max_tradable_amount = max_tradable_arb;
-    opp.max_tradable_currency = "ARB";
     opp.valid = true;
     
     return opp;
 }
-
-std::optional<ArbitrageOpportunity> ArbitrageDetector::checkMultiLegRoutePublic(
-    const std::string& start_pair,
-    const std::string& intermediate_pair,
-    const std::string& final_pair
-) const {
-    return checkMultiLegRoute(start_pair, intermediate_pair, final_pair);
-}
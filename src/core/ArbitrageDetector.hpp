@@ -1,14 +1,41 @@
 #pragma once
 
+#include "ImpliedRateMatrix.hpp"
 #include "MarketState.hpp"
+#include "TriggerIndex.hpp"
+#include <array>
+#include <atomic>
 #include <string>
 #include <optional>
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <type_traits>
 
+// Kind of route an opportunity came from; decides how its legs are read
+enum class RouteKind : uint8_t {
+    CrossPair,         // legs: ARB/XXX, XXX/USDT, ARB/USDT
+    DirectComparison,  // legs: ARB/STABLE, ARB/USDT
+    MultiLeg           // legs: ARB/QUOTE, ARB/INTERMEDIATE, INTERMEDIATE/USDT
+};
+
+// Component an opportunity came from; route_id is only unique within one source
+enum class OpportunitySource : uint8_t {
+    Detector,      // ArbitrageDetector route table
+    UniverseScan   // UniverseScanner triangle table
+};
+
+// Plain data, trivially copyable: nothing on the detection path allocates
+// Route names and trade sequences are formatted on demand by OpportunityFormatter
 struct ArbitrageOpportunity {
+    uint32_t route_id;  // Index into the producer's route table
+    OpportunitySource source;
+    RouteKind kind;
     int direction;  // 1 or 2
-    std::string trade_sequence;
-    std::string route_name;  // e.g., "ARB/BTC -> BTC/USDT"
+    std::array<SymbolId, 3> legs;  // MarketState symbol ids, see RouteKind
     double profit_percent;
     
     // Prices for output (generalized - can be used for any route)
@@ -20,97 +47,218 @@ struct ArbitrageOpportunity {
     double other_usdt_ask; // XXX/USDT ask
     
     // Order book depth analysis (bonus)
-    double max_tradable_amount;  // Maximum amount that can be traded
-    std::string max_tradable_currency;  // Currency of max_tradable_amount (e.g., "ARB", "BTC", "USDT")
+    double max_tradable_amount;  // Maximum amount that can be traded, in the base asset of legs[0]
     
     bool valid;
     
     ArbitrageOpportunity()
-        : direction(0), profit_percent(0.0),
+        : route_id(0), source(OpportunitySource::Detector), kind(RouteKind::CrossPair), direction(0), legs{}, profit_percent(0.0),
           arb_usdt_bid(0.0), arb_usdt_ask(0.0),
           arb_other_bid(0.0), arb_other_ask(0.0),
           other_usdt_bid(0.0), other_usdt_ask(0.0),
-          max_tradable_amount(0.0), max_tradable_currency(""),
+          max_tradable_amount(0.0),
           valid(false) {}
 };
 
+static_assert(std::is_trivially_copyable<ArbitrageOpportunity>::value,
+              "ArbitrageOpportunity must stay trivially copyable");
+
+// Immutable detector output, published by pointer swap for the UI and logger
+struct DetectorResults {
+    // Current state of one route table entry
+    struct RouteStatus {
+        RouteKind kind;
+        std::array<SymbolId, 3> legs;  // Same layout as ArbitrageOpportunity::legs
+        bool has_data;
+        bool has_opportunity;
+        double profit_percent;  // Best direction, also when below threshold
+        ArbitrageOpportunity opportunity;  // Valid when has_opportunity
+        
+        RouteStatus() : kind(RouteKind::CrossPair), legs{}, has_data(false), has_opportunity(false), profit_percent(0.0) {}
+    };
+    
+    uint64_t sequence;  // Incremented on every publication
+    uint64_t check_count;
+    uint64_t config_version;  // Route table the routes below belong to
+    double threshold_percent;
+    double fee_percent;
+    std::vector<RouteStatus> routes;  // Route table order
+    std::shared_ptr<const std::vector<std::string>> pairs;  // Every pair the route table reads
+    std::vector<ImpliedRateSummary> implied_rates;  // Best rate of every asset into each quote asset
+    
+    // Best opportunity seen since the previous publication (event path included)
+    std::optional<ArbitrageOpportunity> best;
+    // best was found on the event path since the previous publication and beat
+    // every route in routes; it may no longer be there at publication time
+    bool best_from_event_path;
+    
+    DetectorResults()
+        : sequence(0), check_count(0), config_version(0), threshold_percent(0.0), fee_percent(0.0),
+          best_from_event_path(false) {}
+};
+
+// One route of a detector configuration, by pair name (see RouteKind)
+// CrossPair: ARB/XXX, XXX/USDT, ARB/USDT
+// DirectComparison: ARB/STABLE, ARB/USDT
+// MultiLeg: ARB/QUOTE, ARB/INTERMEDIATE, INTERMEDIATE/USDT (valued via QUOTE/USDT)
+struct RouteDefinition {
+    RouteKind kind = RouteKind::CrossPair;
+    std::vector<std::string> pairs;
+    
+    // Every pair the route reads, including the multi-leg valuation pair
+    std::vector<std::string> allPairs() const;
+    
+    // Checks the pair count and that consecutive legs share an asset
+    bool validate(std::string* error = nullptr) const;
+};
+
+// Detector parameters that can be replaced while the engine runs
+struct DetectorConfig {
+    double threshold_percent = 0.10;
+    double fee_percent = 0.0;  // Taker fee charged on every trade of a route
+    std::vector<RouteDefinition> routes;
+    
+    // The built-in ARB route table
+    static DetectorConfig defaults(double threshold_percent = 0.10);
+    
+    bool validate(std::string* error = nullptr) const;
+    
+    // Distinct pairs read by the routes, in first-use order
+    std::vector<std::string> allPairs() const;
+};
+
 class ArbitrageDetector {
 public:
+    // Invoked for every opportunity found on the event path
+    // Calls are serialized (trigger lock held): keep it short and non-blocking
+    using OpportunityCallback = std::function<void(const ArbitrageOpportunity& opp, uint64_t receive_ns)>;
+    
     explicit ArbitrageDetector(MarketState& market_state, double threshold_percent = 0.10);
+    ArbitrageDetector(MarketState& market_state, const DetectorConfig& config);
+    
+    // Must be set before book updates arrive
+    void setOpportunityCallback(OpportunityCallback callback);
     
     // Check for arbitrage opportunities
     // Returns optional because check may fail if data is missing
+    // Books changed without an onBookUpdate are read into the rate matrix first
     std::optional<ArbitrageOpportunity> checkOpportunities() const;
     
-    // Get current check count (for heartbeat)
-    int getCheckCount() const { return check_count_; }
+    // Event-driven check after a book update for one symbol
+    // Compares the new price against the trigger index and only checks the
+    // routes through the symbol whose trigger the new price crossed
+    // receive_ns is the frame receive time, handed to the opportunity callback
+    std::optional<ArbitrageOpportunity> onBookUpdate(const std::string& symbol, uint64_t receive_ns = 0);
+    
+    // Same, for a caller that already holds the symbol's book (no MarketState lookup)
+    std::optional<ArbitrageOpportunity> onBookUpdate(const std::string& symbol, const OrderBook& book, uint64_t receive_ns);
     
-    // Increment check count (call after each check)
-    void incrementCheckCount() { ++check_count_; }
+    // Evaluate every route once and publish a new results snapshot; best is taken
+    // from those route statuses and the event path, nothing is priced twice
+    // Call from a single detection/heartbeat thread
+    void publishResults();
     
-    // Reset check count (for heartbeat)
-    void resetCheckCount() { check_count_ = 0; }
+    // Latest published snapshot (never null); lock-free for readers
+    std::shared_ptr<const DetectorResults> getResults() const;
     
-    // Public methods to check individual routes (for UI display)
-    std::optional<ArbitrageOpportunity> checkRoutePublic(
-        const std::string& arb_pair,
-        const std::string& cross_pair
-    ) const;
+    // Replace the route table, threshold and fees; config must validate
+    // The new table and its trigger index are built and seeded from the current
+    // books on the calling thread, then swapped in under the trigger lock, so
+    // the event path never waits on more than a pointer swap
+    // Returns the new config version, 0 if config does not validate (nothing changes)
+    // Call from one thread at a time
+    uint64_t applyConfig(const DetectorConfig& config);
     
-    std::optional<ArbitrageOpportunity> checkDirectComparisonPublic(
-        const std::string& arb_stable_pair
-    ) const;
+    // Config version of the route table in use; lock-free, any thread
+    uint64_t getConfigVersion() const;
     
-    // Public method to check multi-leg routes (for UI display)
-    std::optional<ArbitrageOpportunity> checkMultiLegRoutePublic(
-        const std::string& start_pair,  // e.g., "ARB/EUR"
-        const std::string& intermediate_pair, // e.g., "ARB/BTC"
-        const std::string& final_pair   // e.g., "BTC/USDT"
-    ) const;
+    // Implied-rate matrix of the route table in use, shared by every route
+    // Kept alive by the returned pointer across a config swap; lock-free, any thread
+    std::shared_ptr<const ImpliedRateMatrix> getRates() const;
+    
+    // Event-path checks and opportunities found so far; lock-free, any thread
+    uint64_t getCheckCount() const { return check_count_.load(std::memory_order_relaxed); }
+    uint64_t getOpportunityCount() const { return opportunity_count_.load(std::memory_order_relaxed); }
 
 private:
+    // One entry of the route table; matrix indices are resolved once when the table is built
+    struct Route {
+        RouteKind kind;
+        std::array<SymbolId, 3> legs;     // Same layout as ArbitrageOpportunity::legs
+        std::array<uint32_t, 4> quotes;   // Matrix pairs for legs, then QUOTE/USDT; NPOS if unused
+        uint32_t implied_path;            // CrossPair: ARB via XXX into USDT, MultiLeg: ARB via INTERMEDIATE
+        uint32_t valuation_path;          // MultiLeg: QUOTE into USDT
+        double fee_factor;                // Share of the proceeds left after fees on every trade
+    };
+    
+    // Immutable once published; replaced as a whole by applyConfig
+    struct RouteTable {
+        uint64_t version = 0;
+        double threshold_percent = 0.0;
+        double fee_percent = 0.0;
+        std::vector<Route> routes;  // Checked by checkAllRoutes, in order
+        std::shared_ptr<const std::vector<std::string>> pairs;
+        std::shared_ptr<ImpliedRateMatrix> rates = std::make_shared<ImpliedRateMatrix>();  // Written under trigger_mutex_ once published
+    };
+    
     MarketState& market_state_;
-    double threshold_percent_;
-    mutable int check_count_;
+    
+    // Written under trigger_mutex_, read without it
+    std::atomic<uint64_t> check_count_;
+    std::atomic<uint64_t> opportunity_count_;
+    
+    // Current route table; written only under trigger_mutex_ through std::atomic_store,
+    // read with std::atomic_load outside the lock
+    std::shared_ptr<const RouteTable> table_;
+    uint64_t config_version_;  // applyConfig only
+    
+    // Trigger prices per route leg and rate matrix writes (guarded by trigger_mutex_)
+    mutable std::mutex trigger_mutex_;
+    TriggerIndex trigger_index_;
+    
+    // Best event-path opportunity since the last publication (guarded by trigger_mutex_)
+    std::optional<ArbitrageOpportunity> pending_best_;
+    
+    OpportunityCallback on_opportunity_;
+    
+    // Published snapshot; accessed only through std::atomic_load / std::atomic_store
+    std::shared_ptr<const DetectorResults> results_;
+    uint64_t results_sequence_;
+    
+    // Route table construction
+    std::shared_ptr<const RouteTable> buildRouteTable(const DetectorConfig& config, uint64_t version) const;
+    
+    // Route directions in trigger index form
+    std::vector<TriggerRoute> buildTriggerRoutes(const RouteTable& table) const;
+    
+    // Current status of a route, including profit below threshold
+    DetectorResults::RouteStatus evaluateRouteStatus(const RouteTable& table, uint32_t route_id) const;
     
     // Check all routes and return best opportunity
-    std::optional<ArbitrageOpportunity> checkAllRoutes() const;
-    
-    // Check a specific route (e.g., ARB/BTC -> BTC/USDT)
-    // Returns best opportunity from both directions
-    std::optional<ArbitrageOpportunity> checkRoute(
-        const std::string& arb_pair,  // e.g., "ARB/BTC"
-        const std::string& cross_pair // e.g., "BTC/USDT"
-    ) const;
-    
-    // Check direction 1 for a route: Buy implied, sell direct
-    std::optional<ArbitrageOpportunity> checkRouteDirection1(
-        const std::string& arb_pair,
-        const std::string& cross_pair
-    ) const;
-    
-    // Check direction 2 for a route: Buy direct, sell implied
-    std::optional<ArbitrageOpportunity> checkRouteDirection2(
-        const std::string& arb_pair,
-        const std::string& cross_pair
-    ) const;
+    std::optional<ArbitrageOpportunity> checkAllRoutes(const RouteTable& table) const;
+    
+    // Check a single route table entry
+    std::optional<ArbitrageOpportunity> checkRoute(const RouteTable& table, uint32_t route_id) const;
+    
+    // Check direction 1 for a cross-pair route: Buy implied, sell direct
+    std::optional<ArbitrageOpportunity> checkRouteDirection1(const RouteTable& table, uint32_t route_id) const;
+    
+    // Check direction 2 for a cross-pair route: Buy direct, sell implied
+    std::optional<ArbitrageOpportunity> checkRouteDirection2(const RouteTable& table, uint32_t route_id) const;
     
     // Check direct comparison (for stablecoins: ARB/FDUSD, ARB/USDC, ARB/TUSD vs ARB/USDT)
-    std::optional<ArbitrageOpportunity> checkDirectComparison(
-        const std::string& arb_stable_pair  // e.g., "ARB/FDUSD"
-    ) const;
+    std::optional<ArbitrageOpportunity> checkDirectComparison(const RouteTable& table, uint32_t route_id) const;
     
     // Check multi-leg route (3+ legs)
     // Example: ARB/EUR -> ARB/BTC -> BTC/USDT
-    std::optional<ArbitrageOpportunity> checkMultiLegRoute(
-        const std::string& start_pair,      // e.g., "ARB/EUR"
-        const std::string& intermediate_pair, // e.g., "ARB/BTC"
-        const std::string& final_pair       // e.g., "BTC/USDT"
-    ) const;
+    std::optional<ArbitrageOpportunity> checkMultiLegRoute(const RouteTable& table, uint32_t route_id) const;
     
     // Validate price is reasonable (not zero, not NaN, not absurdly large)
     bool isValidPrice(double price) const;
     
-    // Get snapshot for a symbol, return nullopt if invalid
-    std::optional<OrderBook::Snapshot> getValidSnapshot(const std::string& symbol) const;
+    // Sane positive prices and bid <= ask
+    bool isValidSnapshot(const OrderBook::Snapshot& snap) const;
+    
+    // Matrix quote of a pair, return nullopt if missing or invalid
+    std::optional<PairQuote> getValidQuote(const ImpliedRateMatrix& rates, uint32_t pair) const;
 };
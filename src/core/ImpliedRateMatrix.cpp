@@ -0,0 +1,283 @@
+#include "ImpliedRateMatrix.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+    constexpr int SPINS_BEFORE_YIELD = 64;
+    
+    bool isValidPrice(double price) {
+        constexpr double MAX_REASONABLE_PRICE = 1000000.0;
+        return !std::isnan(price) && !std::isinf(price) && price > 0.0 && price <= MAX_REASONABLE_PRICE;
+    }
+    
+    // Retry a seqlock read until it did not overlap a write
+    template <typename Record, typename Read>
+    void readConsistent(const Record& record, Read&& read) {
+        for (int attempt = 1;; ++attempt) {
+            uint64_t before = record.sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                read();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (record.sequence.load(std::memory_order_relaxed) == before) {
+                    return;
+                }
+            }
+            if (attempt % SPINS_BEFORE_YIELD == 0) {
+                std::this_thread::yield();  // The writer was preempted mid-record
+            }
+        }
+    }
+    
+    template <typename Record, typename Write>
+    void writeRecord(Record& record, Write&& write) {
+        uint64_t sequence = record.sequence.load(std::memory_order_relaxed);
+        record.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        write();
+        record.sequence.store(sequence + 2, std::memory_order_release);
+    }
+}
+
+ImpliedRateMatrix::ImpliedRateMatrix(const std::vector<std::pair<std::string, const OrderBook*>>& pairs,
+                                     const std::vector<std::string>& quote_assets) {
+    std::vector<std::string> assets;  // First-use order
+    for (const auto& [name, book] : pairs) {
+        size_t slash = name.find('/');
+        if (slash == std::string::npos || pair_index_.count(name) > 0) {
+            continue;
+        }
+        Pair pair;
+        pair.name = name;
+        pair.base = name.substr(0, slash);
+        pair.quote = name.substr(slash + 1);
+        pair.book = book;
+        pair_index_.emplace(name, static_cast<uint32_t>(pairs_.size()));
+        for (const auto* asset : {&pair.base, &pair.quote}) {
+            if (std::find(assets.begin(), assets.end(), *asset) == assets.end()) {
+                assets.push_back(*asset);
+            }
+        }
+        pairs_.push_back(std::move(pair));
+    }
+    
+    for (const auto& quote : quote_assets) {
+        for (const auto& asset : assets) {
+            if (asset == quote) {
+                continue;
+            }
+            bool inverted = false;
+            uint32_t direct = findLink(asset, quote, inverted);
+            if (direct != NPOS) {
+                addPath(asset, quote, std::string(), {{{direct, inverted}, {NPOS, false}}}, 1);
+            }
+            for (const auto& via : assets) {
+                if (via == asset || via == quote) {
+                    continue;
+                }
+                bool first_inverted = false;
+                bool second_inverted = false;
+                uint32_t first = findLink(asset, via, first_inverted);
+                uint32_t second = first == NPOS ? NPOS : findLink(via, quote, second_inverted);
+                if (second != NPOS) {
+                    addPath(asset, quote, via, {{{first, first_inverted}, {second, second_inverted}}}, 2);
+                }
+            }
+        }
+    }
+    
+    quote_records_ = std::make_unique<QuoteRecord[]>(pairs_.size());
+    rate_records_ = std::make_unique<RateRecord[]>(paths_.size());
+}
+
+uint32_t ImpliedRateMatrix::findLink(const std::string& from, const std::string& to, bool& inverted) const {
+    auto it = pair_index_.find(from + "/" + to);
+    if (it != pair_index_.end()) {
+        inverted = false;
+        return it->second;
+    }
+    it = pair_index_.find(to + "/" + from);
+    if (it != pair_index_.end()) {
+        inverted = true;
+        return it->second;
+    }
+    return NPOS;
+}
+
+void ImpliedRateMatrix::addPath(const std::string& asset, const std::string& quote, const std::string& via,
+                                std::array<Leg, 2> legs, size_t leg_count) {
+    auto id = static_cast<uint32_t>(paths_.size());
+    paths_.push_back({asset, quote, via, legs, leg_count});
+    path_index_.emplace(pathKey(asset, quote, via), id);
+    for (size_t i = 0; i < leg_count; ++i) {
+        pairs_[legs[i].pair].paths.push_back(id);
+    }
+    
+    auto entry = std::find_if(assets_.begin(), assets_.end(), [&](const AssetPaths& candidate) {
+        return candidate.asset == asset && candidate.quote == quote;
+    });
+    if (entry == assets_.end()) {
+        assets_.push_back({asset, quote, {}});
+        entry = std::prev(assets_.end());
+    }
+    entry->paths.push_back(id);
+}
+
+std::string ImpliedRateMatrix::pathKey(const std::string& asset, const std::string& quote, const std::string& via) {
+    return asset + "/" + quote + "/" + via;
+}
+
+void ImpliedRateMatrix::update(uint32_t pair, const OrderBook::Snapshot& snapshot) {
+    if (pair >= pairs_.size()) {
+        return;
+    }
+    PairQuote& current = pairs_[pair].current;
+    if (snapshot.version <= current.version) {
+        return; // Already fed, or a newer snapshot got here first
+    }
+    
+    current.bid_price = snapshot.bid_price;
+    current.bid_qty = snapshot.bid_qty;
+    current.ask_price = snapshot.ask_price;
+    current.ask_qty = snapshot.ask_qty;
+    current.version = snapshot.version;
+    current.has_data = snapshot.has_data;
+    current.valid = snapshot.has_data && isValidPrice(snapshot.bid_price) && isValidPrice(snapshot.ask_price) &&
+        snapshot.bid_price <= snapshot.ask_price;
+    
+    QuoteRecord& record = quote_records_[pair];
+    writeRecord(record, [&]() {
+        record.bid_price.store(current.bid_price, std::memory_order_relaxed);
+        record.bid_qty.store(current.bid_qty, std::memory_order_relaxed);
+        record.ask_price.store(current.ask_price, std::memory_order_relaxed);
+        record.ask_qty.store(current.ask_qty, std::memory_order_relaxed);
+        record.version.store(current.version, std::memory_order_relaxed);
+        record.has_data.store(current.has_data, std::memory_order_relaxed);
+        record.valid.store(current.valid, std::memory_order_relaxed);
+    });
+    
+    for (uint32_t path : pairs_[pair].paths) {
+        recompute(path);
+    }
+}
+
+size_t ImpliedRateMatrix::sync() {
+    size_t refreshed = 0;
+    for (uint32_t pair = 0; pair < pairs_.size(); ++pair) {
+        const OrderBook* book = pairs_[pair].book;
+        if (book != nullptr && book->activity().updates > pairs_[pair].current.version) {
+            update(pair, book->snapshot());
+            ++refreshed;
+        }
+    }
+    return refreshed;
+}
+
+void ImpliedRateMatrix::recompute(uint32_t path_id) {
+    const Path& path = paths_[path_id];
+    
+    ImpliedRate rate;
+    rate.bid = 1.0;
+    rate.ask = 1.0;
+    rate.has_data = true;
+    rate.valid = true;
+    for (size_t i = 0; i < path.leg_count; ++i) {
+        const Leg& leg = path.legs[i];
+        const PairQuote& quote = pairs_[leg.pair].current;
+        rate.has_data = rate.has_data && quote.has_data;
+        rate.valid = rate.valid && quote.valid;
+        if (!leg.inverted) {
+            rate.bid *= quote.bid_price;
+            rate.ask *= quote.ask_price;
+        } else if (quote.ask_price > 0.0 && quote.bid_price > 0.0) {
+            // Selling one unit buys 1/ask of the pair's base; buying one unit sells 1/bid of it
+            rate.bid /= quote.ask_price;
+            rate.ask /= quote.bid_price;
+        } else {
+            rate.bid = 0.0;
+            rate.ask = 0.0;
+            rate.valid = false;
+        }
+    }
+    
+    RateRecord& record = rate_records_[path_id];
+    writeRecord(record, [&]() {
+        record.bid.store(rate.bid, std::memory_order_relaxed);
+        record.ask.store(rate.ask, std::memory_order_relaxed);
+        record.has_data.store(rate.has_data, std::memory_order_relaxed);
+        record.valid.store(rate.valid, std::memory_order_relaxed);
+    });
+    product_count_.store(product_count_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+uint32_t ImpliedRateMatrix::pairIndex(const std::string& pair) const {
+    auto it = pair_index_.find(pair);
+    return it == pair_index_.end() ? NPOS : it->second;
+}
+
+uint32_t ImpliedRateMatrix::pathIndex(const std::string& asset, const std::string& quote, const std::string& via) const {
+    auto it = path_index_.find(pathKey(asset, quote, via));
+    return it == path_index_.end() ? NPOS : it->second;
+}
+
+PairQuote ImpliedRateMatrix::quote(uint32_t pair) const {
+    PairQuote quote;
+    if (pair >= pairs_.size()) {
+        return quote;
+    }
+    const QuoteRecord& record = quote_records_[pair];
+    readConsistent(record, [&]() {
+        quote.bid_price = record.bid_price.load(std::memory_order_relaxed);
+        quote.bid_qty = record.bid_qty.load(std::memory_order_relaxed);
+        quote.ask_price = record.ask_price.load(std::memory_order_relaxed);
+        quote.ask_qty = record.ask_qty.load(std::memory_order_relaxed);
+        quote.version = record.version.load(std::memory_order_relaxed);
+        quote.has_data = record.has_data.load(std::memory_order_relaxed);
+        quote.valid = record.valid.load(std::memory_order_relaxed);
+    });
+    return quote;
+}
+
+ImpliedRate ImpliedRateMatrix::rate(uint32_t path) const {
+    ImpliedRate rate;
+    if (path >= paths_.size()) {
+        return rate;
+    }
+    const RateRecord& record = rate_records_[path];
+    readConsistent(record, [&]() {
+        rate.bid = record.bid.load(std::memory_order_relaxed);
+        rate.ask = record.ask.load(std::memory_order_relaxed);
+        rate.has_data = record.has_data.load(std::memory_order_relaxed);
+        rate.valid = record.valid.load(std::memory_order_relaxed);
+    });
+    return rate;
+}
+
+std::vector<ImpliedRateSummary> ImpliedRateMatrix::summarize() const {
+    std::vector<ImpliedRateSummary> summaries;
+    summaries.reserve(assets_.size());
+    for (const auto& entry : assets_) {
+        ImpliedRateSummary summary;
+        summary.asset = entry.asset;
+        summary.quote = entry.quote;
+        summary.path_count = entry.paths.size();
+        for (uint32_t path : entry.paths) {
+            ImpliedRate current = rate(path);
+            summary.best.has_data = summary.best.has_data || current.has_data;
+            if (!current.valid) {
+                continue;
+            }
+            if (!summary.best.valid || current.bid > summary.best.bid) {
+                summary.best.bid = current.bid;
+                summary.best_bid_via = paths_[path].via;
+            }
+            if (!summary.best.valid || current.ask < summary.best.ask) {
+                summary.best.ask = current.ask;
+                summary.best_ask_via = paths_[path].via;
+            }
+            summary.best.valid = true;
+        }
+        summaries.push_back(std::move(summary));
+    }
+    return summaries;
+}
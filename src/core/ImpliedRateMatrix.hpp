@@ -0,0 +1,160 @@
+#pragma once
+
+#include "OrderBook.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Top of book of one input pair, as last fed to the matrix
+struct PairQuote {
+    double bid_price = 0.0;
+    double bid_qty = 0.0;
+    double ask_price = 0.0;
+    double ask_qty = 0.0;
+    uint64_t version = 0;   // OrderBook version it was read at
+    bool has_data = false;
+    bool valid = false;     // Sane positive prices and bid <= ask
+};
+
+// Price of one unit of an asset in a quote asset through one path
+struct ImpliedRate {
+    double bid = 0.0;       // Received for selling one unit
+    double ask = 0.0;       // Paid for buying one unit
+    bool has_data = false;  // Every leg has data
+    bool valid = false;     // Every leg is valid
+};
+
+// Best rates of one asset over all of its valid paths, for display
+struct ImpliedRateSummary {
+    std::string asset;
+    std::string quote;
+    ImpliedRate best;          // Best bid and best ask, possibly from different paths
+    std::string best_bid_via;  // Empty: the direct pair
+    std::string best_ask_via;
+    size_t path_count = 0;
+};
+
+// Implied rates of every asset into the quote assets (USDT) through every path
+// of up to two pairs: ASSET/QUOTE directly, or ASSET/VIA then VIA/QUOTE.
+// Either pair may be listed the other way round (QUOTE/ASSET); its side is
+// then inverted. For a path of ASSET/VIA and VIA/QUOTE:
+//   bid = bid(ASSET/VIA) * bid(VIA/QUOTE), ask = ask(ASSET/VIA) * ask(VIA/QUOTE)
+// A pair update recomputes only the paths that read it, so every product is
+// computed once per tick and shared by all readers.
+// Writers are serialized by the owner; every pair quote and every path rate is
+// a seqlock record, so readers on any thread never block the writer and never
+// see a torn value.
+class ImpliedRateMatrix {
+public:
+    static constexpr uint32_t NPOS = UINT32_MAX;
+    
+    // Empty: no pairs, no paths
+    ImpliedRateMatrix() = default;
+    
+    // pairs: every input pair with its book (must outlive the matrix)
+    // quote_assets: assets the rates are expressed in
+    ImpliedRateMatrix(const std::vector<std::pair<std::string, const OrderBook*>>& pairs,
+                      const std::vector<std::string>& quote_assets);
+    
+    ImpliedRateMatrix(const ImpliedRateMatrix&) = delete;
+    ImpliedRateMatrix& operator=(const ImpliedRateMatrix&) = delete;
+    
+    // Writer: feed a snapshot of one pair; a snapshot older than the stored one is ignored
+    void update(uint32_t pair, const OrderBook::Snapshot& snapshot);
+    
+    // Writer: re-read every pair whose book changed since it was last fed
+    // Returns the number of pairs re-read
+    size_t sync();
+    
+    // Resolved once by callers; NPOS if the matrix has no such pair or path
+    uint32_t pairIndex(const std::string& pair) const;
+    uint32_t pathIndex(const std::string& asset, const std::string& quote, const std::string& via = std::string()) const;
+    
+    // Readers, any thread, lock-free
+    PairQuote quote(uint32_t pair) const;
+    ImpliedRate rate(uint32_t path) const;
+    
+    // Best bid/ask per asset and quote asset, assets in first-use order
+    std::vector<ImpliedRateSummary> summarize() const;
+    
+    size_t getPairCount() const { return pairs_.size(); }
+    size_t getPathCount() const { return paths_.size(); }
+    
+    // Path products computed so far; relaxed, any thread
+    uint64_t getProductCount() const { return product_count_.load(std::memory_order_relaxed); }
+
+private:
+    struct Leg {
+        uint32_t pair;
+        bool inverted;  // The pair is listed TO/FROM
+    };
+    
+    struct Path {
+        std::string asset;
+        std::string quote;
+        std::string via;  // Empty: direct
+        std::array<Leg, 2> legs;
+        size_t leg_count;
+    };
+    
+    struct Pair {
+        std::string name;
+        std::string base;
+        std::string quote;
+        const OrderBook* book;
+        PairQuote current;               // Writer's copy
+        std::vector<uint32_t> paths;     // Paths that read this pair
+    };
+    
+    struct alignas(64) QuoteRecord {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<double> bid_price{0.0};
+        std::atomic<double> bid_qty{0.0};
+        std::atomic<double> ask_price{0.0};
+        std::atomic<double> ask_qty{0.0};
+        std::atomic<uint64_t> version{0};
+        std::atomic<bool> has_data{false};
+        std::atomic<bool> valid{false};
+    };
+    
+    struct alignas(64) RateRecord {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<double> bid{0.0};
+        std::atomic<double> ask{0.0};
+        std::atomic<bool> has_data{false};
+        std::atomic<bool> valid{false};
+    };
+    
+    void addPath(const std::string& asset, const std::string& quote, const std::string& via,
+                 std::array<Leg, 2> legs, size_t leg_count);
+    
+    // Pair between two assets in either orientation; NPOS if none
+    uint32_t findLink(const std::string& from, const std::string& to, bool& inverted) const;
+    
+    // Writer: recompute one path from the writer's pair copies and publish it
+    void recompute(uint32_t path);
+    
+    static std::string pathKey(const std::string& asset, const std::string& quote, const std::string& via);
+    
+    std::vector<Pair> pairs_;
+    std::vector<Path> paths_;
+    std::unordered_map<std::string, uint32_t> pair_index_;
+    std::unordered_map<std::string, uint32_t> path_index_;
+    
+    // Every (asset, quote) with at least one path, in first-use order
+    struct AssetPaths {
+        std::string asset;
+        std::string quote;
+        std::vector<uint32_t> paths;
+    };
+    std::vector<AssetPaths> assets_;
+    
+    std::unique_ptr<QuoteRecord[]> quote_records_;
+    std::unique_ptr<RateRecord[]> rate_records_;
+    std::atomic<uint64_t> product_count_{0};
+};
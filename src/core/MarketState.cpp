@@ -1,12 +1,23 @@
 #include "MarketState.hpp"
+#include "SharedBookSegment.hpp"
 
 OrderBook& MarketState::get(const std::string& symbol) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return order_books_[symbol];
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    auto it = order_books_.find(symbol);
+    if (it != order_books_.end()) {
+        return it->second;
+    }
+    
+    OrderBook& book = order_books_[symbol];
+    book_count_.store(order_books_.size(), std::memory_order_relaxed);
+    if (segment_) {
+        attachMirror(symbol, book);
+    }
+    return book;
 }
 
 std::vector<std::string> MarketState::getSymbolsWithData() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
     std::vector<std::string> symbols;
     for (const auto& pair : order_books_) {
         auto snap = pair.second.snapshot();
@@ -16,3 +27,48 @@ std::vector<std::string> MarketState::getSymbolsWithData() const {
     }
     return symbols;
 }
+
+std::vector<std::pair<std::string, const OrderBook*>> MarketState::getBooks() const {
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    std::vector<std::pair<std::string, const OrderBook*>> books;
+    books.reserve(order_books_.size());
+    for (const auto& pair : order_books_) {
+        books.emplace_back(pair.first, &pair.second);
+    }
+    return books;
+}
+
+SymbolId MarketState::getSymbolId(const std::string& symbol) {
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    return registerSymbol(symbol);
+}
+
+SymbolId MarketState::registerSymbol(const std::string& symbol) {
+    auto it = symbol_ids_.find(symbol);
+    if (it != symbol_ids_.end()) {
+        return it->second;
+    }
+    
+    SymbolId id = static_cast<SymbolId>(symbol_names_.size());
+    symbol_names_.push_back(symbol);
+    symbol_ids_.emplace(symbol, id);
+    return id;
+}
+
+const std::string& MarketState::getSymbolName(SymbolId id) const {
+    static const std::string unknown = "?";
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    return id < symbol_names_.size() ? symbol_names_[id] : unknown;
+}
+
+void MarketState::attachSharedSegment(SharedBookSegment* segment) {
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    segment_ = segment;
+    for (auto& pair : order_books_) {
+        attachMirror(pair.first, pair.second);
+    }
+}
+
+void MarketState::attachMirror(const std::string& symbol, OrderBook& book) {
+    book.attachMirror(segment_ ? segment_->attach(registerSymbol(symbol), symbol) : nullptr);
+}
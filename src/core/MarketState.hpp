@@ -1,20 +1,55 @@
 #pragma once
 
 #include "OrderBook.hpp"
+#include "src/util/LockContention.hpp"
 #include <unordered_map>
 #include <string>
 #include <mutex>
 #include <vector>
+#include <deque>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+// Compact, stable identifier for a symbol registered in MarketState
+using SymbolId = uint32_t;
+
+class SharedBookSegment;
 
 class MarketState {
 public:
     // Thread-safe access to OrderBook
+    // Returned references stay valid for the lifetime of MarketState
     OrderBook& get(const std::string& symbol);
     
     // Get all symbols that have data
     std::vector<std::string> getSymbolsWithData() const;
+    
+    // Every book with its symbol; pointers stay valid for the lifetime of MarketState
+    std::vector<std::pair<std::string, const OrderBook*>> getBooks() const;
+    
+    // Lock-free; lets pollers refresh a cached getBooks() list only when it grew
+    size_t getBookCount() const { return book_count_.load(std::memory_order_relaxed); }
+    
+    // Stable id for a symbol (registers it on first use)
+    SymbolId getSymbolId(const std::string& symbol);
+    
+    // Symbol name for an id returned by getSymbolId
+    const std::string& getSymbolName(SymbolId id) const;
+    
+    // Mirror every book into a shared-memory segment, slot = symbol id
+    // Existing books are attached right away (segment must outlive MarketState)
+    void attachSharedSegment(SharedBookSegment* segment);
 
 private:
-    mutable std::mutex mutex_;
+    // Caller holds mutex_
+    SymbolId registerSymbol(const std::string& symbol);
+    void attachMirror(const std::string& symbol, OrderBook& book);
+    
+    mutable CountingMutex<LockSite::MarketState> mutex_;
     std::unordered_map<std::string, OrderBook> order_books_;
+    std::unordered_map<std::string, SymbolId> symbol_ids_;
+    std::deque<std::string> symbol_names_;  // Indexed by SymbolId; deque keeps references stable
+    SharedBookSegment* segment_ = nullptr;
+    std::atomic<size_t> book_count_{0};
 };
@@ -0,0 +1,132 @@
+#include "MarketUpdatePipeline.hpp"
+#include "ArbitrageDetector.hpp"
+#include "src/util/LatencyHistogram.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace {
+    // Single writer: no locked RMW needed
+    void bump(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+}
+
+MarketUpdatePipeline::MarketUpdatePipeline(MarketState& market_state, ArbitrageDetector* detector, PipelineConfig config)
+    : market_state_(market_state),
+      detector_(detector),
+      config_(std::move(config)),
+      running_(false),
+      applied_(0),
+      batches_(0),
+      max_batch_(0) {
+    config_.batch_size = std::max<size_t>(1, config_.batch_size);
+}
+
+MarketUpdatePipeline::~MarketUpdatePipeline() {
+    stop();
+}
+
+size_t MarketUpdatePipeline::addProducer() {
+    producers_.push_back(std::make_unique<Producer>(config_.ring_capacity));
+    return producers_.size() - 1;
+}
+
+bool MarketUpdatePipeline::publish(size_t producer, const BookUpdate& update) {
+    Producer& entry = *producers_[producer];
+    if (!entry.ring.tryPush(update)) {
+        bump(entry.overflows);
+        return false;
+    }
+    bump(entry.published);
+    return true;
+}
+
+void MarketUpdatePipeline::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&MarketUpdatePipeline::run, this);
+}
+
+void MarketUpdatePipeline::stop() {
+    running_ = false;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+PipelineStats MarketUpdatePipeline::getStats() const {
+    PipelineStats stats;
+    stats.producers = producers_.size();
+    for (const auto& producer : producers_) {
+        stats.published += producer->published.load(std::memory_order_relaxed);
+        stats.overflows += producer->overflows.load(std::memory_order_relaxed);
+        stats.queued += producer->ring.size();
+    }
+    stats.applied = applied_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.max_batch = max_batch_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void MarketUpdatePipeline::run() {
+    uint32_t idle_polls = 0;
+    while (running_.load(std::memory_order_relaxed)) {
+        if (drainAll() > 0) {
+            idle_polls = 0;
+            continue;
+        }
+        // Spin first so a burst after a short pause is picked up right away
+        if (++idle_polls < config_.idle_spins) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(config_.idle_sleep);
+        }
+    }
+    
+    // Producers may still be publishing; take what was queued before stop()
+    while (drainAll() > 0) {
+    }
+}
+
+size_t MarketUpdatePipeline::drainAll() {
+    size_t drained = 0;
+    for (auto& producer : producers_) {
+        size_t count = producer->ring.drain(config_.batch_size, [this](const BookUpdate& update) { apply(update); });
+        if (count == 0) {
+            continue;
+        }
+        drained += count;
+        bump(batches_);
+        if (count > max_batch_.load(std::memory_order_relaxed)) {
+            max_batch_.store(count, std::memory_order_relaxed);
+        }
+    }
+    bump(applied_, drained);
+    return drained;
+}
+
+void MarketUpdatePipeline::apply(const BookUpdate& update) {
+    uint64_t drained_ns = PipelineLatency::nowNs();
+    PipelineLatency::record(PipelineStage::RingWait, drained_ns - update.parsed_ns);
+    
+    if (update.symbol_id >= targets_.size()) {
+        targets_.resize(update.symbol_id + 1);
+    }
+    Target& target = targets_[update.symbol_id];
+    if (target.book == nullptr) {
+        target.symbol = &market_state_.getSymbolName(update.symbol_id);
+        target.book = &market_state_.get(*target.symbol);
+    }
+    
+    target.book->update(update.bid_price, update.bid_qty, update.ask_price, update.ask_qty, update.timestamp_ms);
+    uint64_t updated_ns = PipelineLatency::nowNs();
+    PipelineLatency::record(PipelineStage::BookUpdate, updated_ns - drained_ns);
+    
+    if (detector_ != nullptr) {
+        detector_->onBookUpdate(*target.symbol, *target.book, update.receive_ns);
+        uint64_t detected_ns = PipelineLatency::nowNs();
+        PipelineLatency::record(PipelineStage::Detect, detected_ns - updated_ns);
+        PipelineLatency::record(PipelineStage::ReceiveToDetect, detected_ns - update.receive_ns);
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "MarketState.hpp"
+#include "src/util/SpscRing.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ArbitrageDetector;
+
+// One parsed top-of-book update in flight from a feed thread
+struct BookUpdate {
+    SymbolId symbol_id;
+    uint64_t update_id;
+    double bid_price;
+    double bid_qty;
+    double ask_price;
+    double ask_qty;
+    int64_t timestamp_ms;
+    uint64_t receive_ns;  // PipelineLatency::nowNs() when the frame was read
+    uint64_t parsed_ns;   // PipelineLatency::nowNs() after parsing
+};
+
+struct PipelineConfig {
+    size_t ring_capacity = 4096;  // Per producer, rounded up to a power of two
+    size_t batch_size = 64;       // Updates drained from one ring before moving to the next
+    uint32_t idle_spins = 2000;   // Empty polls before the thread starts sleeping
+    std::chrono::microseconds idle_sleep{50};
+};
+
+// Point-in-time pipeline counters
+struct PipelineStats {
+    size_t producers = 0;
+    uint64_t published = 0;
+    uint64_t overflows = 0;  // Updates dropped because a ring was full
+    uint64_t applied = 0;
+    uint64_t batches = 0;    // Non-empty drain passes
+    uint64_t max_batch = 0;  // Largest drain pass so far
+    size_t queued = 0;       // Updates waiting in the rings (approximate)
+};
+
+// Single-writer market state pipeline
+// Every feed thread owns one bounded SPSC ring and never takes a lock to
+// hand off an update. One market-state thread drains the rings round-robin,
+// batch_size updates at a time, applies them to the order books and runs
+// the detector inline, so book writes and trigger checks happen on a single
+// thread in a fixed order. A full ring drops the update and counts it;
+// bookTicker updates carry the whole top of book, so the next one repairs it.
+class MarketUpdatePipeline {
+public:
+    // detector may be null (books only)
+    MarketUpdatePipeline(MarketState& market_state, ArbitrageDetector* detector,
+                         PipelineConfig config = PipelineConfig());
+    ~MarketUpdatePipeline();
+    
+    MarketUpdatePipeline(const MarketUpdatePipeline&) = delete;
+    MarketUpdatePipeline& operator=(const MarketUpdatePipeline&) = delete;
+    
+    // Register a producer before start(); the handle selects its ring
+    size_t addProducer();
+    
+    // Producer thread of the handle only, never blocks; false if dropped
+    bool publish(size_t producer, const BookUpdate& update);
+    
+    void start();
+    
+    // Drain what is queued, then join the market-state thread
+    void stop();
+    
+    // Any thread; relaxed counters
+    PipelineStats getStats() const;
+
+private:
+    struct Producer {
+        explicit Producer(size_t capacity) : ring(capacity), published(0), overflows(0) {}
+        
+        SpscRing<BookUpdate> ring;
+        std::atomic<uint64_t> published;  // Written by the producer only
+        std::atomic<uint64_t> overflows;
+    };
+    
+    // Resolved once per symbol on the market-state thread
+    struct Target {
+        OrderBook* book = nullptr;
+        const std::string* symbol = nullptr;
+    };
+    
+    MarketState& market_state_;
+    ArbitrageDetector* detector_;
+    PipelineConfig config_;
+    std::vector<std::unique_ptr<Producer>> producers_;
+    
+    std::atomic<bool> running_;
+    std::thread thread_;
+    
+    // Market-state thread counters
+    std::atomic<uint64_t> applied_;
+    std::atomic<uint64_t> batches_;
+    std::atomic<uint64_t> max_batch_;
+    
+    // Market-state thread only
+    std::vector<Target> targets_;  // Indexed by SymbolId
+    
+    void run();
+    size_t drainAll();
+    void apply(const BookUpdate& update);
+};
@@ -0,0 +1,51 @@
+#include "OpportunityFormatter.hpp"
+
+std::string OpportunityFormatter::routeName(const ArbitrageOpportunity& opp, const MarketState& market_state) {
+    return routeName(opp.kind, opp.legs, market_state);
+}
+
+std::string OpportunityFormatter::routeName(RouteKind kind, const std::array<SymbolId, 3>& legs, const MarketState& market_state) {
+    const std::string& leg0 = market_state.getSymbolName(legs[0]);
+    const std::string& leg1 = market_state.getSymbolName(legs[1]);
+    
+    switch (kind) {
+        case RouteKind::DirectComparison:
+            return leg0 + " vs " + leg1;
+        case RouteKind::MultiLeg:
+            return leg0 + " -> " + leg1 + " -> " + market_state.getSymbolName(legs[2]);
+        case RouteKind::CrossPair:
+        default:
+            return leg0 + " -> " + leg1;
+    }
+}
+
+std::string OpportunityFormatter::tradeSequence(const ArbitrageOpportunity& opp, const MarketState& market_state) {
+    const std::string& leg0 = market_state.getSymbolName(opp.legs[0]);
+    const std::string& leg1 = market_state.getSymbolName(opp.legs[1]);
+    
+    switch (opp.kind) {
+        case RouteKind::DirectComparison:
+            return opp.direction == 1
+                ? "Buy " + leg0 + " -> Sell " + leg1
+                : "Buy " + leg1 + " -> Sell " + leg0;
+        case RouteKind::MultiLeg:
+            return "Buy " + leg0 + " -> Sell " + leg1 + " -> Sell " + market_state.getSymbolName(opp.legs[2]);
+        case RouteKind::CrossPair:
+        default: {
+            const std::string& direct = market_state.getSymbolName(opp.legs[2]);
+            // A scanner leg listed the other way round (USDT/Q, USDT/A) is traded on the opposite side
+            size_t slash = leg0.find('/');
+            bool quote_inverted = leg1.compare(0, leg0.size() - slash, leg0.substr(slash + 1) + "/") != 0;
+            bool direct_inverted = direct.compare(0, slash + 1, leg0.substr(0, slash + 1)) != 0;
+            auto side = [](bool buy, bool inverted) { return buy != inverted ? "Buy " : "Sell "; };
+            return opp.direction == 1
+                ? "Buy " + leg0 + " -> " + side(true, quote_inverted) + leg1 + " -> " + side(false, direct_inverted) + direct
+                : side(true, direct_inverted) + direct + " -> Sell " + leg0 + " -> " + side(false, quote_inverted) + leg1;
+        }
+    }
+}
+
+std::string OpportunityFormatter::tradableCurrency(const ArbitrageOpportunity& opp, const MarketState& market_state) {
+    const std::string& leg0 = market_state.getSymbolName(opp.legs[0]);
+    return leg0.substr(0, leg0.find('/'));
+}
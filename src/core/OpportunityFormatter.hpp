@@ -0,0 +1,20 @@
+#pragma once
+
+#include "ArbitrageDetector.hpp"
+#include "MarketState.hpp"
+#include <string>
+
+// Human-readable descriptions of an ArbitrageOpportunity
+// Formatted on demand by the logger and UI, never on the detection path
+class OpportunityFormatter {
+public:
+    // e.g. "ARB/BTC -> BTC/USDT", "ARB/FDUSD vs ARB/USDT"
+    static std::string routeName(const ArbitrageOpportunity& opp, const MarketState& market_state);
+    static std::string routeName(RouteKind kind, const std::array<SymbolId, 3>& legs, const MarketState& market_state);
+    
+    // e.g. "Buy ARB/BTC -> Buy BTC/USDT -> Sell ARB/USDT"
+    static std::string tradeSequence(const ArbitrageOpportunity& opp, const MarketState& market_state);
+    
+    // Currency of max_tradable_amount: base asset of the first leg (e.g. "ARB")
+    static std::string tradableCurrency(const ArbitrageOpportunity& opp, const MarketState& market_state);
+};
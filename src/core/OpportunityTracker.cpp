@@ -0,0 +1,79 @@
+#include "OpportunityTracker.hpp"
+#include <algorithm>
+
+size_t OpportunityTracker::KeyHash::operator()(const Key& key) const {
+    // FNV-1a over the key fields
+    uint64_t hash = 1469598103934665603ULL;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    mix(static_cast<uint64_t>(key.source));
+    mix(static_cast<uint64_t>(key.kind));
+    mix(static_cast<uint64_t>(key.direction));
+    for (SymbolId leg : key.legs) {
+        mix(leg);
+    }
+    return static_cast<size_t>(hash);
+}
+
+OpportunityTracker::OpportunityTracker()
+    : pass_(0), closed_count_(0) {}
+
+bool OpportunityTracker::observe(const ArbitrageOpportunity& opp, int64_t now_ms) {
+    if (!opp.valid) {
+        return false;
+    }
+    
+    Key key{opp.source, opp.kind, opp.direction, opp.legs};
+    auto it = open_.find(key);
+    if (it == open_.end()) {
+        OpenEpisode open;
+        open.episode.entry = opp;
+        open.episode.peak = opp;
+        open.episode.peak_tradable_amount = opp.max_tradable_amount;
+        open.episode.observations = 1;
+        open.episode.open_ms = now_ms;
+        open.episode.last_seen_ms = now_ms;
+        open.last_pass = pass_;
+        open_.emplace(key, open);
+        return true;
+    }
+    
+    OpportunityEpisode& episode = it->second.episode;
+    if (opp.profit_percent > episode.peak.profit_percent) {
+        episode.peak = opp;
+    }
+    episode.peak_tradable_amount = std::max(episode.peak_tradable_amount, opp.max_tradable_amount);
+    episode.last_seen_ms = std::max(episode.last_seen_ms, now_ms);
+    
+    // Several observations in one pass (e.g. event path and periodic check) count once
+    if (it->second.last_pass != pass_) {
+        ++episode.observations;
+        it->second.last_pass = pass_;
+    }
+    return false;
+}
+
+void OpportunityTracker::endPass(int64_t now_ms, std::vector<OpportunityEpisode>& closed) {
+    for (auto it = open_.begin(); it != open_.end();) {
+        if (it->second.last_pass != pass_) {
+            it->second.episode.close_ms = now_ms;
+            closed.push_back(it->second.episode);
+            ++closed_count_;
+            it = open_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    ++pass_;
+}
+
+void OpportunityTracker::closeAll(int64_t now_ms, std::vector<OpportunityEpisode>& closed) {
+    for (auto& [key, open] : open_) {
+        open.episode.close_ms = now_ms;
+        closed.push_back(open.episode);
+        ++closed_count_;
+    }
+    open_.clear();
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ArbitrageDetector.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// One continuous stretch of a route/direction staying above threshold
+struct OpportunityEpisode {
+    ArbitrageOpportunity entry;  // First observation
+    ArbitrageOpportunity peak;   // Observation with the highest profit
+    double peak_tradable_amount;  // Largest max_tradable_amount seen during the episode
+    uint32_t observations;
+    int64_t open_ms;       // First observation
+    int64_t last_seen_ms;  // Last observation
+    int64_t close_ms;      // First pass without the route
+    
+    // Lower bound: time between the first and last observation
+    int64_t durationMs() const { return last_seen_ms - open_ms; }
+    
+    OpportunityEpisode()
+        : peak_tradable_amount(0.0), observations(0),
+          open_ms(0), last_seen_ms(0), close_ms(0) {}
+};
+
+// Turns repeated sightings of the same opportunity into episodes
+// Episodes are keyed by source, route kind, legs and direction. Feed one producer per
+// tracker: observe() every opportunity of an evaluation pass, then endPass()
+// closes the episodes that pass did not see. Durations resolve to the pass period.
+class OpportunityTracker {
+public:
+    OpportunityTracker();
+    
+    // Record an opportunity above threshold seen in the current pass
+    // Returns true when this observation opened a new episode
+    bool observe(const ArbitrageOpportunity& opp, int64_t now_ms);
+    
+    // Finish the current pass; appends episodes that closed to closed
+    void endPass(int64_t now_ms, std::vector<OpportunityEpisode>& closed);
+    
+    // Close every open episode (shutdown)
+    void closeAll(int64_t now_ms, std::vector<OpportunityEpisode>& closed);
+    
+    size_t getOpenCount() const { return open_.size(); }
+    uint64_t getClosedCount() const { return closed_count_; }
+
+private:
+    struct Key {
+        OpportunitySource source;
+        RouteKind kind;
+        int direction;
+        std::array<SymbolId, 3> legs;
+        
+        bool operator==(const Key& other) const {
+            return source == other.source && kind == other.kind && direction == other.direction && legs == other.legs;
+        }
+    };
+    
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    
+    struct OpenEpisode {
+        OpportunityEpisode episode;
+        uint64_t last_pass;
+    };
+    
+    std::unordered_map<Key, OpenEpisode, KeyHash> open_;
+    uint64_t pass_;
+    uint64_t closed_count_;
+};
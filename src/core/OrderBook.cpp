@@ -1,27 +1,44 @@
 #include "OrderBook.hpp"
+#include "SharedBookSegment.hpp"
 
 OrderBook::OrderBook()
     : bid_price_(0.0), bid_qty_(0.0), ask_price_(0.0), ask_qty_(0.0),
-      timestamp_ms_(0), has_data_(false) {}
+      timestamp_ms_(0), version_(0), has_data_(false), mirror_(nullptr),
+      updates_(0), last_update_ms_(0) {}
 
 void OrderBook::update(double bid_price, double bid_qty, double ask_price, double ask_qty, int64_t timestamp_ms) {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
     bid_price_ = bid_price;
     bid_qty_ = bid_qty;
     ask_price_ = ask_price;
     ask_qty_ = ask_qty;
     timestamp_ms_ = timestamp_ms;
+    version_++;
     has_data_ = true;
+    updates_.store(version_, std::memory_order_relaxed);
+    last_update_ms_.store(timestamp_ms, std::memory_order_relaxed);
+    if (mirror_) {
+        SharedBookSegment::write(*mirror_, bid_price, bid_qty, ask_price, ask_qty, timestamp_ms, version_);
+    }
 }
 
 OrderBook::Snapshot OrderBook::snapshot() const {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
     Snapshot snap;
     snap.bid_price = bid_price_;
     snap.bid_qty = bid_qty_;
     snap.ask_price = ask_price_;
     snap.ask_qty = ask_qty_;
     snap.timestamp_ms = timestamp_ms_;
+    snap.version = version_;
     snap.has_data = has_data_;
     return snap;
 }
+
+void OrderBook::attachMirror(SharedBookRecord* record) {
+    std::lock_guard<decltype(mutex_)> lock(mutex_);
+    mirror_ = record;
+    if (mirror_ && has_data_) {
+        SharedBookSegment::write(*mirror_, bid_price_, bid_qty_, ask_price_, ask_qty_, timestamp_ms_, version_);
+    }
+}
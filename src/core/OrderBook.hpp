@@ -1,7 +1,12 @@
 #pragma once
 
+#include "src/util/LockContention.hpp"
+#include <atomic>
 #include <mutex>
 #include <chrono>
+#include <cstdint>
+
+struct SharedBookRecord;
 
 class OrderBook {
 public:
@@ -11,13 +16,20 @@ public:
         double ask_price;
         double ask_qty;
         int64_t timestamp_ms;
+        uint64_t version;  // Number of updates applied; unchanged version means unchanged book
         bool has_data;
-
+        
         Snapshot()
             : bid_price(0.0), bid_qty(0.0), ask_price(0.0), ask_qty(0.0),
-              timestamp_ms(0), has_data(false) {}
+              timestamp_ms(0), version(0), has_data(false) {}
     };
-
+    
+    // Update count and time of the last update, for monitoring
+    struct Activity {
+        uint64_t updates;
+        int64_t timestamp_ms;  // 0 before the first update
+    };
+    
     OrderBook();
     
     // Thread-safe update
@@ -25,13 +37,27 @@ public:
     
     // Thread-safe snapshot
     Snapshot snapshot() const;
+    
+    // Lock-free; the two fields are read independently
+    Activity activity() const {
+        return {updates_.load(std::memory_order_relaxed), last_update_ms_.load(std::memory_order_relaxed)};
+    }
+    
+    // Copy every update (and the current state) into a shared-memory record
+    void attachMirror(SharedBookRecord* record);
 
 private:
-    mutable std::mutex mutex_;
+    mutable CountingMutex<LockSite::OrderBook> mutex_;
     double bid_price_;
     double bid_qty_;
     double ask_price_;
     double ask_qty_;
     int64_t timestamp_ms_;
+    uint64_t version_;
     bool has_data_;
+    SharedBookRecord* mirror_;  // Null unless MarketState has a shared segment
+    
+    // Copies of version_ and timestamp_ms_ for readers that must not take the lock
+    std::atomic<uint64_t> updates_;
+    std::atomic<int64_t> last_update_ms_;
 };
@@ -0,0 +1,185 @@
+#include "ParallelRouteEvaluator.hpp"
+#include <algorithm>
+
+ParallelRouteEvaluator::ParallelRouteEvaluator(std::vector<IndexedRoute> routes, double threshold_percent,
+                                               size_t thread_count, size_t shard_size)
+    : routes_(std::move(routes)),
+      threshold_percent_(threshold_percent),
+      shard_size_(std::max<size_t>(shard_size, 1)),
+      shard_count_(0),
+      cursors_(std::max<size_t>(thread_count, 1)),
+      generation_(0),
+      pending_workers_(0),
+      stopping_(false),
+      quotes_(nullptr) {
+    // Order routes by the books they read so neighbouring routes share cache lines
+    auto locality_key = [](const IndexedRoute& route) {
+        std::array<uint32_t, MAX_ROUTE_LEGS> books{};
+        uint32_t leg_count = std::min<uint32_t>(route.leg_count, MAX_ROUTE_LEGS);
+        for (uint32_t i = 0; i < leg_count; ++i) {
+            books[i] = route.legs[i].book;
+        }
+        // Insertion sort: at most MAX_ROUTE_LEGS entries
+        for (uint32_t i = 1; i < leg_count; ++i) {
+            for (uint32_t j = i; j > 0 && books[j] < books[j - 1]; --j) {
+                std::swap(books[j], books[j - 1]);
+            }
+        }
+        return books;
+    };
+    std::stable_sort(routes_.begin(), routes_.end(), [&](const IndexedRoute& a, const IndexedRoute& b) {
+        return locality_key(a) < locality_key(b);
+    });
+
+    shard_count_ = (routes_.size() + shard_size_ - 1) / shard_size_;
+    shard_best_.resize(shard_count_);
+
+    // Static split of shards between workers; stealing evens out the rest
+    size_t workers = cursors_.size();
+    for (size_t w = 0; w < workers; ++w) {
+        cursors_[w].begin = shard_count_ * w / workers;
+        cursors_[w].end = shard_count_ * (w + 1) / workers;
+    }
+
+    for (size_t w = 1; w < workers; ++w) {
+        workers_.emplace_back(&ParallelRouteEvaluator::workerLoop, this, w);
+    }
+}
+
+ParallelRouteEvaluator::~ParallelRouteEvaluator() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    start_cv_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+RouteEvalResult ParallelRouteEvaluator::evaluate(const std::vector<BookQuote>& quotes) {
+    for (auto& cursor : cursors_) {
+        cursor.next.store(cursor.begin, std::memory_order_relaxed);
+    }
+
+    if (!workers_.empty()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quotes_ = quotes.data();
+        pending_workers_ = workers_.size();
+        ++generation_;
+    } else {
+        quotes_ = quotes.data();
+    }
+    start_cv_.notify_all();
+
+    // The calling thread works as worker 0
+    drain(0);
+
+    if (!workers_.empty()) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this] { return pending_workers_ == 0; });
+    }
+
+    // Reduce per-shard results
+    RouteEvalResult result;
+    for (const auto& best : shard_best_) {
+        result.routes_above_threshold += best.above_threshold;
+        if (best.valid && (!result.valid || best.profit_percent > result.best_profit_percent)) {
+            result.valid = true;
+            result.best_route = best.route;
+            result.best_profit_percent = best.profit_percent;
+        }
+    }
+
+    return result;
+}
+
+void ParallelRouteEvaluator::workerLoop(size_t worker) {
+    uint64_t seen_generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_cv_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+
+        drain(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --pending_workers_;
+        }
+        done_cv_.notify_one();
+    }
+}
+
+void ParallelRouteEvaluator::drain(size_t worker) {
+    size_t workers = cursors_.size();
+
+    for (size_t i = 0; i < workers; ++i) {
+        ShardCursor& cursor = cursors_[(worker + i) % workers];
+        while (true) {
+            size_t shard = cursor.next.fetch_add(1, std::memory_order_relaxed);
+            if (shard >= cursor.end) {
+                break;
+            }
+            evaluateShard(shard);
+        }
+    }
+}
+
+void ParallelRouteEvaluator::evaluateShard(size_t shard) {
+    const BookQuote* quotes = quotes_;
+    double required_ratio = 1.0 + threshold_percent_ / 100.0;
+
+    size_t begin = shard * shard_size_;
+    size_t end = std::min(begin + shard_size_, routes_.size());
+
+    ShardBest best;
+    double best_ratio = 0.0;
+
+    for (size_t r = begin; r < end; ++r) {
+        const IndexedRoute& route = routes_[r];
+        double numerator = 1.0;
+        double denominator = 1.0;
+        bool complete = true;
+
+        for (uint32_t i = 0; i < route.leg_count; ++i) {
+            const auto& leg = route.legs[i];
+            const BookQuote& quote = quotes[leg.book];
+            double price = leg.side == QuoteSide::Bid ? quote.bid_price : quote.ask_price;
+            if (price <= 0.0) {
+                complete = false;
+                break;
+            }
+            if (leg.numerator) {
+                numerator *= price;
+            } else {
+                denominator *= price;
+            }
+        }
+
+        if (!complete) {
+            continue;
+        }
+
+        double ratio = numerator * route.fee_factor / denominator;
+        if (ratio >= required_ratio) {
+            ++best.above_threshold;
+        }
+        if (!best.valid || ratio > best_ratio) {
+            best.valid = true;
+            best.route = route.id;
+            best_ratio = ratio;
+        }
+    }
+
+    best.profit_percent = (best_ratio - 1.0) * 100.0;
+    shard_best_[shard] = best;
+}
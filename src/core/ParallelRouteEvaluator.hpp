@@ -0,0 +1,106 @@
+#pragma once
+
+#include "TriggerIndex.hpp"
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Top-of-book prices for one book, as read by route evaluation
+struct BookQuote {
+    double bid_price = 0.0;
+    double ask_price = 0.0;
+};
+
+// Maximum number of legs in a route direction (multi-leg routes use 4)
+constexpr size_t MAX_ROUTE_LEGS = 4;
+
+// A route direction with legs resolved to book indices
+// Same ratio form as TriggerRoute: fee_factor * product(numerator legs) / product(denominator legs)
+struct IndexedRoute {
+    struct Leg {
+        uint32_t book;
+        QuoteSide side;
+        bool numerator;
+    };
+
+    std::array<Leg, MAX_ROUTE_LEGS> legs;
+    uint32_t leg_count = 0;
+    uint32_t id = 0;  // Caller's route id, reported back in results
+    double fee_factor = 1.0;  // Share of the proceeds left after trading fees
+};
+
+// Result of one evaluation pass
+struct RouteEvalResult {
+    bool valid = false;          // At least one route had complete data
+    uint32_t best_route = 0;     // IndexedRoute::id of the most profitable route
+    double best_profit_percent = 0.0;  // After fees
+    size_t routes_above_threshold = 0;
+};
+
+// Evaluates a large route set across a pool of worker threads
+// Routes are sorted by the books they read and cut into fixed-size shards, so
+// each shard touches a small, mostly contiguous set of quotes. Shards are
+// statically split between workers; a worker that drains its own range steals
+// from the others through their atomic cursors. Each shard writes its best
+// result into its own cache-line slot and the caller reduces them after the pass.
+class ParallelRouteEvaluator {
+public:
+    ParallelRouteEvaluator(std::vector<IndexedRoute> routes, double threshold_percent,
+                           size_t thread_count, size_t shard_size = 256);
+    ~ParallelRouteEvaluator();
+
+    ParallelRouteEvaluator(const ParallelRouteEvaluator&) = delete;
+    ParallelRouteEvaluator& operator=(const ParallelRouteEvaluator&) = delete;
+
+    // Evaluate every route against one consistent set of quotes (indexed by book)
+    // Not reentrant: one pass at a time
+    RouteEvalResult evaluate(const std::vector<BookQuote>& quotes);
+
+    size_t getRouteCount() const { return routes_.size(); }
+    size_t getShardCount() const { return shard_count_; }
+    size_t getThreadCount() const { return cursors_.size(); }
+
+private:
+    struct alignas(64) ShardCursor {
+        std::atomic<size_t> next{0};
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    struct alignas(64) ShardBest {
+        bool valid = false;
+        uint32_t route = 0;
+        double profit_percent = 0.0;
+        size_t above_threshold = 0;
+    };
+
+    std::vector<IndexedRoute> routes_;
+    double threshold_percent_;
+    size_t shard_size_;
+    size_t shard_count_;
+
+    std::vector<ShardCursor> cursors_;  // One per worker; index 0 is the calling thread
+    std::vector<ShardBest> shard_best_;
+    std::vector<std::thread> workers_;
+
+    // Pass hand-off between the caller and the pool
+    std::mutex mutex_;
+    std::condition_variable start_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_;
+    size_t pending_workers_;
+    bool stopping_;
+    const BookQuote* quotes_;
+
+    void workerLoop(size_t worker);
+
+    // Run own shards, then steal from the other workers until all are drained
+    void drain(size_t worker);
+
+    void evaluateShard(size_t shard);
+};
@@ -2,21 +2,22 @@
 #include <cmath>
 #include <limits>
 
-PriceComparator::PriceComparator(MarketState& market_state)
-    : market_state_(market_state) {}
+PriceComparator::PriceComparator(const ArbitrageDetector& detector)
+    : detector_(detector) {}
 
 std::optional<PriceComparison> PriceComparator::compareArbUsdtPrices() const {
     PriceComparison result;
+    auto rates = detector_.getRates();
     
     // Get direct ARB/USDT ask price
-    auto direct_ask_opt = getDirectArbUsdtAsk();
+    auto direct_ask_opt = getDirectArbUsdtAsk(*rates);
     if (!direct_ask_opt.has_value()) {
         return std::nullopt; // Missing direct price
     }
     result.direct_ask = direct_ask_opt.value();
     
     // Calculate implied ARB/USDT price
-    auto implied_ask_opt = calculateImpliedArbUsdt();
+    auto implied_ask_opt = calculateImpliedArbUsdt(*rates);
     if (!implied_ask_opt.has_value()) {
         return std::nullopt; // Missing data for implied calculation
     }
@@ -39,37 +40,24 @@ std::optional<PriceComparison> PriceComparator::compareArbUsdtPrices() const {
     return result;
 }
 
-std::optional<double> PriceComparator::calculateImpliedArbUsdt() const {
-    // Get ARB/BTC snapshot
-    auto arb_btc_snap = market_state_.get("ARB/BTC").snapshot();
-    if (!arb_btc_snap.has_data || !isValidPrice(arb_btc_snap.ask_price)) {
+std::optional<double> PriceComparator::calculateImpliedArbUsdt(const ImpliedRateMatrix& rates) const {
+    // Implied: ask(ARB/BTC) * ask(BTC/USDT), computed once per tick by the matrix
+    auto rate = rates.rate(rates.pathIndex("ARB", "USDT", "BTC"));
+    if (!rate.valid || !isValidPrice(rate.ask)) {
         return std::nullopt;
     }
     
-    // Get BTC/USDT snapshot
-    auto btc_usdt_snap = market_state_.get("BTC/USDT").snapshot();
-    if (!btc_usdt_snap.has_data || !isValidPrice(btc_usdt_snap.ask_price)) {
-        return std::nullopt;
-    }
-    
-    // Calculate implied: ask(ARB/BTC) * ask(BTC/USDT)
-    double implied = arb_btc_snap.ask_price * btc_usdt_snap.ask_price;
-    
-    if (!isValidPrice(implied)) {
-        return std::nullopt;
-    }
-    
-    return implied;
+    return rate.ask;
 }
 
-std::optional<double> PriceComparator::getDirectArbUsdtAsk() const {
-    auto snap = market_state_.get("ARB/USDT").snapshot();
+std::optional<double> PriceComparator::getDirectArbUsdtAsk(const ImpliedRateMatrix& rates) const {
+    auto rate = rates.rate(rates.pathIndex("ARB", "USDT"));
     
-    if (!snap.has_data || !isValidPrice(snap.ask_price)) {
+    if (!rate.valid || !isValidPrice(rate.ask)) {
         return std::nullopt;
     }
     
-    return snap.ask_price;
+    return rate.ask;
 }
 
 bool PriceComparator::isValidPrice(double price) const {
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "MarketState.hpp"
+#include "ArbitrageDetector.hpp"
 #include <string>
 #include <optional>
 
@@ -14,22 +14,23 @@ struct PriceComparison {
         : direct_ask(0.0), implied_ask(0.0), difference_percent(0.0), valid(false) {}
 };
 
+// Reads the detector's implied-rate matrix: no products of its own
 class PriceComparator {
 public:
-    explicit PriceComparator(MarketState& market_state);
+    explicit PriceComparator(const ArbitrageDetector& detector);
     
-    // Calculate implied ARB/USDT price and compare with direct
+    // Compare implied ARB/USDT price with direct
     // Returns optional because calculation may fail if data is missing
     std::optional<PriceComparison> compareArbUsdtPrices() const;
 
 private:
-    MarketState& market_state_;
+    const ArbitrageDetector& detector_;
     
-    // Calculate implied ARB/USDT via ARB/BTC -> BTC/USDT
-    std::optional<double> calculateImpliedArbUsdt() const;
+    // Implied ARB/USDT ask via ARB/BTC -> BTC/USDT
+    std::optional<double> calculateImpliedArbUsdt(const ImpliedRateMatrix& rates) const;
     
-    // Get direct ARB/USDT ask price
-    std::optional<double> getDirectArbUsdtAsk() const;
+    // Direct ARB/USDT ask price
+    std::optional<double> getDirectArbUsdtAsk(const ImpliedRateMatrix& rates) const;
     
     // Validate price is reasonable (not zero, not NaN, not absurdly large)
     bool isValidPrice(double price) const;
@@ -0,0 +1,148 @@
+#include "SharedBookSegment.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+namespace bip = boost::interprocess;
+
+namespace {
+    constexpr int READ_RETRIES = 64;
+    
+    uint64_t alignUp(uint64_t offset) {
+        return (offset + 63) & ~uint64_t(63);
+    }
+}
+
+std::unique_ptr<SharedBookSegment> SharedBookSegment::create(const std::string& name, uint32_t capacity) {
+    try {
+        return std::unique_ptr<SharedBookSegment>(new SharedBookSegment(name, capacity));
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+SharedBookSegment::SharedBookSegment(const std::string& name, uint32_t capacity)
+    : name_(name),
+      capacity_(capacity),
+      header_(nullptr),
+      directory_(nullptr),
+      records_(nullptr) {
+    uint64_t directory_offset = alignUp(sizeof(SharedBookHeader));
+    uint64_t records_offset = alignUp(directory_offset + uint64_t(capacity) * sizeof(SharedBookDirectoryEntry));
+    uint64_t size = records_offset + uint64_t(capacity) * sizeof(SharedBookRecord);
+    
+    // A segment left behind by a crashed engine is replaced, not reused
+    bip::shared_memory_object::remove(name.c_str());
+    shm_ = bip::shared_memory_object(bip::create_only, name.c_str(), bip::read_write);
+    shm_.truncate(static_cast<bip::offset_t>(size));
+    region_ = bip::mapped_region(shm_, bip::read_write);
+    
+    auto* base = static_cast<char*>(region_.get_address());
+    header_ = new (base) SharedBookHeader();
+    directory_ = reinterpret_cast<SharedBookDirectoryEntry*>(base + directory_offset);
+    records_ = reinterpret_cast<SharedBookRecord*>(base + records_offset);
+    std::memset(directory_, 0, uint64_t(capacity) * sizeof(SharedBookDirectoryEntry));
+    for (uint32_t i = 0; i < capacity; ++i) {
+        new (&records_[i]) SharedBookRecord();
+        SharedBookSegment::write(records_[i], 0.0, 0.0, 0.0, 0.0, 0, 0);
+    }
+    
+    header_->symbol_count.store(0, std::memory_order_relaxed);
+    header_->version = SHARED_BOOK_VERSION;
+    header_->record_size = sizeof(SharedBookRecord);
+    header_->capacity = capacity;
+    header_->directory_entry_size = sizeof(SharedBookDirectoryEntry);
+    header_->directory_offset = directory_offset;
+    header_->records_offset = records_offset;
+    header_->created_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    // Readers check the magic: a valid magic means a complete header
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header_->magic, SHARED_BOOK_MAGIC, sizeof(SHARED_BOOK_MAGIC));
+}
+
+SharedBookSegment::~SharedBookSegment() {
+    bip::shared_memory_object::remove(name_.c_str());
+}
+
+std::optional<SharedBookReader> SharedBookReader::open(const std::string& name) {
+    SharedBookReader reader;
+    try {
+        bip::shared_memory_object shm(bip::open_only, name.c_str(), bip::read_only);
+        reader.region_ = std::make_shared<bip::mapped_region>(shm, bip::read_only);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+    
+    const auto* base = static_cast<const char*>(reader.region_->get_address());
+    size_t size = reader.region_->get_size();
+    if (size < sizeof(SharedBookHeader)) {
+        return std::nullopt;
+    }
+    
+    const auto* header = reinterpret_cast<const SharedBookHeader*>(base);
+    if (std::memcmp(header->magic, SHARED_BOOK_MAGIC, sizeof(SHARED_BOOK_MAGIC)) != 0 ||
+        header->version != SHARED_BOOK_VERSION ||
+        header->record_size != sizeof(SharedBookRecord) ||
+        header->directory_entry_size != sizeof(SharedBookDirectoryEntry) ||
+        header->records_offset + uint64_t(header->capacity) * sizeof(SharedBookRecord) > size) {
+        return std::nullopt;
+    }
+    
+    reader.header_ = header;
+    reader.directory_ = reinterpret_cast<const SharedBookDirectoryEntry*>(base + header->directory_offset);
+    reader.records_ = reinterpret_cast<const SharedBookRecord*>(base + header->records_offset);
+    return reader;
+}
+
+uint32_t SharedBookReader::size() const {
+    return std::min(header_->symbol_count.load(std::memory_order_acquire), header_->capacity);
+}
+
+std::string SharedBookReader::symbolName(uint32_t slot) const {
+    if (slot >= size()) {
+        return std::string();
+    }
+    const char* name = directory_[slot].name;
+    return std::string(name, strnlen(name, sizeof(directory_[slot].name)));
+}
+
+std::optional<uint32_t> SharedBookReader::find(const std::string& symbol) const {
+    uint32_t count = size();
+    for (uint32_t slot = 0; slot < count; ++slot) {
+        const char* name = directory_[slot].name;
+        if (strnlen(name, sizeof(directory_[slot].name)) == symbol.size() &&
+            std::memcmp(name, symbol.data(), symbol.size()) == 0) {
+            return slot;
+        }
+    }
+    return std::nullopt;
+}
+
+bool SharedBookReader::read(uint32_t slot, SharedBookQuote& quote) const {
+    if (slot >= size()) {
+        return false;
+    }
+    const SharedBookRecord& record = records_[slot];
+    for (int attempt = 0; attempt < READ_RETRIES; ++attempt) {
+        uint64_t before = record.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue; // Write in progress
+        }
+        SharedBookQuote copy;
+        copy.bid_price = record.bid_price.load(std::memory_order_relaxed);
+        copy.bid_qty = record.bid_qty.load(std::memory_order_relaxed);
+        copy.ask_price = record.ask_price.load(std::memory_order_relaxed);
+        copy.ask_qty = record.ask_qty.load(std::memory_order_relaxed);
+        copy.timestamp_ms = record.timestamp_ms.load(std::memory_order_relaxed);
+        copy.update_count = record.update_count.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (record.sequence.load(std::memory_order_relaxed) == before) {
+            quote = copy;
+            return true;
+        }
+    }
+    return false;
+}
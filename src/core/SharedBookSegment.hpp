@@ -0,0 +1,148 @@
+#pragma once
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+
+// Named shared-memory mirror of the top of book (native layout, same host only)
+//   SharedBookHeader | SharedBookDirectoryEntry[capacity] | SharedBookRecord[capacity]
+// Slot i holds the book of MarketState symbol id i. The engine is the only
+// writer: every OrderBook update is copied into its record under a seqlock
+// (sequence odd while writing, even when stable), so readers in other
+// processes get consistent snapshots with plain loads and no syscalls.
+// On Linux the segment is /dev/shm/<name>.
+constexpr char SHARED_BOOK_MAGIC[8] = {'A', 'R', 'B', 'B', 'O', 'O', 'K', '1'};
+constexpr uint32_t SHARED_BOOK_VERSION = 1;
+
+struct SharedBookHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t capacity;
+    uint32_t directory_entry_size;
+    uint64_t directory_offset;
+    uint64_t records_offset;
+    int64_t created_time_ns;  // Wall clock, epoch ns
+    alignas(64) std::atomic<uint32_t> symbol_count;  // Slots below this may have a directory entry
+};
+
+struct SharedBookDirectoryEntry {
+    char name[32];  // "ARB/USDT", NUL terminated; empty if the slot is unused
+};
+
+// One cache line per book; fields go through relaxed atomics so that a torn
+// read is detected by the sequence check instead of being undefined behavior
+struct alignas(64) SharedBookRecord {
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> update_count;  // OrderBook::Snapshot::version
+    std::atomic<int64_t> timestamp_ms;
+    std::atomic<double> bid_price;
+    std::atomic<double> bid_qty;
+    std::atomic<double> ask_price;
+    std::atomic<double> ask_qty;
+};
+
+static_assert(sizeof(SharedBookRecord) == 64, "SharedBookRecord is one cache line");
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<double>::is_always_lock_free,
+              "Shared-memory fields must be lock-free");
+
+// Stable copy of one record
+struct SharedBookQuote {
+    double bid_price = 0.0;
+    double bid_qty = 0.0;
+    double ask_price = 0.0;
+    double ask_qty = 0.0;
+    int64_t timestamp_ms = 0;
+    uint64_t update_count = 0;  // 0: no data yet
+};
+
+// Engine side: owns the segment, removes its name on destruction
+class SharedBookSegment {
+public:
+    // Create (replace) the named segment; nullptr on failure
+    static std::unique_ptr<SharedBookSegment> create(const std::string& name, uint32_t capacity = 8192);
+    ~SharedBookSegment();
+    
+    SharedBookSegment(const SharedBookSegment&) = delete;
+    SharedBookSegment& operator=(const SharedBookSegment&) = delete;
+    
+    // Publish the directory entry of a slot and return its record;
+    // nullptr if the slot is out of range. Callers are serialized by MarketState
+    SharedBookRecord* attach(uint32_t slot, const std::string& symbol) {
+        if (slot >= capacity_) {
+            return nullptr;
+        }
+        SharedBookDirectoryEntry& entry = directory_[slot];
+        size_t length = std::min(symbol.size(), sizeof(entry.name) - 1);
+        std::memcpy(entry.name, symbol.data(), length);
+        entry.name[length] = '\0';
+        
+        // The count only grows; entries below it are written once
+        if (slot >= header_->symbol_count.load(std::memory_order_relaxed)) {
+            header_->symbol_count.store(slot + 1, std::memory_order_release);
+        }
+        return &records_[slot];
+    }
+    
+    // Single writer per record
+    static void write(SharedBookRecord& record, double bid_price, double bid_qty, double ask_price, double ask_qty,
+                      int64_t timestamp_ms, uint64_t update_count) {
+        uint64_t sequence = record.sequence.load(std::memory_order_relaxed);
+        record.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        record.bid_price.store(bid_price, std::memory_order_relaxed);
+        record.bid_qty.store(bid_qty, std::memory_order_relaxed);
+        record.ask_price.store(ask_price, std::memory_order_relaxed);
+        record.ask_qty.store(ask_qty, std::memory_order_relaxed);
+        record.timestamp_ms.store(timestamp_ms, std::memory_order_relaxed);
+        record.update_count.store(update_count, std::memory_order_relaxed);
+        record.sequence.store(sequence + 2, std::memory_order_release);
+    }
+    
+    const std::string& getName() const { return name_; }
+    uint32_t getCapacity() const { return capacity_; }
+
+private:
+    SharedBookSegment(const std::string& name, uint32_t capacity);
+    
+    std::string name_;
+    uint32_t capacity_;
+    boost::interprocess::shared_memory_object shm_;
+    boost::interprocess::mapped_region region_;
+    SharedBookHeader* header_;
+    SharedBookDirectoryEntry* directory_;
+    SharedBookRecord* records_;
+};
+
+// Reader side, for any process on the host
+class SharedBookReader {
+public:
+    static std::optional<SharedBookReader> open(const std::string& name);
+    
+    // Slots currently published; grows while the engine discovers symbols
+    uint32_t size() const;
+    
+    // Empty for unused slots
+    std::string symbolName(uint32_t slot) const;
+    
+    // Slot of a symbol, by directory scan
+    std::optional<uint32_t> find(const std::string& symbol) const;
+    
+    // Consistent copy of a record; false if out of range or the writer kept
+    // it busy for every retry
+    bool read(uint32_t slot, SharedBookQuote& quote) const;
+
+private:
+    SharedBookReader() = default;
+    
+    std::shared_ptr<boost::interprocess::mapped_region> region_;
+    const SharedBookHeader* header_ = nullptr;
+    const SharedBookDirectoryEntry* directory_ = nullptr;
+    const SharedBookRecord* records_ = nullptr;
+};
@@ -0,0 +1,204 @@
+#include "TriggerIndex.hpp"
+#include <algorithm>
+
+TriggerIndex::TriggerIndex(std::vector<TriggerRoute> routes, double threshold_percent)
+    : update_epoch_(0),
+      rebuild_count_(0) {
+    // Shave a tiny relative margin off the required ratio so floating point
+    // rounding errs on the side of running the full check
+    constexpr double ROUNDING_MARGIN = 1e-9;
+    double required_ratio = (1.0 + threshold_percent / 100.0) * (1.0 - ROUNDING_MARGIN);
+
+    routes_.reserve(routes.size());
+    required_ratios_.reserve(routes.size());
+    route_ids_.reserve(routes.size());
+    size_t id_count = 0;
+    for (size_t r = 0; r < routes.size(); ++r) {
+        std::vector<Leg> legs;
+        legs.reserve(routes[r].legs.size());
+
+        for (const auto& leg : routes[r].legs) {
+            auto it = symbol_index_.find(leg.symbol);
+            size_t symbol;
+            if (it == symbol_index_.end()) {
+                symbol = symbols_.size();
+                symbol_index_.emplace(leg.symbol, symbol);
+                symbols_.emplace_back();
+            } else {
+                symbol = it->second;
+            }
+            legs.push_back({symbol, leg.side, leg.numerator});
+        }
+
+        routes_.push_back(std::move(legs));
+        required_ratios_.push_back(routes[r].fee_factor > 0.0 ? required_ratio / routes[r].fee_factor : required_ratio);
+        route_ids_.push_back(routes[r].id);
+        id_count = std::max(id_count, routes[r].id + 1);
+    }
+    crossed_.reserve(id_count);
+    id_marks_.assign(id_count, 0);
+
+    // Wire up route membership and neighbor lists, and size the trigger
+    // arrays up front so rebuilds never allocate
+    for (size_t r = 0; r < routes_.size(); ++r) {
+        for (const auto& leg : routes_[r]) {
+            auto& entry = symbols_[leg.symbol];
+            auto& triggers = leg.side == QuoteSide::Bid
+                ? (leg.numerator ? entry.bid_rise : entry.bid_fall)
+                : (leg.numerator ? entry.ask_rise : entry.ask_fall);
+            triggers.reserve(triggers.capacity() + 1);
+            if (entry.routes.empty() || entry.routes.back() != r) {
+                entry.routes.push_back(r);
+            }
+            for (const auto& other : routes_[r]) {
+                if (other.symbol != leg.symbol &&
+                    std::find(entry.neighbors.begin(), entry.neighbors.end(), other.symbol) == entry.neighbors.end()) {
+                    entry.neighbors.push_back(other.symbol);
+                }
+            }
+        }
+    }
+}
+
+bool TriggerIndex::update(const std::string& symbol, double bid_price, double ask_price) {
+    auto it = symbol_index_.find(symbol);
+    if (it == symbol_index_.end()) {
+        return false; // Symbol is not part of any route
+    }
+
+    SymbolEntry& entry = symbols_[it->second];
+
+    if (bid_price <= 0.0 || ask_price <= 0.0) {
+        bid_price = 0.0;
+        ask_price = 0.0;
+    }
+
+    bool changed = entry.bid_price != bid_price || entry.ask_price != ask_price;
+    entry.bid_price = bid_price;
+    entry.ask_price = ask_price;
+
+    // Our own triggers only depend on the other legs, so they are still exact
+    // unless one of those moved since the last rebuild
+    if (entry.dirty) {
+        rebuild(it->second);
+    }
+
+    crossed_.clear();
+    ++update_epoch_;
+    if (bid_price > 0.0) {
+        collectRise(entry.bid_rise, bid_price);
+        collectFall(entry.bid_fall, bid_price);
+        collectRise(entry.ask_rise, ask_price);
+        collectFall(entry.ask_fall, ask_price);
+    }
+
+    // Every trigger that used this price is now stale
+    if (changed) {
+        for (size_t neighbor : entry.neighbors) {
+            symbols_[neighbor].dirty = true;
+        }
+    }
+
+    return !crossed_.empty();
+}
+
+void TriggerIndex::collectRise(const std::vector<Trigger>& triggers, double price) {
+    // Ascending: every trigger up to the first one above price is crossed
+    for (const Trigger& trigger : triggers) {
+        if (price < trigger.price) {
+            break;
+        }
+        report(trigger.route);
+    }
+}
+
+void TriggerIndex::collectFall(const std::vector<Trigger>& triggers, double price) {
+    for (auto it = triggers.rbegin(); it != triggers.rend(); ++it) {
+        if (price > it->price) {
+            break;
+        }
+        report(it->route);
+    }
+}
+
+void TriggerIndex::report(size_t route) {
+    // Both directions of a caller route may cross on the same update
+    size_t id = route_ids_[route];
+    if (id_marks_[id] != update_epoch_) {
+        id_marks_[id] = update_epoch_;
+        crossed_.push_back(id);
+    }
+}
+
+void TriggerIndex::rebuild(size_t symbol) {
+    SymbolEntry& entry = symbols_[symbol];
+    entry.bid_rise.clear();
+    entry.bid_fall.clear();
+    entry.ask_rise.clear();
+    entry.ask_fall.clear();
+
+    for (size_t r : entry.routes) {
+        const auto& legs = routes_[r];
+        for (size_t i = 0; i < legs.size(); ++i) {
+            const Leg& leg = legs[i];
+            if (leg.symbol != symbol) {
+                continue;
+            }
+
+            double numerator = 1.0;
+            double denominator = 1.0;
+            if (!partialRatio(r, i, numerator, denominator)) {
+                continue; // Missing co-leg data: this leg can never cross
+            }
+
+            double required_ratio = required_ratios_[r];
+            bool is_bid = leg.side == QuoteSide::Bid;
+            if (leg.numerator) {
+                // price * N / D >= k  <=>  price >= k * D / N
+                double trigger = required_ratio * denominator / numerator;
+                (is_bid ? entry.bid_rise : entry.ask_rise).push_back({trigger, r});
+            } else {
+                // N / (price * D) >= k  <=>  price <= N / (k * D)
+                double trigger = numerator / (required_ratio * denominator);
+                (is_bid ? entry.bid_fall : entry.ask_fall).push_back({trigger, r});
+            }
+        }
+    }
+
+    auto by_price = [](const Trigger& a, const Trigger& b) { return a.price < b.price; };
+    std::sort(entry.bid_rise.begin(), entry.bid_rise.end(), by_price);
+    std::sort(entry.bid_fall.begin(), entry.bid_fall.end(), by_price);
+    std::sort(entry.ask_rise.begin(), entry.ask_rise.end(), by_price);
+    std::sort(entry.ask_fall.begin(), entry.ask_fall.end(), by_price);
+
+    entry.dirty = false;
+    ++rebuild_count_;
+}
+
+bool TriggerIndex::partialRatio(size_t route, size_t skip_leg, double& numerator, double& denominator) const {
+    const auto& legs = routes_[route];
+    numerator = 1.0;
+    denominator = 1.0;
+
+    for (size_t i = 0; i < legs.size(); ++i) {
+        if (i == skip_leg) {
+            continue;
+        }
+        double price = legPrice(legs[i]);
+        if (price <= 0.0) {
+            return false;
+        }
+        if (legs[i].numerator) {
+            numerator *= price;
+        } else {
+            denominator *= price;
+        }
+    }
+
+    return true;
+}
+
+double TriggerIndex::legPrice(const Leg& leg) const {
+    const SymbolEntry& entry = symbols_[leg.symbol];
+    return leg.side == QuoteSide::Bid ? entry.bid_price : entry.ask_price;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+// Which side of the book a route leg is priced against
+enum class QuoteSide {
+    Bid,  // We sell into the bid
+    Ask   // We buy from the ask
+};
+
+// One leg of a route direction
+struct TriggerLeg {
+    std::string symbol;
+    QuoteSide side;
+    bool numerator;  // true: price multiplies the route ratio, false: divides it
+};
+
+// A single route direction, profitable when
+// fee_factor * product(numerator legs) / product(denominator legs) >= 1 + threshold_percent / 100
+struct TriggerRoute {
+    std::vector<TriggerLeg> legs;
+    double fee_factor = 1.0;  // Share of the proceeds left after trading fees
+    size_t id = 0;            // Caller's route id, reported by crossedRoutes()
+};
+
+// Inverse trigger-price index
+// For every leg of every route it keeps the price at which that leg would push
+// the route across the threshold, given the current prices of the other legs.
+// A book update then only compares the new bid/ask against the symbol's sorted
+// trigger arrays; triggers are rebuilt lazily once another leg has moved.
+// Not thread-safe: callers serialize access.
+class TriggerIndex {
+public:
+    TriggerIndex(std::vector<TriggerRoute> routes, double threshold_percent);
+
+    // Apply new top-of-book for a symbol (non-positive prices mean "no data")
+    // Returns true if any route containing the symbol is at or above the threshold
+    bool update(const std::string& symbol, double bid_price, double ask_price);
+
+    // TriggerRoute::id of every route the last update() found at or above the
+    // threshold, each id once; valid until the next update()
+    const std::vector<size_t>& crossedRoutes() const { return crossed_; }
+
+    // Number of trigger rebuilds performed (for diagnostics)
+    size_t getRebuildCount() const { return rebuild_count_; }
+
+private:
+    struct Leg {
+        size_t symbol;
+        QuoteSide side;
+        bool numerator;
+    };
+
+    struct Trigger {
+        double price;
+        size_t route;  // Index into routes_
+    };
+
+    struct SymbolEntry {
+        double bid_price = 0.0;
+        double ask_price = 0.0;
+        bool dirty = true;  // A co-leg moved since the triggers were built
+
+        std::vector<size_t> routes;     // Routes with at least one leg on this symbol
+        std::vector<size_t> neighbors;  // Other symbols sharing a route with this one
+
+        // Sorted ascending; rise triggers cross when price >= trigger,
+        // fall triggers cross when price <= trigger
+        std::vector<Trigger> bid_rise;
+        std::vector<Trigger> bid_fall;
+        std::vector<Trigger> ask_rise;
+        std::vector<Trigger> ask_fall;
+    };
+
+    std::vector<std::vector<Leg>> routes_;
+    std::vector<double> required_ratios_;  // Per route, fees folded in
+    std::vector<size_t> route_ids_;        // Per route, TriggerRoute::id
+
+    // Result of the last update; sized up front so update() never allocates
+    std::vector<size_t> crossed_;
+    std::vector<uint64_t> id_marks_;  // Per id, update_epoch_ when last reported
+    uint64_t update_epoch_;
+    std::vector<SymbolEntry> symbols_;
+    std::unordered_map<std::string, size_t> symbol_index_;
+    size_t rebuild_count_;
+
+    // Recompute all triggers that live on this symbol from current co-leg prices
+    void rebuild(size_t symbol);
+
+    // Product of leg prices for a route, skipping one leg; returns false if any price is missing
+    bool partialRatio(size_t route, size_t skip_leg, double& numerator, double& denominator) const;
+
+    double legPrice(const Leg& leg) const;
+
+    // Report the routes of every trigger crossed by price
+    void collectRise(const std::vector<Trigger>& triggers, double price);
+    void collectFall(const std::vector<Trigger>& triggers, double price);
+    void report(size_t route);
+};
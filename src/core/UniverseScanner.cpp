@@ -0,0 +1,163 @@
+#include "UniverseScanner.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+
+constexpr uint32_t NO_BOOK = UINT32_MAX;
+
+// Book trading from against to, either way round (as ImpliedRateMatrix::findLink)
+uint32_t findBook(const std::unordered_map<std::string, uint32_t>& book_index,
+                  const std::string& from, const std::string& to, bool& inverted) {
+    auto it = book_index.find(from + "/" + to);
+    if (it != book_index.end()) {
+        inverted = false;
+        return it->second;
+    }
+    it = book_index.find(to + "/" + from);
+    if (it != book_index.end()) {
+        inverted = true;
+        return it->second;
+    }
+    return NO_BOOK;
+}
+
+// An inverted book prices the same conversion as 1 / price on the opposite side
+IndexedRoute::Leg routeLeg(uint32_t book, QuoteSide side, bool numerator, bool inverted) {
+    if (inverted) {
+        side = side == QuoteSide::Bid ? QuoteSide::Ask : QuoteSide::Bid;
+        numerator = !numerator;
+    }
+    return {book, side, numerator};
+}
+
+} // namespace
+
+UniverseScanner::UniverseScanner(MarketState& market_state, const SymbolUniverse& universe,
+                                 const std::string& anchor, double threshold_percent, double fee_percent,
+                                 size_t thread_count)
+    : symbols_(universe.getSymbols()),
+      threshold_percent_(threshold_percent) {
+    books_.reserve(symbols_.size());
+    for (const auto& info : symbols_) {
+        books_.push_back(&market_state.get(info.pair()));
+        symbol_ids_.push_back(market_state.getSymbolId(info.pair()));
+    }
+    snapshots_.resize(books_.size());
+    quotes_.resize(books_.size());
+
+    // Index books by pair name for triangle discovery
+    std::unordered_map<std::string, uint32_t> book_index;
+    for (uint32_t i = 0; i < symbols_.size(); ++i) {
+        book_index.emplace(symbols_[i].pair(), i);
+    }
+
+    double fee_factor = std::pow(1.0 - fee_percent / 100.0, 3);
+    std::vector<IndexedRoute> routes;
+    for (uint32_t cross = 0; cross < symbols_.size(); ++cross) {
+        const SymbolInfo& info = symbols_[cross];
+        if (info.quote == anchor || info.base == anchor) {
+            continue;
+        }
+
+        bool direct_inverted = false;
+        bool quote_inverted = false;
+        uint32_t direct = findBook(book_index, info.base, anchor, direct_inverted);
+        uint32_t quote_anchor = findBook(book_index, info.quote, anchor, quote_inverted);
+        if (direct == NO_BOOK || quote_anchor == NO_BOOK) {
+            continue;
+        }
+
+        // Direction 1: bid(A/USDT) / (ask(A/Q) * ask(Q/USDT))
+        IndexedRoute dir1;
+        dir1.legs[0] = routeLeg(direct, QuoteSide::Bid, true, direct_inverted);
+        dir1.legs[1] = {cross, QuoteSide::Ask, false};
+        dir1.legs[2] = routeLeg(quote_anchor, QuoteSide::Ask, false, quote_inverted);
+        dir1.leg_count = 3;
+        dir1.id = static_cast<uint32_t>(triangles_.size());
+        dir1.fee_factor = fee_factor;
+        triangles_.push_back({direct, cross, quote_anchor, 1, direct_inverted, quote_inverted});
+        routes.push_back(dir1);
+
+        // Direction 2: bid(A/Q) * bid(Q/USDT) / ask(A/USDT)
+        IndexedRoute dir2;
+        dir2.legs[0] = {cross, QuoteSide::Bid, true};
+        dir2.legs[1] = routeLeg(quote_anchor, QuoteSide::Bid, true, quote_inverted);
+        dir2.legs[2] = routeLeg(direct, QuoteSide::Ask, false, direct_inverted);
+        dir2.leg_count = 3;
+        dir2.id = static_cast<uint32_t>(triangles_.size());
+        dir2.fee_factor = fee_factor;
+        triangles_.push_back({direct, cross, quote_anchor, 2, direct_inverted, quote_inverted});
+        routes.push_back(dir2);
+    }
+
+    evaluator_ = std::make_unique<ParallelRouteEvaluator>(std::move(routes), threshold_percent, thread_count);
+}
+
+std::optional<ArbitrageOpportunity> UniverseScanner::scan() {
+    for (size_t i = 0; i < books_.size(); ++i) {
+        snapshots_[i] = books_[i]->snapshot();
+        const auto& snap = snapshots_[i];
+
+        // Missing or crossed books are treated as "no data"
+        bool usable = snap.has_data && snap.bid_price > 0.0 && snap.bid_price <= snap.ask_price;
+        quotes_[i].bid_price = usable ? snap.bid_price : 0.0;
+        quotes_[i].ask_price = usable ? snap.ask_price : 0.0;
+    }
+
+    RouteEvalResult result = evaluator_->evaluate(quotes_);
+    if (!result.valid || result.best_profit_percent < threshold_percent_) {
+        return std::nullopt;
+    }
+
+    return buildOpportunity(result.best_route, result.best_profit_percent);
+}
+
+ArbitrageOpportunity UniverseScanner::buildOpportunity(uint32_t route_id, double profit_percent) const {
+    const Triangle& triangle = triangles_[route_id];
+    const auto& direct = snapshots_[triangle.direct];
+    const auto& cross = snapshots_[triangle.cross];
+    const auto& quote_anchor = snapshots_[triangle.quote_anchor];
+    // Lot size of a pair with A as its base
+    const SymbolInfo& lot_info = symbols_[triangle.direct_inverted ? triangle.cross : triangle.direct];
+
+    // Max tradable in base asset units, same step logic as ArbitrageDetector
+    // An inverted book's quantity is in USDT: the other asset's side is qty * price
+    double max_tradable = 0.0;
+    if (triangle.direction == 1) {
+        // Buy A/Q -> Buy Q/USDT -> Sell A/USDT
+        double quote_qty = triangle.quote_inverted ? quote_anchor.bid_qty * quote_anchor.bid_price : quote_anchor.ask_qty;
+        double direct_qty = triangle.direct_inverted ? direct.ask_qty * direct.ask_price : direct.bid_qty;
+        max_tradable = std::min({cross.ask_qty, quote_qty / cross.ask_price, direct_qty});
+    } else {
+        // Buy A/USDT -> Sell A/Q -> Sell Q/USDT
+        double direct_qty = triangle.direct_inverted ? direct.bid_qty * direct.bid_price : direct.ask_qty;
+        double quote_qty = triangle.quote_inverted ? quote_anchor.ask_qty * quote_anchor.ask_price : quote_anchor.bid_qty;
+        max_tradable = std::min({direct_qty, cross.bid_qty, quote_qty / cross.bid_price});
+    }
+
+    // Round down to the exchange lot size
+    if (lot_info.step_size > 0.0) {
+        max_tradable = std::floor(max_tradable / lot_info.step_size) * lot_info.step_size;
+    }
+
+    // Same leg layout as an ARB cross-pair route: A/Q, Q/USDT, A/USDT (as listed)
+    ArbitrageOpportunity opp;
+    opp.route_id = route_id;
+    opp.source = OpportunitySource::UniverseScan;
+    opp.kind = RouteKind::CrossPair;
+    opp.direction = triangle.direction;
+    opp.legs = {symbol_ids_[triangle.cross], symbol_ids_[triangle.quote_anchor], symbol_ids_[triangle.direct]};
+    opp.profit_percent = profit_percent;
+    opp.arb_usdt_bid = direct.bid_price;
+    opp.arb_usdt_ask = direct.ask_price;
+    opp.arb_other_bid = cross.bid_price;
+    opp.arb_other_ask = cross.ask_price;
+    opp.other_usdt_bid = quote_anchor.bid_price;
+    opp.other_usdt_ask = quote_anchor.ask_price;
+    opp.max_tradable_amount = max_tradable;
+    opp.valid = true;
+
+    return opp;
+}
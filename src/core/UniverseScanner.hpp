@@ -0,0 +1,52 @@
+#pragma once
+
+#include "MarketState.hpp"
+#include "ArbitrageDetector.hpp"
+#include "ParallelRouteEvaluator.hpp"
+#include "src/config/ExchangeInfo.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Triangular routes across a loaded symbol universe
+// For every asset A traded against the anchor (A/USDT) and against another
+// quote Q that itself trades against the anchor (A/Q, Q/USDT), both directions
+// of A/Q -> Q/USDT vs A/USDT are evaluated with a ParallelRouteEvaluator.
+// Anchor legs listed the other way round (USDT/Q, USDT/A) are traded on the
+// opposite side, as ImpliedRateMatrix links them.
+class UniverseScanner {
+public:
+    // fee_percent is charged on each of the three trades, as in DetectorConfig
+    UniverseScanner(MarketState& market_state, const SymbolUniverse& universe,
+                    const std::string& anchor, double threshold_percent, double fee_percent, size_t thread_count);
+
+    // Snapshot every book once, evaluate all triangles, return the best one above threshold after fees
+    // Opportunities carry OpportunitySource::UniverseScan and a route_id into this scanner's triangles
+    std::optional<ArbitrageOpportunity> scan();
+
+    size_t getRouteCount() const { return triangles_.size(); }
+    size_t getBookCount() const { return books_.size(); }
+
+private:
+    struct Triangle {
+        uint32_t direct;        // A/USDT, or USDT/A when direct_inverted
+        uint32_t cross;         // A/Q
+        uint32_t quote_anchor;  // Q/USDT, or USDT/Q when quote_inverted
+        int direction;          // 1: buy A/Q, buy Q/USDT, sell A/USDT; 2: reverse
+        bool direct_inverted;
+        bool quote_inverted;
+    };
+
+    std::vector<SymbolInfo> symbols_;       // Indexed by book
+    std::vector<OrderBook*> books_;         // Resolved once; MarketState never moves books
+    std::vector<SymbolId> symbol_ids_;      // MarketState ids, for opportunity legs
+    std::vector<Triangle> triangles_;       // Indexed by route id
+    std::vector<OrderBook::Snapshot> snapshots_;
+    std::vector<BookQuote> quotes_;
+    double threshold_percent_;
+    std::unique_ptr<ParallelRouteEvaluator> evaluator_;
+
+    ArbitrageOpportunity buildOpportunity(uint32_t route_id, double profit_percent) const;
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+// Market-data gateway wire format (little endian, native doubles)
+// Server -> client: a stream of fixed-size frames; every frame starts with
+// its total length and type so clients can skip types they do not know.
+// A symbol is announced once per connection before its first quote.
+// Client -> server: text lines
+//   SUB ARB/USDT,BTC/USDT    add symbols (SUB * for every symbol)
+//   UNSUB ARB/USDT           remove symbols (UNSUB * for all)
+constexpr uint8_t GATEWAY_FRAME_SYMBOL = 1;
+constexpr uint8_t GATEWAY_FRAME_QUOTE = 2;
+
+// Quote flag: earlier updates of this symbol were conflated away for this client
+constexpr uint8_t GATEWAY_QUOTE_CONFLATED = 0x01;
+
+struct GatewaySymbolFrame {
+    uint16_t length;   // sizeof(GatewaySymbolFrame)
+    uint8_t type;      // GATEWAY_FRAME_SYMBOL
+    uint8_t reserved;
+    uint32_t symbol_id;
+    char name[24];     // "ARB/USDT", NUL terminated
+};
+
+struct GatewayQuoteFrame {
+    uint16_t length;   // sizeof(GatewayQuoteFrame)
+    uint8_t type;      // GATEWAY_FRAME_QUOTE
+    uint8_t flags;     // GATEWAY_QUOTE_*
+    uint32_t symbol_id;
+    uint64_t update_id;        // Exchange update id ("u")
+    int64_t receive_time_ns;   // Engine wall clock at frame receive, epoch ns
+    double bid_price;
+    double bid_qty;
+    double ask_price;
+    double ask_qty;
+};
+
+static_assert(sizeof(GatewaySymbolFrame) == 32, "GatewaySymbolFrame layout is part of the wire format");
+static_assert(sizeof(GatewayQuoteFrame) == 56, "GatewayQuoteFrame layout is part of the wire format");
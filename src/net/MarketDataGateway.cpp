@@ -0,0 +1,458 @@
+#include "MarketDataGateway.hpp"
+#include "../util/JsonParser.hpp"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <unordered_set>
+#include <utility>
+
+namespace {
+    constexpr size_t MAX_COMMAND_BYTES = 64 * 1024;
+    constexpr int SLOT_READ_RETRIES = 64;
+    
+    // Gateway thread is the only writer of its counters
+    void bump(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+    
+    void configureSocket(boost::asio::ip::tcp::socket& socket) {
+        boost::system::error_code ec;
+        socket.set_option(boost::asio::ip::tcp::no_delay(true), ec);
+    }
+    
+    template <typename Socket>
+    void configureSocket(Socket&) {}
+    
+    std::string trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos) {
+            return std::string();
+        }
+        size_t end = text.find_last_not_of(" \t\r\n");
+        return text.substr(begin, end - begin + 1);
+    }
+}
+
+// One subscriber connection; lives on the gateway thread
+class MarketDataGateway::Client : public std::enable_shared_from_this<MarketDataGateway::Client> {
+public:
+    explicit Client(MarketDataGateway& gateway) : gateway_(gateway) {}
+    virtual ~Client() = default;
+    
+    virtual void start() = 0;
+    virtual void close() = 0;
+    
+    bool wants(const std::string& symbol) const {
+        return all_ || symbols_.count(symbol) > 0;
+    }
+    
+    // A newer quote of symbol_id is available
+    void markPending(SymbolId symbol_id) {
+        if (symbol_id >= pending_flags_.size()) {
+            pending_flags_.resize(symbol_id + 1, 0);
+            announced_.resize(symbol_id + 1, 0);
+            conflated_.resize(symbol_id + 1, 0);
+        }
+        if (pending_flags_[symbol_id]) {
+            conflated_[symbol_id] = 1; // Still unsent: the older quote is replaced
+            bump(gateway_.quotes_conflated_);
+            return;
+        }
+        pending_flags_[symbol_id] = 1;
+        pending_.push_back(symbol_id);
+    }
+    
+    // Encode every pending symbol into one batch and write it, unless a write is in flight
+    void flush() {
+        if (writing_ || closed_ || pending_.empty()) {
+            return;
+        }
+        buffer_.clear();
+        for (SymbolId symbol_id : pending_) {
+            const SymbolState& state = gateway_.symbols_[symbol_id];
+            if (!announced_[symbol_id]) {
+                append(&state.announcement, sizeof(state.announcement));
+                announced_[symbol_id] = 1;
+            }
+            GatewayQuoteFrame quote = state.quote;
+            quote.flags = conflated_[symbol_id] ? GATEWAY_QUOTE_CONFLATED : 0;
+            append(&quote, sizeof(quote));
+            pending_flags_[symbol_id] = 0;
+            conflated_[symbol_id] = 0;
+        }
+        bump(gateway_.quotes_sent_, pending_.size());
+        pending_.clear();
+        writing_ = true;
+        write();
+    }
+
+protected:
+    // Apply one SUB/UNSUB line
+    void onCommand(const std::string& line) {
+        std::string text = trim(line);
+        size_t space = text.find(' ');
+        std::string verb = text.substr(0, space);
+        std::string list = space == std::string::npos ? std::string() : text.substr(space + 1);
+        bool subscribe = verb == "SUB";
+        if (!subscribe && verb != "UNSUB") {
+            return;
+        }
+        
+        std::istringstream iss(list);
+        std::string symbol;
+        while (std::getline(iss, symbol, ',')) {
+            symbol = trim(symbol);
+            if (symbol == "*") {
+                all_ = subscribe;
+                if (!subscribe) {
+                    symbols_.clear();
+                }
+            } else if (!symbol.empty()) {
+                if (subscribe) {
+                    symbols_.insert(symbol);
+                } else {
+                    symbols_.erase(symbol);
+                }
+            }
+        }
+        gateway_.updateSubscriptions(shared_from_this());
+    }
+    
+    void onWritten(const boost::system::error_code& ec, size_t bytes) {
+        writing_ = false;
+        if (ec) {
+            gateway_.removeClient(shared_from_this());
+            return;
+        }
+        bump(gateway_.bytes_sent_, bytes);
+        flush(); // Whatever became pending while writing
+    }
+    
+    virtual void write() = 0;
+    
+    MarketDataGateway& gateway_;
+    std::vector<char> buffer_;
+    bool closed_ = false;
+
+private:
+    void append(const void* data, size_t bytes) {
+        const char* begin = static_cast<const char*>(data);
+        buffer_.insert(buffer_.end(), begin, begin + bytes);
+    }
+    
+    bool all_ = false;
+    std::unordered_set<std::string> symbols_;
+    bool writing_ = false;
+    std::vector<SymbolId> pending_;
+    std::vector<uint8_t> pending_flags_;  // Indexed by SymbolId
+    std::vector<uint8_t> announced_;
+    std::vector<uint8_t> conflated_;
+};
+
+template <typename Protocol>
+class MarketDataGateway::SocketClient : public MarketDataGateway::Client {
+public:
+    SocketClient(MarketDataGateway& gateway, typename Protocol::socket socket)
+        : Client(gateway), socket_(std::move(socket)), input_(MAX_COMMAND_BYTES) {}
+    
+    void start() override {
+        read();
+    }
+    
+    void close() override {
+        closed_ = true;
+        boost::system::error_code ec;
+        socket_.close(ec);
+    }
+
+protected:
+    void write() override {
+        auto self = shared_from_this();
+        boost::asio::async_write(socket_, boost::asio::buffer(buffer_),
+                                 [this, self](const boost::system::error_code& ec, size_t bytes) {
+            onWritten(ec, bytes);
+        });
+    }
+
+private:
+    void read() {
+        auto self = shared_from_this();
+        boost::asio::async_read_until(socket_, input_, '\n',
+                                      [this, self](const boost::system::error_code& ec, size_t bytes) {
+            if (ec) {
+                gateway_.removeClient(self);
+                return;
+            }
+            auto begin = boost::asio::buffers_begin(input_.data());
+            std::string line(begin, begin + static_cast<std::ptrdiff_t>(bytes));
+            input_.consume(bytes);
+            onCommand(line);
+            if (!closed_) {
+                read();
+            }
+        });
+    }
+    
+    typename Protocol::socket socket_;
+    boost::asio::streambuf input_;
+};
+
+std::unique_ptr<MarketDataGateway> MarketDataGateway::create(const MarketState& market_state, GatewayConfig config) {
+    try {
+        std::unique_ptr<MarketDataGateway> gateway(new MarketDataGateway(market_state, std::move(config)));
+        bool listening = gateway->tcp_acceptor_ != nullptr;
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        listening = listening || gateway->unix_acceptor_ != nullptr;
+#endif
+        return listening ? std::move(gateway) : nullptr;
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+MarketDataGateway::MarketDataGateway(const MarketState& market_state, GatewayConfig config)
+    : market_state_(market_state),
+      config_(std::move(config)),
+      slots_(new QuoteSlot[config_.max_symbols]),
+      changed_(config_.max_symbols),
+      flush_timer_(io_),
+      running_(false),
+      accepted_(0),
+      client_count_(0),
+      quotes_sent_(0),
+      quotes_conflated_(0),
+      bytes_sent_(0) {
+    using boost::asio::ip::tcp;
+    if (config_.tcp_port != 0) {
+        tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), config_.tcp_port);
+        tcp_acceptor_ = std::make_unique<tcp::acceptor>(io_, endpoint, true);
+    }
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    if (!config_.unix_path.empty()) {
+        std::error_code ignored;
+        std::filesystem::remove(config_.unix_path, ignored);  // Stale socket of a previous run
+        using local = boost::asio::local::stream_protocol;
+        unix_acceptor_ = std::make_unique<local::acceptor>(io_, local::endpoint(config_.unix_path));
+    }
+#endif
+}
+
+MarketDataGateway::~MarketDataGateway() {
+    stop();
+}
+
+void MarketDataGateway::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    if (tcp_acceptor_) {
+        accept(*tcp_acceptor_);
+    }
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    if (unix_acceptor_) {
+        accept(*unix_acceptor_);
+    }
+#endif
+    scheduleFlush();
+    thread_ = std::thread([this]() { io_.run(); });
+}
+
+void MarketDataGateway::stop() {
+    running_ = false;
+    io_.stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    
+    // The gateway thread is gone: close everything from here
+    for (auto& client : clients_) {
+        client->close();
+    }
+    clients_.clear();
+    symbols_.clear();
+    boost::system::error_code ec;
+    if (tcp_acceptor_) {
+        tcp_acceptor_->close(ec);
+    }
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    if (unix_acceptor_ && unix_acceptor_->is_open()) {
+        unix_acceptor_->close(ec);
+        std::error_code ignored;
+        std::filesystem::remove(config_.unix_path, ignored);
+    }
+#endif
+    client_count_.store(0, std::memory_order_relaxed);
+}
+
+GatewayStats MarketDataGateway::getStats() const {
+    GatewayStats stats;
+    stats.clients = client_count_.load(std::memory_order_relaxed);
+    stats.accepted = accepted_.load(std::memory_order_relaxed);
+    stats.quotes_sent = quotes_sent_.load(std::memory_order_relaxed);
+    stats.quotes_conflated = quotes_conflated_.load(std::memory_order_relaxed);
+    stats.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+    stats.queued = changed_.size();
+    return stats;
+}
+
+void MarketDataGateway::publish(SymbolId symbol_id, const BookTickerData& data, int64_t receive_time_ns) {
+    if (symbol_id >= config_.max_symbols) {
+        return;
+    }
+    QuoteSlot& slot = slots_[symbol_id];
+    uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.update_id.store(data.update_id, std::memory_order_relaxed);
+    slot.receive_time_ns.store(receive_time_ns, std::memory_order_relaxed);
+    slot.bid_price.store(data.bid_price, std::memory_order_relaxed);
+    slot.bid_qty.store(data.bid_qty, std::memory_order_relaxed);
+    slot.ask_price.store(data.ask_price, std::memory_order_relaxed);
+    slot.ask_qty.store(data.ask_qty, std::memory_order_relaxed);
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    
+    // Queue the symbol once until the gateway thread takes it; the queue holds
+    // at most one entry per symbol, so it cannot overflow
+    if (!slot.dirty.exchange(true, std::memory_order_acq_rel)) {
+        changed_.tryPush(symbol_id);
+    }
+}
+
+bool MarketDataGateway::readSlot(SymbolId symbol_id, GatewayQuoteFrame& quote) const {
+    const QuoteSlot& slot = slots_[symbol_id];
+    for (int attempt = 0; attempt < SLOT_READ_RETRIES; ++attempt) {
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        GatewayQuoteFrame copy = quote;
+        copy.update_id = slot.update_id.load(std::memory_order_relaxed);
+        copy.receive_time_ns = slot.receive_time_ns.load(std::memory_order_relaxed);
+        copy.bid_price = slot.bid_price.load(std::memory_order_relaxed);
+        copy.bid_qty = slot.bid_qty.load(std::memory_order_relaxed);
+        copy.ask_price = slot.ask_price.load(std::memory_order_relaxed);
+        copy.ask_qty = slot.ask_qty.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            quote = copy;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Acceptor>
+void MarketDataGateway::accept(Acceptor& acceptor) {
+    using Protocol = typename Acceptor::protocol_type;
+    acceptor.async_accept([this, &acceptor](const boost::system::error_code& ec, typename Protocol::socket socket) {
+        if (ec) {
+            if (ec != boost::asio::error::operation_aborted) {
+                accept(acceptor);
+            }
+            return;
+        }
+        configureSocket(socket);
+        addClient(std::make_shared<SocketClient<Protocol>>(*this, std::move(socket)));
+        accept(acceptor);
+    });
+}
+
+void MarketDataGateway::addClient(std::shared_ptr<Client> client) {
+    clients_.push_back(client);
+    bump(accepted_);
+    client_count_.store(clients_.size(), std::memory_order_relaxed);
+    client->start();
+}
+
+void MarketDataGateway::removeClient(const std::shared_ptr<Client>& client) {
+    auto it = std::find(clients_.begin(), clients_.end(), client);
+    if (it == clients_.end()) {
+        return; // Read and write both failed; already removed
+    }
+    clients_.erase(it);
+    client_count_.store(clients_.size(), std::memory_order_relaxed);
+    for (auto& state : symbols_) {
+        auto& subscribers = state.subscribers;
+        subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), client), subscribers.end());
+    }
+    client->close();
+}
+
+void MarketDataGateway::updateSubscriptions(const std::shared_ptr<Client>& client) {
+    for (SymbolId symbol_id = 0; symbol_id < symbols_.size(); ++symbol_id) {
+        SymbolState& state = symbols_[symbol_id];
+        if (!state.known) {
+            continue;
+        }
+        auto& subscribers = state.subscribers;
+        auto it = std::find(subscribers.begin(), subscribers.end(), client);
+        bool wanted = client->wants(state.announcement.name);
+        if (wanted && it == subscribers.end()) {
+            subscribers.push_back(client);
+            if (state.quote.length != 0) {
+                client->markPending(symbol_id); // Current quote right away
+            }
+        } else if (!wanted && it != subscribers.end()) {
+            subscribers.erase(it);
+        }
+    }
+    client->flush();
+}
+
+MarketDataGateway::SymbolState& MarketDataGateway::symbolState(SymbolId symbol_id) {
+    if (symbol_id >= symbols_.size()) {
+        symbols_.resize(symbol_id + 1);
+    }
+    SymbolState& state = symbols_[symbol_id];
+    if (state.known) {
+        return state;
+    }
+    
+    // First update of this symbol: name it once and find its subscribers
+    const std::string& name = market_state_.getSymbolName(symbol_id);
+    state.known = true;
+    state.announcement.length = sizeof(GatewaySymbolFrame);
+    state.announcement.type = GATEWAY_FRAME_SYMBOL;
+    state.announcement.symbol_id = symbol_id;
+    size_t length = std::min(name.size(), sizeof(state.announcement.name) - 1);
+    std::memcpy(state.announcement.name, name.data(), length);
+    state.announcement.name[length] = '\0';
+    state.quote.symbol_id = symbol_id;
+    for (auto& client : clients_) {
+        if (client->wants(state.announcement.name)) {
+            state.subscribers.push_back(client);
+        }
+    }
+    return state;
+}
+
+void MarketDataGateway::scheduleFlush() {
+    flush_timer_.expires_after(config_.flush_interval);
+    flush_timer_.async_wait([this](const boost::system::error_code& ec) {
+        if (ec) {
+            return;
+        }
+        flush();
+        scheduleFlush();
+    });
+}
+
+void MarketDataGateway::flush() {
+    SymbolId symbol_id;
+    while (changed_.tryPop(symbol_id)) {
+        slots_[symbol_id].dirty.exchange(false, std::memory_order_acq_rel);
+        SymbolState& state = symbolState(symbol_id);
+        if (!readSlot(symbol_id, state.quote)) {
+            continue; // Writer kept the slot busy; its next update queues it again
+        }
+        state.quote.length = sizeof(GatewayQuoteFrame);
+        state.quote.type = GATEWAY_FRAME_QUOTE;
+        for (auto& client : state.subscribers) {
+            client->markPending(symbol_id);
+        }
+    }
+    for (auto& client : clients_) {
+        client->flush();
+    }
+}
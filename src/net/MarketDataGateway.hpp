@@ -0,0 +1,122 @@
+#pragma once
+
+#include "GatewayProtocol.hpp"
+#include "../core/MarketState.hpp"
+#include "../util/MpscQueue.hpp"
+#include <boost/asio.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct BookTickerData;
+
+struct GatewayConfig {
+    uint16_t tcp_port = 0;     // 0: no TCP listener; binds 127.0.0.1 only
+    std::string unix_path;     // Empty: no Unix-socket listener (POSIX)
+    uint32_t max_symbols = 8192;  // Symbol ids at or above this are not forwarded
+    std::chrono::microseconds flush_interval{500};
+};
+
+// Point-in-time gateway counters
+struct GatewayStats {
+    uint64_t clients = 0;
+    uint64_t accepted = 0;
+    uint64_t quotes_sent = 0;
+    uint64_t quotes_conflated = 0;  // Replaced by a newer quote before a slow client took it
+    uint64_t bytes_sent = 0;
+    size_t queued = 0;  // Changed symbols not yet taken by the gateway thread (approximate)
+};
+
+// Re-publishes normalized book updates to local subscribers
+// Feed threads store each update into a per-symbol seqlock slot and queue
+// the symbol once until the gateway takes it, so publishing never blocks and
+// never allocates. One Asio thread serves every client: each flush interval
+// it collects the changed symbols, marks them pending for their subscribers
+// and writes each idle client one batch. A client that is still writing
+// keeps only its pending set, so a slow consumer receives the latest quote
+// per symbol (flagged as conflated) instead of a growing backlog.
+class MarketDataGateway {
+public:
+    // Bind the configured listeners; nullptr if none could be bound
+    static std::unique_ptr<MarketDataGateway> create(const MarketState& market_state, GatewayConfig config);
+    ~MarketDataGateway();
+    
+    MarketDataGateway(const MarketDataGateway&) = delete;
+    MarketDataGateway& operator=(const MarketDataGateway&) = delete;
+    
+    // Feed threads; every symbol must be published by a single thread
+    void publish(SymbolId symbol_id, const BookTickerData& data, int64_t receive_time_ns);
+    
+    void start();
+    void stop();
+    
+    // Any thread; relaxed counters
+    GatewayStats getStats() const;
+
+private:
+    class Client;
+    template <typename Protocol>
+    class SocketClient;
+    friend class Client;
+    
+    // Latest update of one symbol, single writer (its feed thread)
+    struct alignas(64) QuoteSlot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<uint64_t> update_id{0};
+        std::atomic<int64_t> receive_time_ns{0};
+        std::atomic<double> bid_price{0.0};
+        std::atomic<double> bid_qty{0.0};
+        std::atomic<double> ask_price{0.0};
+        std::atomic<double> ask_qty{0.0};
+        std::atomic<bool> dirty{false};  // Queued for the gateway thread
+    };
+    
+    // Gateway thread view of a symbol
+    struct SymbolState {
+        bool known = false;
+        GatewayQuoteFrame quote{};
+        GatewaySymbolFrame announcement{};
+        std::vector<std::shared_ptr<Client>> subscribers;
+    };
+    
+    MarketDataGateway(const MarketState& market_state, GatewayConfig config);
+    
+    template <typename Acceptor>
+    void accept(Acceptor& acceptor);
+    void addClient(std::shared_ptr<Client> client);
+    void removeClient(const std::shared_ptr<Client>& client);
+    void updateSubscriptions(const std::shared_ptr<Client>& client);
+    void scheduleFlush();
+    void flush();
+    bool readSlot(SymbolId symbol_id, GatewayQuoteFrame& quote) const;
+    SymbolState& symbolState(SymbolId symbol_id);
+    
+    const MarketState& market_state_;
+    GatewayConfig config_;
+    std::unique_ptr<QuoteSlot[]> slots_;
+    MpscQueue<SymbolId> changed_;
+    
+    boost::asio::io_context io_;
+    std::unique_ptr<boost::asio::ip::tcp::acceptor> tcp_acceptor_;
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    std::unique_ptr<boost::asio::local::stream_protocol::acceptor> unix_acceptor_;
+#endif
+    boost::asio::steady_timer flush_timer_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    
+    // Gateway thread only
+    std::vector<std::shared_ptr<Client>> clients_;
+    std::vector<SymbolState> symbols_;  // Indexed by SymbolId
+    
+    // Written by the gateway thread
+    std::atomic<uint64_t> accepted_;
+    std::atomic<uint64_t> client_count_;
+    std::atomic<uint64_t> quotes_sent_;
+    std::atomic<uint64_t> quotes_conflated_;
+    std::atomic<uint64_t> bytes_sent_;
+};
@@ -0,0 +1,132 @@
+#include "MetricsServer.hpp"
+#include "../util/PrometheusWriter.hpp"
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <chrono>
+#include <utility>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+using tcp = boost::asio::ip::tcp;
+
+namespace {
+    constexpr std::chrono::seconds SESSION_TIMEOUT{10};
+    constexpr const char* CONTENT_TYPE = "text/plain; version=0.0.4; charset=utf-8";
+}
+
+// One scraper connection; keep-alive requests are served in turn
+class MetricsServer::Session : public std::enable_shared_from_this<MetricsServer::Session> {
+public:
+    Session(MetricsServer& server, tcp::socket socket) : server_(server), stream_(std::move(socket)) {}
+    
+    void read() {
+        request_ = {};
+        stream_.expires_after(SESSION_TIMEOUT);
+        auto self = shared_from_this();
+        http::async_read(stream_, buffer_, request_, [this, self](beast::error_code ec, size_t) {
+            if (ec) {
+                close();
+                return;
+            }
+            respond();
+        });
+    }
+
+private:
+    void respond() {
+        response_ = {};
+        response_.version(request_.version());
+        response_.keep_alive(request_.keep_alive());
+        if (request_.method() != http::verb::get && request_.method() != http::verb::head) {
+            response_.result(http::status::method_not_allowed);
+            response_.body() = "GET only\n";
+        } else if (request_.target() != "/metrics") {
+            response_.result(http::status::not_found);
+            response_.body() = "see /metrics\n";
+        } else {
+            response_.result(http::status::ok);
+            response_.set(http::field::content_type, CONTENT_TYPE);
+            if (request_.method() == http::verb::get) {
+                response_.body() = server_.render();
+            }
+        }
+        response_.prepare_payload();
+        
+        auto self = shared_from_this();
+        http::async_write(stream_, response_, [this, self](beast::error_code ec, size_t) {
+            if (ec || !response_.keep_alive()) {
+                close();
+                return;
+            }
+            read();
+        });
+    }
+    
+    void close() {
+        beast::error_code ec;
+        stream_.socket().shutdown(tcp::socket::shutdown_both, ec);
+        stream_.socket().close(ec);
+    }
+    
+    MetricsServer& server_;
+    beast::tcp_stream stream_;
+    beast::flat_buffer buffer_;
+    http::request<http::string_body> request_;
+    http::response<http::string_body> response_;
+};
+
+std::unique_ptr<MetricsServer> MetricsServer::create(uint16_t port, Renderer renderer) {
+    try {
+        return std::unique_ptr<MetricsServer>(new MetricsServer(port, std::move(renderer)));
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+MetricsServer::MetricsServer(uint16_t port, Renderer renderer)
+    : renderer_(std::move(renderer)),
+      acceptor_(io_, tcp::endpoint(boost::asio::ip::address_v4::loopback(), port), true),
+      port_(acceptor_.local_endpoint().port()),
+      scrapes_(0) {}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+void MetricsServer::start() {
+    if (thread_.joinable()) {
+        return;
+    }
+    accept();
+    thread_ = std::thread([this]() { io_.run(); });
+}
+
+void MetricsServer::stop() {
+    io_.stop();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    boost::system::error_code ec;
+    acceptor_.close(ec);
+}
+
+void MetricsServer::accept() {
+    acceptor_.async_accept([this](const boost::system::error_code& ec, tcp::socket socket) {
+        if (ec == boost::asio::error::operation_aborted) {
+            return;
+        }
+        if (!ec) {
+            std::make_shared<Session>(*this, std::move(socket))->read();
+        }
+        accept();
+    });
+}
+
+std::string MetricsServer::render() {
+    PrometheusWriter writer;
+    if (renderer_) {
+        renderer_(writer);
+    }
+    scrapes_.store(scrapes_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return writer.str();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <boost/asio.hpp>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+class PrometheusWriter;
+
+// Embedded HTTP endpoint for Prometheus scrapes, bound to 127.0.0.1
+// Serves GET /metrics on its own Asio thread; the renderer runs there on
+// every scrape, so it must only read state that is safe without locks on
+// the engine threads (atomics, published snapshots).
+class MetricsServer {
+public:
+    using Renderer = std::function<void(PrometheusWriter& writer)>;
+    
+    // Bind the listener (port 0: ephemeral); nullptr if it cannot be bound
+    static std::unique_ptr<MetricsServer> create(uint16_t port, Renderer renderer);
+    ~MetricsServer();
+    
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+    
+    void start();
+    void stop();
+    
+    uint16_t getPort() const { return port_; }
+    uint64_t getScrapeCount() const { return scrapes_.load(std::memory_order_relaxed); }
+
+private:
+    class Session;
+    
+    MetricsServer(uint16_t port, Renderer renderer);
+    
+    void accept();
+    
+    // Server thread only
+    std::string render();
+    
+    Renderer renderer_;
+    boost::asio::io_context io_;
+    boost::asio::ip::tcp::acceptor acceptor_;
+    uint16_t port_;
+    std::thread thread_;
+    std::atomic<uint64_t> scrapes_;
+};
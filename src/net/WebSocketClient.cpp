@@ -1,7 +1,10 @@
 #include "WebSocketClient.hpp"
 #include "../core/MarketState.hpp"
+#include "../core/MarketUpdatePipeline.hpp"
+#include "MarketDataGateway.hpp"
 #include "../util/JsonParser.hpp"
-#include <iostream>
+#include "../util/LatencyHistogram.hpp"
+#include "../util/TickCapture.hpp"
 #include <openssl/ssl.h>
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
@@ -10,74 +13,376 @@
 #include <chrono>
 #include <thread>
 #include <algorithm>
+#include <utility>
+
+namespace {
+    // Raw endpoint for one stream, combined endpoint (/stream?streams=a/b/...) for several
+    std::string buildTarget(const std::vector<std::string>& streams) {
+        if (streams.size() == 1) {
+            return "/ws/" + streams.front();
+        }
+        std::string target = "/stream?streams=";
+        for (size_t i = 0; i < streams.size(); ++i) {
+            if (i > 0) {
+                target += '/';
+            }
+            target += streams[i];
+        }
+        return target;
+    }
+}
 
 WebSocketClient::WebSocketClient(const std::string& stream, MarketState& market_state)
-    : stream_(stream), market_state_(market_state) {}
+    : stream_(stream), market_state_(market_state), streams_{stream} {}
+
+WebSocketClient::WebSocketClient(const std::vector<std::string>& streams, MarketState& market_state)
+    : market_state_(market_state), streams_(streams) {
+    if (streams.size() == 1) {
+        stream_ = streams.front();
+        return;
+    }
+    stream_ = streams.empty() ? std::string() : streams.front() + " (+" + std::to_string(streams.size() - 1) + ")";
+}
 
 WebSocketClient::~WebSocketClient() {
     stop();
 }
 
+void WebSocketClient::setUpdateCallback(UpdateCallback callback) {
+    on_update_ = std::move(callback);
+}
+
+void WebSocketClient::setSymbolUniverse(const SymbolUniverse* universe) {
+    universe_ = universe;
+}
+
+void WebSocketClient::setTickCapture(TickCapture* capture) {
+    capture_ = capture;
+}
+
+void WebSocketClient::setUpdatePipeline(MarketUpdatePipeline* pipeline) {
+    pipeline_ = pipeline;
+    if (pipeline_) {
+        pipeline_producer_ = pipeline_->addProducer();
+    }
+}
+
+void WebSocketClient::setGateway(MarketDataGateway* gateway) {
+    gateway_ = gateway;
+}
+
+void WebSocketClient::setEndpoint(const std::string& host, const std::string& port) {
+    host_ = host;
+    port_ = port;
+}
+
+void WebSocketClient::subscribe(const std::vector<std::string>& streams) {
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        std::vector<std::string> added;
+        for (const auto& stream : streams) {
+            if (std::find(streams_.begin(), streams_.end(), stream) == streams_.end() &&
+                std::find(added.begin(), added.end(), stream) == added.end()) {
+                added.push_back(stream);
+            }
+        }
+        streams_.insert(streams_.end(), added.begin(), added.end());
+        queueCommand("SUBSCRIBE", added);
+    }
+    wakeConnection();
+}
+
+void WebSocketClient::unsubscribe(const std::vector<std::string>& streams) {
+    bool now_empty = false;
+    {
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        std::vector<std::string> removed;
+        for (const auto& stream : streams) {
+            auto it = std::find(streams_.begin(), streams_.end(), stream);
+            if (it != streams_.end()) {
+                streams_.erase(it);
+                removed.push_back(stream);
+            }
+        }
+        now_empty = !removed.empty() && streams_.empty();
+        if (!now_empty) {
+            queueCommand("UNSUBSCRIBE", removed);
+        }
+    }
+    
+    // A connection without streams has nothing to carry: drop it and let the
+    // feed thread idle until a stream is added
+    if (now_empty) {
+        interruptConnection();
+    } else {
+        wakeConnection();
+    }
+}
+
+void WebSocketClient::interruptConnection() {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    if (socket_ != nullptr) {
+        interrupted_.store(true, std::memory_order_relaxed);
+        boost::system::error_code ignored;
+        socket_->shutdown(tcp::socket::shutdown_both, ignored);
+    }
+}
+
+void WebSocketClient::wakeConnection() {
+    std::lock_guard<std::mutex> lock(socket_mutex_);
+    if (io_context_ != nullptr) {
+        // Returns the feed thread from run_one(), which then sends the queued requests
+        net::post(*io_context_, [] {});
+    }
+}
+
+std::vector<std::string> WebSocketClient::getStreams() const {
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    return streams_;
+}
+
+void WebSocketClient::queueCommand(const char* method, const std::vector<std::string>& streams) {
+    if (streams.empty()) {
+        return;
+    }
+    // {"method":"SUBSCRIBE","params":["arbusdt@bookTicker"],"id":1}
+    std::string command = std::string("{\"method\":\"") + method + "\",\"params\":[";
+    for (size_t i = 0; i < streams.size(); ++i) {
+        command += (i > 0 ? ",\"" : "\"") + streams[i] + "\"";
+    }
+    command += "],\"id\":" + std::to_string(next_command_id_++) + "}";
+    pending_commands_.push_back(std::move(command));
+    commands_pending_.store(true, std::memory_order_release);
+}
+
+uint32_t WebSocketClient::symbolId(const std::string& symbol) {
+    auto it = symbol_ids_.find(symbol);
+    if (it != symbol_ids_.end()) {
+        return it->second;
+    }
+    SymbolId id = market_state_.getSymbolId(symbol);
+    symbol_ids_.emplace(symbol, id);
+    return id;
+}
+
+void WebSocketClient::captureTick(const BookTickerData& data, int64_t receive_time_ns) {
+    if (!capture_) {
+        return;
+    }
+    capture_->record(symbolId(data.symbol), data.update_id, receive_time_ns,
+                     data.bid_price, data.bid_qty, data.ask_price, data.ask_qty);
+}
+
 void WebSocketClient::start() {
     running_ = true;
+    disconnected_since_ns_ = PipelineLatency::nowNs();
     thread_ = std::thread(&WebSocketClient::run, this);
 }
 
 void WebSocketClient::stop() {
     running_ = false;
+    interruptConnection();
     if (thread_.joinable())
         thread_.join();
 }
 
+FeedStats WebSocketClient::getStats() const {
+    FeedStats stats;
+    stats.snapshot_ns = PipelineLatency::nowNs();
+    stats.stream = stream_;
+    stats.connected = connected_.load(std::memory_order_relaxed);
+    stats.messages = messages_.load(std::memory_order_relaxed);
+    stats.bytes = bytes_.load(std::memory_order_relaxed);
+    stats.parse_failures = parse_failures_.load(std::memory_order_relaxed);
+    stats.reconnects = reconnects_.load(std::memory_order_relaxed);
+    
+    uint64_t disconnected_ns = disconnected_total_ns_.load(std::memory_order_relaxed);
+    uint64_t since_ns = disconnected_since_ns_.load(std::memory_order_relaxed);
+    if (since_ns != 0 && stats.snapshot_ns > since_ns) {
+        disconnected_ns += stats.snapshot_ns - since_ns;
+    }
+    stats.disconnected_ms = disconnected_ns / 1000000;
+    
+    uint64_t last_ns = last_message_ns_.load(std::memory_order_relaxed);
+    if (last_ns != 0) {
+        stats.last_message_age_ms = stats.snapshot_ns > last_ns
+            ? static_cast<int64_t>((stats.snapshot_ns - last_ns) / 1000000)
+            : 0;
+    }
+    
+    HistogramSnapshot gaps;
+    gaps_.mergeInto(gaps);
+    stats.gap_p50_us = gaps.percentile(0.50) / 1000;
+    stats.gap_p99_us = gaps.percentile(0.99) / 1000;
+    stats.gap_p999_us = gaps.percentile(0.999) / 1000;
+    
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    stats.last_error = last_error_;
+    return stats;
+}
+
+void WebSocketClient::setLastError(std::string error) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    last_error_ = std::move(error);
+}
+
+namespace {
+    // Counters have a single writer (the feed thread): no locked RMW needed
+    void bump(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+}
+
 void WebSocketClient::run() {
     const int MAX_RETRY_DELAY_MS = 30000; // Maximum 30 seconds
     int retry_delay_ms = 1000; // Start with 1 second
+    bool ever_connected = false;
     
+    // Status goes to counters and last_error instead of stdout, which the UI owns
     while (running_) {
         bool connected = false;
         ws::stream<ssl::stream<tcp::socket>>* ws_ptr = nullptr;
         
         try {
+            // The handshake requests the current stream set, which already
+            // includes every change queued so far
+            std::string target;
+            {
+                std::lock_guard<std::mutex> lock(streams_mutex_);
+                target = streams_.empty() ? std::string() : buildTarget(streams_);
+                pending_commands_.clear();
+                commands_pending_.store(false, std::memory_order_relaxed);
+            }
+            if (target.empty()) {
+                // Nothing to stream: stay idle until subscribe() adds something
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                continue;
+            }
+            
             net::io_context ioc;
             ssl::context ctx{ssl::context::tlsv12_client};
-
+            
             ctx.set_default_verify_paths();
             ctx.set_verify_mode(ssl::verify_none);
-
+            
             tcp::resolver resolver{ioc};
             ws::stream<ssl::stream<tcp::socket>> ws{ioc, ctx};
             ws_ptr = &ws;
-
+            
+            // Lets stop() and unsubscribe() shut the socket down while a read is pending,
+            // and subscribe()/unsubscribe() wake the read loop to send their request
+            struct SocketRegistration {
+                WebSocketClient& client;
+                SocketRegistration(WebSocketClient& owner, tcp::socket& socket, net::io_context& context)
+                    : client(owner) {
+                    std::lock_guard<std::mutex> lock(client.socket_mutex_);
+                    client.socket_ = &socket;
+                    client.io_context_ = &context;
+                }
+                ~SocketRegistration() {
+                    std::lock_guard<std::mutex> lock(client.socket_mutex_);
+                    client.socket_ = nullptr;
+                    client.io_context_ = nullptr;
+                }
+            } registration(*this, ws.next_layer().next_layer(), ioc);
+            interrupted_.store(false, std::memory_order_relaxed);
+            
             // Resolve and connect
-            auto results = resolver.resolve("stream.binance.com", "443");
+            auto results = resolver.resolve(host_, port_);
             net::connect(ws.next_layer().next_layer(), results.begin(), results.end());
-
-            SSL_set_tlsext_host_name(ws.next_layer().native_handle(), "stream.binance.com");
-
+            
+            SSL_set_tlsext_host_name(ws.next_layer().native_handle(), host_.c_str());
+            
             // SSL handshake
             ws.next_layer().handshake(ssl::stream_base::client);
-
+            
             // WebSocket handshake
-            ws.handshake("stream.binance.com", "/ws/" + stream_);
-
-            std::cout << "[WS] Connected to " << stream_ << std::endl;
+            ws.handshake(host_, target);
+            
             connected = true;
             retry_delay_ms = 1000; // Reset retry delay on successful connection
-
+            
+            if (ever_connected) {
+                bump(reconnects_);
+            }
+            ever_connected = true;
+            uint64_t connected_ns = PipelineLatency::nowNs();
+            uint64_t since_ns = disconnected_since_ns_.load(std::memory_order_relaxed);
+            if (since_ns != 0 && connected_ns > since_ns) {
+                bump(disconnected_total_ns_, connected_ns - since_ns);
+            }
+            disconnected_since_ns_.store(0, std::memory_order_relaxed);
+            connected_.store(true, std::memory_order_relaxed);
+            
             // Read messages loop
-            while (running_ && ws.is_open()) {
+            // One asynchronous read is always pending; while it waits, run_one() also
+            // completes request writes and wakeConnection() posts, so a SUBSCRIBE or
+            // UNSUBSCRIBE goes out at once instead of after the next frame. The work
+            // guard keeps ioc from stopping when a handler leaves nothing outstanding
+            auto work = net::make_work_guard(ioc);
+            ws.text(true);
+            beast::flat_buffer buffer;
+            beast::error_code read_error;
+            beast::error_code write_error;
+            uint64_t receive_ns = 0;
+            std::vector<std::string> outgoing;  // Requests to write, front one in flight while writing
+            bool reading = false;
+            bool writing = false;
+            while (running_ && ws.is_open() && !interrupted_.load(std::memory_order_relaxed)) {
                 try {
-                    beast::flat_buffer buffer;
-                    ws.read(buffer);
-
+                    buffer.consume(buffer.size());
+                    reading = true;
+                    ws.async_read(buffer, [&](beast::error_code error, size_t) {
+                        receive_ns = PipelineLatency::nowNs();
+                        read_error = error;
+                        reading = false;
+                    });
+                    while (reading && !write_error) {
+                        if (!writing && commands_pending_.load(std::memory_order_acquire)) {
+                            std::lock_guard<std::mutex> lock(streams_mutex_);
+                            for (auto& command : pending_commands_) {
+                                outgoing.push_back(std::move(command));
+                            }
+                            pending_commands_.clear();
+                            commands_pending_.store(false, std::memory_order_relaxed);
+                        }
+                        if (!writing && !outgoing.empty()) {
+                            writing = true;
+                            ws.async_write(net::buffer(outgoing.front()), [&](beast::error_code error, size_t) {
+                                write_error = error;
+                                outgoing.erase(outgoing.begin());
+                                writing = false;
+                            });
+                        }
+                        ioc.run_one();
+                    }
+                    if (read_error || write_error) {
+                        throw beast::system_error(read_error ? read_error : write_error);
+                    }
+                    
                     if (!running_) {
                         break;
                     }
-
+                    
+                    bump(messages_);
+                    bump(bytes_, buffer.size());
+                    uint64_t previous_ns = last_message_ns_.load(std::memory_order_relaxed);
+                    if (previous_ns != 0 && receive_ns > previous_ns) {
+                        gaps_.record(receive_ns - previous_ns);
+                    }
+                    last_message_ns_.store(receive_ns, std::memory_order_relaxed);
+                    
                     std::string msg = boost::beast::buffers_to_string(buffer.data());
                     
+                    // {"result":null,"id":N} acknowledges a (UN)SUBSCRIBE request
+                    if (msg.compare(0, 10, "{\"result\":") == 0) {
+                        continue;
+                    }
+                    
                     // Parse JSON message
-                    BookTickerData data = JsonParser::parseBookTicker(msg);
+                    BookTickerData data = JsonParser::parseBookTicker(msg, universe_);
+                    uint64_t parsed_ns = PipelineLatency::nowNs();
+                    PipelineLatency::record(PipelineStage::Parse, parsed_ns - receive_ns);
                     
                     if (data.valid) {
                         // Get current timestamp in milliseconds
@@ -85,6 +390,33 @@ void WebSocketClient::run() {
                         auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                             now.time_since_epoch()).count();
                         
+                        // Wall-clock receive time: update time minus the parse duration
+                        int64_t receive_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            now.time_since_epoch()).count() - static_cast<int64_t>(parsed_ns - receive_ns);
+                        if (gateway_) {
+                            gateway_->publish(symbolId(data.symbol), data, receive_time_ns);
+                        }
+                        
+                        if (pipeline_) {
+                            // The market-state thread applies it and runs detection
+                            BookUpdate update;
+                            update.symbol_id = symbolId(data.symbol);
+                            update.update_id = data.update_id;
+                            update.bid_price = data.bid_price;
+                            update.bid_qty = data.bid_qty;
+                            update.ask_price = data.ask_price;
+                            update.ask_qty = data.ask_qty;
+                            update.timestamp_ms = static_cast<int64_t>(ms);
+                            update.receive_ns = receive_ns;
+                            update.parsed_ns = parsed_ns;
+                            // A dropped update never reaches the books, so the capture skips it
+                            // too (counted in the pipeline's overflows)
+                            if (pipeline_->publish(pipeline_producer_, update)) {
+                                captureTick(data, receive_time_ns);
+                            }
+                            continue;
+                        }
+                        
                         // Update MarketState
                         market_state_.get(data.symbol).update(
                             data.bid_price,
@@ -93,30 +425,50 @@ void WebSocketClient::run() {
                             data.ask_qty,
                             static_cast<int64_t>(ms)
                         );
+                        uint64_t updated_ns = PipelineLatency::nowNs();
+                        PipelineLatency::record(PipelineStage::BookUpdate, updated_ns - parsed_ns);
+                        captureTick(data, receive_time_ns);
+                        
+                        if (on_update_) {
+                            on_update_(data.symbol, receive_ns);
+                            uint64_t detected_ns = PipelineLatency::nowNs();
+                            PipelineLatency::record(PipelineStage::Detect, detected_ns - updated_ns);
+                            PipelineLatency::record(PipelineStage::ReceiveToDetect, detected_ns - receive_ns);
+                        }
+                    } else {
+                        bump(parse_failures_);
                     }
                 }
                 catch (const beast::system_error& se) {
+                    if (interrupted_.exchange(false, std::memory_order_relaxed)) {
+                        break; // Closed on purpose by stop() or unsubscribe()
+                    }
                     if (se.code() == beast::websocket::error::closed) {
-                        std::cout << "[WS] Connection closed by server for " << stream_ << std::endl;
-                        break; // Exit read loop, will reconnect
+                        setLastError("Connection closed by server");
                     }
                     else if (se.code() == boost::asio::error::eof || 
                              se.code() == boost::asio::ssl::error::stream_truncated) {
-                        std::cout << "[WS] Stream ended (EOF or truncated) for " << stream_ << std::endl;
-                        break; // Exit read loop, will reconnect
+                        setLastError("Stream ended (EOF or truncated)");
                     }
                     else {
-                        std::cerr << "[WS ERROR] Read error for " << stream_ << ": " << se.what() 
-                                  << " (code: " << se.code() << ")" << std::endl;
-                        break; // Exit read loop, will reconnect
+                        setLastError(std::string("Read error: ") + se.what());
                     }
+                    break; // Exit read loop, will reconnect
                 }
                 catch (const std::exception& e) {
-                    std::cerr << "[WS ERROR] Exception during read for " << stream_ << ": " << e.what() << std::endl;
+                    setLastError(std::string("Exception during read: ") + e.what());
                     break; // Exit read loop, will reconnect
                 }
             }
-
+            
+            // A read or write still in flight must finish before the close handshake
+            work.reset();
+            if (reading || writing) {
+                boost::system::error_code ignored;
+                ws.next_layer().next_layer().cancel(ignored);
+                ioc.run();
+            }
+            
             // Close connection gracefully if still open
             if (ws_ptr && ws_ptr->is_open()) {
                 try {
@@ -128,16 +480,19 @@ void WebSocketClient::run() {
             }
         }
         catch (const beast::system_error& se) {
-            std::cerr << "[WS ERROR] Connection error for " << stream_ << ": " << se.what() 
-                      << " (code: " << se.code() << ")" << std::endl;
+            setLastError(std::string("Connection error: ") + se.what());
         }
         catch (const std::exception& e) {
-            std::cerr << "[WS ERROR] Exception for " << stream_ << ": " << e.what() << std::endl;
+            setLastError(std::string("Exception: ") + e.what());
         }
-
+        
+        if (connected) {
+            connected_.store(false, std::memory_order_relaxed);
+            disconnected_since_ns_.store(PipelineLatency::nowNs(), std::memory_order_relaxed);
+        }
+        
         // If connection failed or lost, wait and retry
         if (running_ && !connected) {
-            std::cout << "[WS] Reconnecting to " << stream_ << " in " << (retry_delay_ms / 1000.0) << " seconds..." << std::endl;
             std::this_thread::sleep_for(std::chrono::milliseconds(retry_delay_ms));
             
             // Exponential backoff: double the delay, but cap at MAX_RETRY_DELAY_MS
@@ -145,14 +500,10 @@ void WebSocketClient::run() {
         }
         else if (running_) {
             // Connection was lost, wait a bit before reconnecting
-            std::cout << "[WS] Connection lost for " << stream_ << ". Reconnecting in " 
-                      << (retry_delay_ms / 1000.0) << " seconds..." << std::endl;
             std::this_thread::sleep_for(std::chrono::milliseconds(retry_delay_ms));
             
             // Reset retry delay to initial value for reconnection after successful connection
             retry_delay_ms = 1000;
         }
     }
-    
-    std::cout << "[WS] Stopped " << stream_ << std::endl;
 }
@@ -3,10 +3,16 @@
 #include <boost/beast/websocket.hpp>
 #include <boost/beast/ssl.hpp>
 #include <boost/asio.hpp>
+#include "src/util/LatencyHistogram.hpp"
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <functional>
+#include <unordered_map>
+#include <vector>
 
 namespace net  = boost::asio;
 namespace ssl  = net::ssl;
@@ -16,20 +22,139 @@ using tcp = net::ip::tcp;
 
 // Forward declaration
 class MarketState;
+class SymbolUniverse;
+class TickCapture;
+class MarketUpdatePipeline;
+class MarketDataGateway;
+struct BookTickerData;
+
+// Point-in-time health of one feed connection
+// Totals are cumulative; rates are derived by the reader from two snapshots
+struct FeedStats {
+    std::string stream;
+    bool connected = false;
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    uint64_t parse_failures = 0;
+    uint64_t reconnects = 0;
+    uint64_t disconnected_ms = 0;    // Total, including the current outage
+    int64_t last_message_age_ms = -1;  // -1 before the first message
+    uint64_t gap_p50_us = 0;         // Inter-arrival gaps between frames
+    uint64_t gap_p99_us = 0;
+    uint64_t gap_p999_us = 0;
+    uint64_t snapshot_ns = 0;        // PipelineLatency::nowNs() at snapshot time
+    std::string last_error;
+};
 
 class WebSocketClient {
 public:
+    // Invoked on the feed thread after each applied book update
+    // receive_ns: PipelineLatency::nowNs() when the frame was read
+    using UpdateCallback = std::function<void(const std::string& symbol, uint64_t receive_ns)>;
+    
     explicit WebSocketClient(const std::string& stream, MarketState& market_state);
+    
+    // One connection carrying several streams (Binance combined stream endpoint)
+    WebSocketClient(const std::vector<std::string>& streams, MarketState& market_state);
     ~WebSocketClient();
-
+    
+    // Must be set before start()
+    void setUpdateCallback(UpdateCallback callback);
+    
+    // Normalize symbols through the loaded exchangeInfo table (must outlive the client)
+    void setSymbolUniverse(const SymbolUniverse* universe);
+    
+    // Record every applied update into a tick capture file (must outlive the client)
+    void setTickCapture(TickCapture* capture);
+    
+    // Hand parsed updates to the pipeline's market-state thread instead of
+    // writing books here; the update callback is then not invoked.
+    // Must be called before pipeline->start() (must outlive the client)
+    void setUpdatePipeline(MarketUpdatePipeline* pipeline);
+    
+    // Re-publish every valid update to local subscribers (must outlive the client)
+    void setGateway(MarketDataGateway* gateway);
+    
+    // Connect somewhere other than stream.binance.com:443, e.g. arb_mock_exchange
+    // Must be set before start()
+    void setEndpoint(const std::string& host, const std::string& port);
+    
     void start();
+    
+    // Closes the live connection instead of waiting for its next frame
     void stop();
+    
+    // Add or remove streams on the live connection, any thread
+    // The SUBSCRIBE/UNSUBSCRIBE request is handed to the feed thread, which is woken
+    // to send it right away; a reconnect requests the current stream set directly.
+    // Removing the last stream closes the connection: it sits idle until a stream is added
+    void subscribe(const std::vector<std::string>& streams);
+    void unsubscribe(const std::vector<std::string>& streams);
+    
+    // Streams currently requested, any thread
+    std::vector<std::string> getStreams() const;
+    
+    // Cheap to call from any thread; reads relaxed counters
+    FeedStats getStats() const;
 
 private:
     void run();
-
-    std::string stream_;
+    void setLastError(std::string error);
+    
+    // Feed thread only; MarketState is locked once per new symbol
+    uint32_t symbolId(const std::string& symbol);
+    
+    // Record an update into the tick capture, if one is set
+    void captureTick(const BookTickerData& data, int64_t receive_time_ns);
+    
+    // Queue a SUBSCRIBE/UNSUBSCRIBE request; streams_mutex_ held
+    void queueCommand(const char* method, const std::vector<std::string>& streams);
+    
+    // Shut the live socket down so the pending read on the feed thread fails, any thread
+    void interruptConnection();
+    
+    // Wake the live connection's read loop to send queued requests, any thread
+    void wakeConnection();
+    
+    std::string stream_;  // Display name for log lines
     MarketState& market_state_;
+    std::string host_ = "stream.binance.com";
+    std::string port_ = "443";
+    
+    // Requested streams and the live-connection requests not sent yet (guarded by streams_mutex_)
+    mutable std::mutex streams_mutex_;
+    std::vector<std::string> streams_;
+    std::vector<std::string> pending_commands_;
+    uint64_t next_command_id_ = 1;
+    std::atomic<bool> commands_pending_{false};
+    
+    UpdateCallback on_update_;
+    const SymbolUniverse* universe_ = nullptr;
+    TickCapture* capture_ = nullptr;
+    MarketUpdatePipeline* pipeline_ = nullptr;
+    size_t pipeline_producer_ = 0;
+    MarketDataGateway* gateway_ = nullptr;
+    std::unordered_map<std::string, uint32_t> symbol_ids_;  // Feed thread cache of MarketState ids
     std::atomic<bool> running_{false};
     std::thread thread_;
+    
+    // Socket and io_context of the live connection, null between connections (guarded by socket_mutex_)
+    std::mutex socket_mutex_;
+    tcp::socket* socket_ = nullptr;
+    net::io_context* io_context_ = nullptr;
+    std::atomic<bool> interrupted_{false};  // The read error that follows is ours, not the server's
+    
+    // Feed health, written by the feed thread only
+    std::atomic<bool> connected_{false};
+    std::atomic<uint64_t> messages_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> parse_failures_{0};
+    std::atomic<uint64_t> reconnects_{0};
+    std::atomic<uint64_t> disconnected_total_ns_{0};
+    std::atomic<uint64_t> disconnected_since_ns_{0};  // 0 while connected
+    std::atomic<uint64_t> last_message_ns_{0};
+    LatencyHistogram gaps_;
+    
+    mutable std::mutex error_mutex_;
+    std::string last_error_;
 };
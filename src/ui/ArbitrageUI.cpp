@@ -1,211 +1,336 @@
 #include "ArbitrageUI.hpp"
 #include "src/config/Symbols.hpp"
+#include "src/core/OpportunityFormatter.hpp"
+#include "src/util/LatencyHistogram.hpp"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <cstdio>
 #include <ctime>
 #include <thread>
 #include <atomic>
 
-ArbitrageUI::ArbitrageUI(MarketState& market_state, ArbitrageDetector& detector)
-    : market_state_(market_state), detector_(detector) {
-    ui_state_.last_update = getCurrentTime();
+namespace {
+    // Default redraw cap; the hot path never waits on the terminal
+    constexpr int DEFAULT_MAX_FPS = 5;
+    
+    bool sameRoute(const UIState::RouteStatus& shown, const DetectorResults::RouteStatus& route) {
+        return shown.has_data == route.has_data && shown.has_opportunity == route.has_opportunity &&
+            shown.profit_percent == route.profit_percent;
+    }
+    
+    // Connected but silent: lagging or dead stream
+    bool silentFeed(const FeedStats& feed) {
+        return feed.last_message_age_ms < 0 || feed.last_message_age_ms > 3000;
+    }
+    
+    // Copy-on-write section of the next UIState: reads go to the previous
+    // state's section until the first edit copies it
+    template <typename T>
+    class SectionEditor {
+    public:
+        explicit SectionEditor(UIState::Section<T> previous) : previous_(std::move(previous)) {}
+        
+        const T& read() const {
+            return copy_ ? *copy_ : *previous_;
+        }
+        
+        T& edit() {
+            if (!copy_) {
+                copy_ = std::make_shared<T>(*previous_);
+            }
+            return *copy_;
+        }
+        
+        bool edited() const {
+            return copy_ != nullptr;
+        }
+        
+        UIState::Section<T> result() const {
+            return copy_ ? UIState::Section<T>(copy_) : previous_;
+        }
+    
+    private:
+        UIState::Section<T> previous_;
+        std::shared_ptr<T> copy_;
+    };
+}
+
+ArbitrageUI::ArbitrageUI(MarketState& market_state, ArbitrageDetector& detector, const Clock& clock)
+    : market_state_(market_state),
+      detector_(detector),
+      clock_(clock),
+      frame_interval_(1000 / DEFAULT_MAX_FPS),
+      scroll_offset_(0) {
+    auto state = std::make_shared<UIState>();
+    state->last_update = getCurrentTime();
+    state_ = std::move(state);
+}
+
+void ArbitrageUI::addFeed(const WebSocketClient* client) {
+    feeds_.push_back(client);
+}
+
+void ArbitrageUI::setMaxFrameRate(int fps) {
+    frame_interval_ = std::chrono::milliseconds(1000 / std::max(1, fps));
 }
 
-void ArbitrageUI::update() {
-    std::lock_guard<std::mutex> lock(ui_state_.mutex);
+bool ArbitrageUI::update() {
+    // Start from the published state: unchanged sections are shared, not copied
+    auto previous = std::atomic_load(&state_);
+    auto state = std::make_shared<UIState>(*previous);
+    bool changed = false;
     
-    auto all_symbols = getAllSymbols();
+    auto results = detector_.getResults();
+    auto all_symbols = getAllSymbols(*results);
+    int64_t now_ms = clock_.nowMs();
+    
+    // A reloaded route table may read a different set of pairs
+    SectionEditor<std::unordered_map<std::string, SymbolData>> market_data(previous->market_data);
+    if (*previous->symbols != all_symbols) {
+        auto& cells = market_data.edit();
+        for (auto it = cells.begin(); it != cells.end();) {
+            bool listed = std::find(all_symbols.begin(), all_symbols.end(), it->first) != all_symbols.end();
+            it = listed ? std::next(it) : cells.erase(it);
+        }
+        state->symbols = std::make_shared<std::vector<std::string>>(all_symbols);
+        changed = true;
+    }
+    if (state->config_version != results->config_version) {
+        char buffer[96];
+        if (results->fee_percent > 0.0) {
+            std::snprintf(buffer, sizeof(buffer), "(Threshold: %.2f%%, fee %.3f%% per trade)",
+                          results->threshold_percent, results->fee_percent);
+        } else {
+            std::snprintf(buffer, sizeof(buffer), "(Threshold: %.2f%%)", results->threshold_percent);
+        }
+        state->threshold_text = buffer;
+        changed = true;
+    }
     
     for (const auto& symbol : all_symbols) {
         auto snap = market_state_.get(symbol).snapshot();
-        SymbolData& data = ui_state_.market_data[symbol];
+        auto it = market_data.read().find(symbol);
+        bool cell_changed = it == market_data.read().end();
+        SymbolData data = cell_changed ? SymbolData() : it->second;
         
-        if (snap.has_data) {
+        if (snap.has_data && snap.version != data.version) {
+            int precision = displayPrecision(symbol);
             data.updatePrice(snap.bid_price, snap.ask_price);
-            data.has_data = true;
             data.last_timestamp_ms = snap.timestamp_ms;
-        } else {
-            data.has_data = false;
+            data.version = snap.version;
+            data.bid_text = formatPrice(snap.bid_price, precision);
+            data.ask_text = formatPrice(snap.ask_price, precision);
+            cell_changed = true;
+        }
+        if (data.has_data != snap.has_data) {
+            data.has_data = snap.has_data;
+            cell_changed = true;
+        }
+        bool stale = data.isStale(now_ms, 3000);
+        if (data.stale != stale) {
+            data.stale = stale;
+            cell_changed = true;
+        }
+        if (cell_changed) {
+            market_data.edit()[symbol] = std::move(data);
         }
     }
-    auto opportunity = detector_.checkOpportunities();
-    if (opportunity.has_value() && opportunity.value().valid) {
-        const auto& opp = opportunity.value();
-        ui_state_.has_opportunity = true;
-        ui_state_.direction = opp.direction;
-        ui_state_.trade_sequence = opp.trade_sequence;
-        ui_state_.route_name = opp.route_name;
-        ui_state_.profit_percent = opp.profit_percent;
-        ui_state_.max_tradable_amount = opp.max_tradable_amount;
-        ui_state_.max_tradable_currency = opp.max_tradable_currency;
-        ui_state_.opportunities_found++;
-        
-        if (opp.profit_percent > ui_state_.max_profit_found) {
-            ui_state_.max_profit_found = opp.profit_percent;
-        }
-        if (ui_state_.opportunities_found > 0) {
-            ui_state_.avg_profit_found = 
-                (ui_state_.avg_profit_found * (ui_state_.opportunities_found - 1) + opp.profit_percent) 
-                / ui_state_.opportunities_found;
-        }
-    } else {
-        ui_state_.has_opportunity = false;
-    }
-    
-    ui_state_.route_statuses.clear();
-    
-    // 2-leg routes
-    std::vector<std::pair<std::string, std::string>> routes = {
-        {"ARB/BTC", "BTC/USDT"},
-        {"ARB/ETH", "ETH/USDT"},
-        {"ARB/EUR", "EUR/USDT"},
-        {"ARB/TRY", "TRY/USDT"}
-    };
-    
-    for (const auto& [arb_pair, cross_pair] : routes) {
-        UIState::RouteStatus status;
-        status.route_name = arb_pair + " -> " + cross_pair;
-        
-        auto arb_snap = market_state_.get(arb_pair).snapshot();
-        auto cross_snap = market_state_.get(cross_pair).snapshot();
-        auto usdt_snap = market_state_.get("ARB/USDT").snapshot();
-        
-        status.has_data = arb_snap.has_data && cross_snap.has_data && usdt_snap.has_data;
-        
-        if (status.has_data) {
-            // Check both directions and get best profit
-            auto route_opp = detector_.checkRoutePublic(arb_pair, cross_pair);
-            if (route_opp.has_value() && route_opp.value().valid) {
-                status.has_opportunity = true;
-                status.profit_percent = route_opp.value().profit_percent;
-            } else {
-                // Calculate current profit even if below threshold
-                // Direction 1: Buy implied, sell direct
-                double cost1 = arb_snap.ask_price * cross_snap.ask_price;
-                double final1 = usdt_snap.bid_price;
-                double profit1 = cost1 > 0 ? (final1 / cost1 - 1.0) * 100.0 : 0.0;
-                
-                // Direction 2: Buy direct, sell implied
-                double cost2 = usdt_snap.ask_price;
-                double final2 = arb_snap.bid_price * cross_snap.bid_price;
-                double profit2 = cost2 > 0 ? (final2 / cost2 - 1.0) * 100.0 : 0.0;
-                
-                status.profit_percent = std::max(profit1, profit2);
+    if (market_data.edited()) {
+        int active_count = 0;
+        int stale_count = 0;
+        int total_count = 0;
+        for (const auto& [symbol, data] : market_data.read()) {
+            total_count++;
+            if (data.has_data) {
+                if (data.stale) {
+                    stale_count++;
+                } else {
+                    active_count++;
+                }
             }
         }
-        
-        ui_state_.route_statuses.push_back(status);
+        state->active_symbols_count = active_count;
+        state->stale_symbols_count = stale_count;
+        state->total_symbols_count = total_count;
+        state->market_data = market_data.result();
+        changed = true;
     }
     
-    // Direct comparison routes
-    std::vector<std::string> direct_routes = {"ARB/FDUSD", "ARB/USDC", "ARB/TUSD"};
-    for (const auto& stable_pair : direct_routes) {
-        UIState::RouteStatus status;
-        status.route_name = stable_pair + " vs ARB/USDT";
-        
-        auto stable_snap = market_state_.get(stable_pair).snapshot();
-        auto usdt_snap = market_state_.get("ARB/USDT").snapshot();
-        
-        status.has_data = stable_snap.has_data && usdt_snap.has_data;
-        
-        if (status.has_data) {
-            auto direct_opp = detector_.checkDirectComparisonPublic(stable_pair);
-            if (direct_opp.has_value() && direct_opp.value().valid) {
-                status.has_opportunity = true;
-                status.profit_percent = direct_opp.value().profit_percent;
-            } else {
-                // Calculate current profit even if below threshold
-                double cost1 = stable_snap.ask_price;
-                double final1 = usdt_snap.bid_price;
-                double profit1 = cost1 > 0 ? (final1 / cost1 - 1.0) * 100.0 : 0.0;
-                
-                double cost2 = usdt_snap.ask_price;
-                double final2 = stable_snap.bid_price;
-                double profit2 = cost2 > 0 ? (final2 / cost2 - 1.0) * 100.0 : 0.0;
-                
-                status.profit_percent = std::max(profit1, profit2);
-            }
+    // Route names never change for a route table entry; rebuild them only when the table is replaced
+    SectionEditor<std::vector<UIState::RouteStatus>> route_statuses(previous->route_statuses);
+    if (previous->config_version != results->config_version ||
+        route_statuses.read().size() != results->routes.size()) {
+        auto& statuses = route_statuses.edit();
+        statuses.assign(results->routes.size(), UIState::RouteStatus());
+        for (size_t i = 0; i < statuses.size(); ++i) {
+            const auto& route = results->routes[i];
+            statuses[i].route_name = OpportunityFormatter::routeName(route.kind, route.legs, market_state_);
         }
-        
-        ui_state_.route_statuses.push_back(status);
     }
+    for (size_t i = 0; i < results->routes.size(); ++i) {
+        const auto& route = results->routes[i];
+        const UIState::RouteStatus& shown = route_statuses.read()[i];
+        if (!shown.text.empty() && sameRoute(shown, route)) {
+            continue;
+        }
+        UIState::RouteStatus& status = route_statuses.edit()[i];
+        status.profit_percent = route.profit_percent;
+        status.has_opportunity = route.has_opportunity;
+        status.has_data = route.has_data;
+        if (!status.has_data) {
+            status.text = status.route_name + ": N/A (no data)";
+        } else {
+            status.text = status.route_name + ": " + formatPrice(status.profit_percent, 4) + "%" +
+                (status.has_opportunity ? " ✓" : "");
+        }
+    }
+    if (route_statuses.edited()) {
+        state->route_statuses = route_statuses.result();
+        changed = true;
+    }
+    state->config_version = results->config_version;
     
-    // Multi-leg routes (3+ legs)
-    std::vector<std::tuple<std::string, std::string, std::string>> multi_leg_routes = {
-        {"ARB/EUR", "ARB/BTC", "BTC/USDT"},
-        {"ARB/EUR", "ARB/ETH", "ETH/USDT"},
-        {"ARB/TRY", "ARB/BTC", "BTC/USDT"},
-        {"ARB/TRY", "ARB/ETH", "ETH/USDT"}
-    };
+    auto latency = PipelineLatency::merge();
+    SectionEditor<std::vector<UIState::LatencyRow>> latency_rows(previous->latency_rows);
+    if (latency_rows.read().size() != latency.size()) {
+        latency_rows.edit().resize(latency.size());
+    }
+    for (size_t stage = 0; stage < latency.size(); ++stage) {
+        const UIState::LatencyRow& shown = latency_rows.read()[stage];
+        if (shown.count == latency[stage].total && !shown.stage.empty()) {
+            continue;
+        }
+        UIState::LatencyRow& row = latency_rows.edit()[stage];
+        row.stage = PipelineLatency::stageName(static_cast<PipelineStage>(stage));
+        row.count = latency[stage].total;
+        row.p50_us = latency[stage].percentile(0.50) / 1000.0;
+        row.p99_us = latency[stage].percentile(0.99) / 1000.0;
+        row.p999_us = latency[stage].percentile(0.999) / 1000.0;
+        if (row.count == 0) {
+            row.text = "  " + row.stage + ": N/A";
+        } else {
+            row.text = "  " + row.stage + ": " + formatPrice(row.p50_us, 1) + " / " + formatPrice(row.p99_us, 1) + " / " +
+                formatPrice(row.p999_us, 1) + " (" + std::to_string(row.count) + ")";
+        }
+    }
+    if (latency_rows.edited()) {
+        state->latency_rows = latency_rows.result();
+        changed = true;
+    }
     
-    for (const auto& [start, intermediate, final] : multi_leg_routes) {
-        UIState::RouteStatus status;
-        status.route_name = start + " -> " + intermediate + " -> " + final;
-        
-        // Check if we have data for this route
-        auto start_snap = market_state_.get(start).snapshot();
-        auto intermediate_snap = market_state_.get(intermediate).snapshot();
-        auto final_snap = market_state_.get(final).snapshot();
-        
-        // Determine quote currency
-        std::string quote_currency;
-        size_t slash_pos = start.find('/');
-        if (slash_pos != std::string::npos && slash_pos + 1 < start.length()) {
-            quote_currency = start.substr(slash_pos + 1);
-        }
-        std::string quote_usdt_pair = quote_currency + "/USDT";
-        auto quote_usdt_snap = market_state_.get(quote_usdt_pair).snapshot();
-        
-        status.has_data = start_snap.has_data && intermediate_snap.has_data && 
-                         final_snap.has_data && quote_usdt_snap.has_data;
-        
-        if (status.has_data) {
-            auto multi_leg_opp = detector_.checkMultiLegRoutePublic(start, intermediate, final);
-            if (multi_leg_opp.has_value() && multi_leg_opp.value().valid) {
-                status.has_opportunity = true;
-                status.profit_percent = multi_leg_opp.value().profit_percent;
-            } else {
-                // Calculate current profit even if below threshold
-                double cost_quote = start_snap.ask_price;
-                if (cost_quote > 0.0) {
-                    double arb_amount = 1.0 / cost_quote;
-                    double intermediate_amount = arb_amount * intermediate_snap.bid_price;
-                    double final_usdt = intermediate_amount * final_snap.bid_price;
-                    double initial_usdt = 1.0 * quote_usdt_snap.ask_price;
-                    
-                    if (initial_usdt > 0.0) {
-                        status.profit_percent = (final_usdt / initial_usdt - 1.0) * 100.0;
-                    }
-                }
-            }
+    // Feed rates from the counter deltas since the previous update
+    // Ages are shown in whole seconds, so a quiet feed does not redraw every frame
+    SectionEditor<std::vector<UIState::FeedRow>> feed_rows(previous->feed_rows);
+    if (feed_rows.read().size() != feeds_.size()) {
+        feed_rows.edit().resize(feeds_.size());
+    }
+    previous_feed_stats_.resize(feeds_.size());
+    for (size_t i = 0; i < feeds_.size(); ++i) {
+        UIState::FeedRow row;
+        row.stats = feeds_[i]->getStats();
+        const FeedStats& last = previous_feed_stats_[i];
+        if (last.snapshot_ns != 0 && row.stats.snapshot_ns > last.snapshot_ns) {
+            double seconds = (row.stats.snapshot_ns - last.snapshot_ns) / 1e9;
+            row.messages_per_sec = (row.stats.messages - last.messages) / seconds;
+            row.kbytes_per_sec = (row.stats.bytes - last.bytes) / 1024.0 / seconds;
+        }
+        previous_feed_stats_[i] = row.stats;
+        
+        const FeedStats& feed = row.stats;
+        std::string age_text = feed.last_message_age_ms < 0 ? "N/A" : std::to_string(feed.last_message_age_ms / 1000) + " s";
+        row.text = feed.stream + (feed.connected ? " [UP] " : " [DOWN] ") +
+            formatPrice(row.messages_per_sec, 1) + " msg/s, " +
+            formatPrice(row.kbytes_per_sec, 1) + " KB/s, age " + age_text +
+            ", gap p50/p99/p99.9 " + std::to_string(feed.gap_p50_us / 1000) + "/" +
+            std::to_string(feed.gap_p99_us / 1000) + "/" + std::to_string(feed.gap_p999_us / 1000) + " ms" +
+            ", reconnects " + std::to_string(feed.reconnects) +
+            ", parse errors " + std::to_string(feed.parse_failures) +
+            ", down " + std::to_string(feed.disconnected_ms / 1000) + " s";
+        if (!feed.connected && !feed.last_error.empty()) {
+            row.text += " (" + feed.last_error + ")";
         }
         
-        ui_state_.route_statuses.push_back(status);
+        const UIState::FeedRow& shown = feed_rows.read()[i];
+        if (row.text != shown.text || silentFeed(feed) != silentFeed(shown.stats)) {
+            feed_rows.edit()[i] = std::move(row);
+        }
+    }
+    if (feed_rows.edited()) {
+        state->feed_rows = feed_rows.result();
+        changed = true;
     }
     
-    // Update symbol statistics
-    int active_count = 0;
-    int stale_count = 0;
-    int total_count = 0;
+    // Implied rates from the detector's matrix; rows are replaced only when their text changes
+    SectionEditor<std::vector<UIState::ImpliedRateRow>> implied_rate_rows(previous->implied_rate_rows);
+    if (implied_rate_rows.read().size() != results->implied_rates.size()) {
+        implied_rate_rows.edit().resize(results->implied_rates.size());
+    }
+    for (size_t i = 0; i < results->implied_rates.size(); ++i) {
+        const ImpliedRateSummary& summary = results->implied_rates[i];
+        std::string name = summary.asset + "/" + summary.quote;
+        std::string text;
+        if (!summary.best.valid) {
+            text = name + ": N/A (" + std::to_string(summary.path_count) + " paths)";
+        } else {
+            int precision = displayPrecision(name);
+            text = name + ": bid " + formatPrice(summary.best.bid, precision) + " via " +
+                (summary.best_bid_via.empty() ? std::string("direct") : summary.best_bid_via) +
+                ", ask " + formatPrice(summary.best.ask, precision) + " via " +
+                (summary.best_ask_via.empty() ? std::string("direct") : summary.best_ask_via) +
+                " (" + std::to_string(summary.path_count) + " paths)";
+        }
+        if (text != implied_rate_rows.read()[i].text) {
+            UIState::ImpliedRateRow& row = implied_rate_rows.edit()[i];
+            row.valid = summary.best.valid;
+            row.text = std::move(text);
+        }
+    }
+    if (implied_rate_rows.edited()) {
+        state->implied_rate_rows = implied_rate_rows.result();
+        changed = true;
+    }
     
-    for (const auto& [symbol, data] : ui_state_.market_data) {
-        total_count++;
-        if (data.has_data) {
-            if (data.isStale(3000)) {
-                stale_count++;
-            } else {
-                active_count++;
+    // Count each published best once
+    const auto& opportunity = results->best;
+    bool new_results = results->sequence != state->results_sequence;
+    state->results_sequence = results->sequence;
+    if (opportunity.has_value() && opportunity.value().valid) {
+        const auto& opp = opportunity.value();
+        if (!state->has_opportunity || state->route_id != opp.route_id || state->direction != opp.direction ||
+            state->profit_percent != opp.profit_percent) {
+            state->has_opportunity = true;
+            state->route_id = opp.route_id;
+            state->direction = opp.direction;
+            state->trade_sequence = OpportunityFormatter::tradeSequence(opp, market_state_);
+            state->route_name = OpportunityFormatter::routeName(opp, market_state_);
+            state->profit_percent = opp.profit_percent;
+            state->max_tradable_amount = opp.max_tradable_amount;
+            state->max_tradable_currency = OpportunityFormatter::tradableCurrency(opp, market_state_);
+            changed = true;
+        }
+        if (new_results) {
+            state->opportunities_found++;
+            if (opp.profit_percent > state->max_profit_found) {
+                state->max_profit_found = opp.profit_percent;
             }
+            state->avg_profit_found =
+                (state->avg_profit_found * (state->opportunities_found - 1) + opp.profit_percent)
+                / state->opportunities_found;
         }
+    } else if (state->has_opportunity) {
+        state->has_opportunity = false;
+        changed = true;
     }
     
-    ui_state_.active_symbols_count = active_count;
-    ui_state_.stale_symbols_count = stale_count;
-    ui_state_.total_symbols_count = total_count;
+    // Counters and the clock are shown, but only redraw with a visible change
+    state->check_count = results->check_count;
+    if (changed) {
+        state->last_update = getCurrentTime();
+    }
     
-    // Update statistics
-    ui_state_.check_count = detector_.getCheckCount();
-    ui_state_.last_update = getCurrentTime();
+    std::atomic_store(&state_, std::shared_ptr<const UIState>(std::move(state)));
+    return changed;
 }
 
 void ArbitrageUI::run() {
@@ -214,12 +339,15 @@ void ArbitrageUI::run() {
     
     std::atomic<bool> running{true};
     
-    // Update thread
+    // Update thread: one state per frame slot, a redraw only when something changed
     std::thread update_thread([this, &screen, &running]() {
+        auto next_frame = std::chrono::steady_clock::now();
         while (running.load()) {
-            update();
-            screen.PostEvent(ftxui::Event::Custom);
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            if (update()) {
+                screen.PostEvent(ftxui::Event::Custom);
+            }
+            next_frame += frame_interval_;
+            std::this_thread::sleep_until(next_frame);
         }
     });
     
@@ -230,16 +358,13 @@ void ArbitrageUI::run() {
             return true;
         }
         
+        // Handled events redraw on their own
         if (event.is_mouse()) {
-            std::lock_guard<std::mutex> lock(ui_state_.mutex);
-            
             if (event.mouse().button == ftxui::Mouse::WheelDown) {
-                ui_state_.scroll_offset += 1;
-                screen.PostEvent(ftxui::Event::Custom);
+                scroll_offset_ += 1;
                 return true;
             } else if (event.mouse().button == ftxui::Mouse::WheelUp) {
-                ui_state_.scroll_offset = std::max(0, ui_state_.scroll_offset - 1);
-                screen.PostEvent(ftxui::Event::Custom);
+                scroll_offset_ = std::max(0, scroll_offset_ - 1);
                 return true;
             }
         }
@@ -258,8 +383,9 @@ ftxui::Component ArbitrageUI::buildComponent() {
     using namespace ftxui;
     
     auto renderer = Renderer([this]() {
-        std::lock_guard<std::mutex> lock(ui_state_.mutex);
-        const auto& state = ui_state_;
+        // Lock-free: the update thread never modifies a published state
+        auto snapshot = std::atomic_load(&state_);
+        const UIState& state = *snapshot;
         
         // Header
         auto header = hbox({
@@ -271,34 +397,27 @@ ftxui::Component ArbitrageUI::buildComponent() {
         price_boxes.push_back(text("Market Prices") | bold | color(Color::Yellow));
         price_boxes.push_back(separator());
         
-        auto all_symbols = getAllSymbols();
+        const auto& all_symbols = *state.symbols;
         Elements arb_pairs_row;
         Elements cross_pairs_row;
         
         for (const auto& symbol : all_symbols) {
-            auto it = state.market_data.find(symbol);
-            if (it != state.market_data.end()) {
+            auto it = state.market_data->find(symbol);
+            if (it != state.market_data->end()) {
                 const auto& data = it->second;
                 
-                bool is_stale = data.isStale(3000);
+                bool is_stale = data.stale;
                 bool show_as_active = data.has_data && !is_stale;
                 
                 std::string status_text = show_as_active ? "●" : "○";
                 
-                int precision = 8;
-                if (symbol.find("BTC/") == 0 || symbol.find("ETH/") == 0) {
-                    precision = 2;
-                } else if (symbol.find("EUR/") == 0 || symbol.find("TRY/") == 0) {
-                    precision = 4;
-                }
-                
                 Element price_box = vbox({
                     text(symbol) | bold,
                     hbox({
                         text(status_text + " "),
                         vbox({
-                            text("Bid: " + formatPrice(data.bid_price, precision)),
-                            text("Ask: " + formatPrice(data.ask_price, precision)),
+                            text("Bid: " + (data.bid_text.empty() ? std::string("N/A") : data.bid_text)),
+                            text("Ask: " + (data.ask_text.empty() ? std::string("N/A") : data.ask_text)),
                         }),
                     }),
                 }) | border;
@@ -368,7 +487,7 @@ ftxui::Component ArbitrageUI::buildComponent() {
         } else {
             opportunity_section = vbox({
                 text("No arbitrage opportunity") | dim,
-                text("(Threshold: 0.10%)") | dim,
+                text(state.threshold_text) | dim,
             }) | border | size(ftxui::WIDTH, ftxui::EQUAL, 900) | size(ftxui::HEIGHT, ftxui::GREATER_THAN, 15);
         }
         
@@ -377,32 +496,50 @@ ftxui::Component ArbitrageUI::buildComponent() {
         route_elements.push_back(text("Route Status") | bold | color(Color::Cyan));
         route_elements.push_back(separator());
         
-        for (const auto& route : state.route_statuses) {
-            std::string route_text = route.route_name;
-            std::string profit_text;
-            
+        for (const auto& route : *state.route_statuses) {
             if (!route.has_data) {
-                profit_text = "N/A (no data)";
-                route_text += ": " + profit_text;
-                route_elements.push_back(text(route_text) | dim);
+                route_elements.push_back(text(route.text) | dim);
+            } else if (route.has_opportunity) {
+                // Above threshold - show in green/yellow based on profit
+                auto profit_color = route.profit_percent > 0.5 ? Color::Green : Color::Yellow;
+                route_elements.push_back(text(route.text) | color(profit_color) | bold);
             } else {
-                profit_text = formatPrice(route.profit_percent, 4) + "%";
-                
-                if (route.has_opportunity) {
-                    // Above threshold - show in green/yellow based on profit
-                    auto profit_color = route.profit_percent > 0.5 ? Color::Green : Color::Yellow;
-                    route_text += ": " + profit_text + " ✓";
-                    route_elements.push_back(text(route_text) | color(profit_color) | bold);
-                } else {
-                    // Below threshold - show in white/gray
-                    route_text += ": " + profit_text;
-                    route_elements.push_back(text(route_text));
-                }
+                // Below threshold - show in white/gray
+                route_elements.push_back(text(route.text));
             }
         }
         
         auto route_section = vbox(route_elements) | border | size(ftxui::WIDTH, ftxui::EQUAL, 900) | size(ftxui::HEIGHT, ftxui::GREATER_THAN, 25);
         
+        // Implied Rates Section
+        Elements rate_elements;
+        rate_elements.push_back(text("Implied USDT Rates") | bold | color(Color::Cyan));
+        rate_elements.push_back(separator());
+        
+        for (const auto& row : *state.implied_rate_rows) {
+            rate_elements.push_back(row.valid ? text(row.text) : text(row.text) | dim);
+        }
+        
+        auto rate_section = vbox(rate_elements) | border | size(ftxui::WIDTH, ftxui::EQUAL, 900);
+        
+        // Feed Health Section
+        Elements feed_elements;
+        feed_elements.push_back(text("Feed Health") | bold | color(Color::Cyan));
+        feed_elements.push_back(separator());
+        
+        for (const auto& row : *state.feed_rows) {
+            const FeedStats& feed = row.stats;
+            if (!feed.connected) {
+                feed_elements.push_back(text(row.text) | color(Color::Red));
+            } else if (silentFeed(feed)) {
+                feed_elements.push_back(text(row.text) | color(Color::Yellow));
+            } else {
+                feed_elements.push_back(text(row.text));
+            }
+        }
+        
+        auto feed_section = vbox(feed_elements) | border | size(ftxui::WIDTH, ftxui::EQUAL, 900);
+        
         // Statistics Section
         Elements stats_elements;
         stats_elements.push_back(text("Statistics") | bold | color(Color::Cyan));
@@ -436,6 +573,13 @@ ftxui::Component ArbitrageUI::buildComponent() {
         }
         stats_elements.push_back(separator());
         
+        // Pipeline latency
+        stats_elements.push_back(text("Latency (us, p50 / p99 / p99.9):") | dim);
+        for (const auto& row : *state.latency_rows) {
+            stats_elements.push_back(row.count == 0 ? text(row.text) | dim : text(row.text));
+        }
+        stats_elements.push_back(separator());
+        
         // Timestamp
         stats_elements.push_back(text("Last update: " + state.last_update));
         
@@ -454,16 +598,20 @@ ftxui::Component ArbitrageUI::buildComponent() {
         content_elements.push_back(separator());
         content_elements.push_back(route_section);
         content_elements.push_back(separator());
+        content_elements.push_back(rate_section);
+        content_elements.push_back(separator());
+        content_elements.push_back(feed_section);
+        content_elements.push_back(separator());
         content_elements.push_back(stats_section);
         content_elements.push_back(separator());
         content_elements.push_back(footer);
         
         Elements scrolled_elements;
-        if (state.scroll_offset > 0 && state.scroll_offset < static_cast<int>(content_elements.size())) {
+        if (scroll_offset_ > 0 && scroll_offset_ < static_cast<int>(content_elements.size())) {
             scrolled_elements.insert(scrolled_elements.end(), 
-                content_elements.begin() + state.scroll_offset, 
+                content_elements.begin() + scroll_offset_, 
                 content_elements.end());
-        } else if (state.scroll_offset >= static_cast<int>(content_elements.size())) {
+        } else if (scroll_offset_ >= static_cast<int>(content_elements.size())) {
             if (!content_elements.empty()) {
                 scrolled_elements.push_back(content_elements.back());
             }
@@ -478,14 +626,27 @@ ftxui::Component ArbitrageUI::buildComponent() {
     return renderer;
 }
 
-std::string ArbitrageUI::formatPrice(double price, int precision) const {
+std::string ArbitrageUI::formatPrice(double price, int precision) {
     if (price <= 0.0) {
         return "N/A";
     }
     
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(precision) << price;
-    return oss.str();
+    // No stream or locale per cell
+    char buffer[64];
+    int length = std::snprintf(buffer, sizeof(buffer), "%.*f", precision, price);
+    if (length < 0) {
+        return "N/A";
+    }
+    return std::string(buffer, std::min(static_cast<size_t>(length), sizeof(buffer) - 1));
+}
+
+int ArbitrageUI::displayPrecision(const std::string& symbol) {
+    if (symbol.find("BTC/") == 0 || symbol.find("ETH/") == 0) {
+        return 2;
+    } else if (symbol.find("EUR/") == 0 || symbol.find("TRY/") == 0) {
+        return 4;
+    }
+    return 8;
 }
 
 std::string ArbitrageUI::getCurrentTime() const {
@@ -498,6 +659,6 @@ std::string ArbitrageUI::getCurrentTime() const {
     return oss.str();
 }
 
-std::vector<std::string> ArbitrageUI::getAllSymbols() const {
-    return Symbols::getAllSymbols();
+std::vector<std::string> ArbitrageUI::getAllSymbols(const DetectorResults& results) const {
+    return results.pairs ? *results.pairs : Symbols::getAllSymbols();
 }
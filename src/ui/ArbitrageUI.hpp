@@ -2,13 +2,15 @@
 
 #include "src/core/MarketState.hpp"
 #include "src/core/ArbitrageDetector.hpp"
+#include "src/net/WebSocketClient.hpp"
+#include "src/util/Clock.hpp"
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/elements.hpp>
 #include <string>
 #include <vector>
 #include <unordered_map>
-#include <mutex>
+#include <memory>
 #include <chrono>
 
 enum class PriceChange {
@@ -27,23 +29,25 @@ struct SymbolData {
     int64_t last_timestamp_ms = 0;  // Last timestamp from OrderBook
     PriceChange price_change = PriceChange::Unknown;
     
+    // Display cells, formatted only when the book version changes
+    uint64_t version = 0;
+    bool stale = true;
+    std::string bid_text;
+    std::string ask_text;
+    
     SymbolData() 
         : bid_price(0.0), ask_price(0.0), 
           previous_bid_price(0.0), previous_ask_price(0.0),
           has_data(false), last_timestamp_ms(0), 
-          price_change(PriceChange::Unknown) {}
+          price_change(PriceChange::Unknown),
+          version(0), stale(true) {}
     
-    // Check if data is stale (older than threshold_ms)
-    bool isStale(int64_t threshold_ms = 3000) const {
+    // Check if data is stale (older than threshold_ms at now_ms, epoch ms)
+    bool isStale(int64_t now_ms, int64_t threshold_ms = 3000) const {
         if (!has_data || last_timestamp_ms == 0) {
             return true;
         }
         
-        // Get current time in milliseconds (epoch)
-        auto now = std::chrono::system_clock::now();
-        auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()).count();
-        
         // Check if timestamp is in the future (shouldn't happen, but safety check)
         if (last_timestamp_ms > now_ms) {
             return false; // Future timestamp, consider it fresh
@@ -83,12 +87,22 @@ struct SymbolData {
     }
 };
 
+// Immutable frame state: built by the update thread, published by pointer
+// swap and rendered without locks. Text cells are formatted at build time.
+// Each table is a shared section: a new state shares the sections that did not
+// change with the previous one, so an update copies only what it edits.
 struct UIState {
+    template <typename T>
+    using Section = std::shared_ptr<const T>;
+    
     // Market data - all symbols
-    std::unordered_map<std::string, SymbolData> market_data;
+    Section<std::unordered_map<std::string, SymbolData>> market_data =
+        std::make_shared<std::unordered_map<std::string, SymbolData>>();
+    Section<std::vector<std::string>> symbols = std::make_shared<std::vector<std::string>>();  // Display order
     
     // Arbitrage opportunity
     bool has_opportunity = false;
+    uint32_t route_id = 0;
     int direction = 0;
     std::string trade_sequence;
     std::string route_name;
@@ -102,13 +116,49 @@ struct UIState {
         double profit_percent;
         bool has_opportunity;
         bool has_data;
+        std::string text;  // Display line
         
         RouteStatus() : profit_percent(0.0), has_opportunity(false), has_data(false) {}
     };
-    std::vector<RouteStatus> route_statuses;
+    Section<std::vector<RouteStatus>> route_statuses = std::make_shared<std::vector<RouteStatus>>();
+    uint64_t config_version = 0;  // Detector route table the statuses belong to
+    std::string threshold_text;
+    
+    // Pipeline latency per stage, cumulative since start
+    struct LatencyRow {
+        std::string stage;
+        uint64_t count;
+        double p50_us;
+        double p99_us;
+        double p999_us;
+        std::string text;  // Display line
+        
+        LatencyRow() : count(0), p50_us(0.0), p99_us(0.0), p999_us(0.0) {}
+    };
+    Section<std::vector<LatencyRow>> latency_rows = std::make_shared<std::vector<LatencyRow>>();
+    
+    // Feed health, one row per WebSocket connection
+    struct FeedRow {
+        FeedStats stats;
+        double messages_per_sec;
+        double kbytes_per_sec;
+        std::string text;  // Display line
+        
+        FeedRow() : messages_per_sec(0.0), kbytes_per_sec(0.0) {}
+    };
+    Section<std::vector<FeedRow>> feed_rows = std::make_shared<std::vector<FeedRow>>();
+    
+    // Best implied rate of every asset, one row per asset and quote asset
+    struct ImpliedRateRow {
+        bool valid;
+        std::string text;  // Display line
+        
+        ImpliedRateRow() : valid(false) {}
+    };
+    Section<std::vector<ImpliedRateRow>> implied_rate_rows = std::make_shared<std::vector<ImpliedRateRow>>();
     
     // Statistics
-    int check_count = 0;
+    uint64_t check_count = 0;
     int opportunities_found = 0;
     double max_profit_found = 0.0;
     double avg_profit_found = 0.0;
@@ -120,18 +170,25 @@ struct UIState {
     // Timestamp
     std::string last_update;
     
-    // Scroll offset for manual scrolling
-    int scroll_offset = 0;
-    
-    std::mutex mutex;
+    // Detector snapshot the state was built from
+    uint64_t results_sequence = 0;
 };
 
 class ArbitrageUI {
 public:
-    ArbitrageUI(MarketState& market_state, ArbitrageDetector& detector);
+    // Staleness is judged against clock (wall clock unless injected)
+    ArbitrageUI(MarketState& market_state, ArbitrageDetector& detector,
+                const Clock& clock = SystemClock::instance());
+    
+    // Show a feed in the health panel (client must outlive the UI)
+    void addFeed(const WebSocketClient* client);
+    
+    // Redraw at most fps times per second (default 5); call before run()
+    void setMaxFrameRate(int fps);
     
-    // Update UI state from market data
-    void update();
+    // Build and publish a new state from market data
+    // Returns true when anything visible changed since the previous state
+    bool update();
     
     // Run the UI (blocking call)
     void run();
@@ -139,17 +196,31 @@ public:
 private:
     MarketState& market_state_;
     ArbitrageDetector& detector_;
-    UIState ui_state_;
+    const Clock& clock_;
+    std::chrono::milliseconds frame_interval_;
+    
+    // Published state; accessed only through std::atomic_load / std::atomic_store
+    std::shared_ptr<const UIState> state_;
+    
+    // Scroll offset for manual scrolling (screen thread only)
+    int scroll_offset_;
+    
+    // Feeds and their stats at the previous update (update thread only)
+    std::vector<const WebSocketClient*> feeds_;
+    std::vector<FeedStats> previous_feed_stats_;
     
     // Build the UI component
     ftxui::Component buildComponent();
     
     // Format price for display
-    std::string formatPrice(double price, int precision = 8) const;
+    static std::string formatPrice(double price, int precision = 8);
+    
+    // Decimals shown for a symbol's prices
+    static int displayPrecision(const std::string& symbol);
     
     // Get current timestamp string
     std::string getCurrentTime() const;
     
-    // Get all symbols to display
-    std::vector<std::string> getAllSymbols() const;
+    // Get all symbols to display: the pairs read by the current route table
+    std::vector<std::string> getAllSymbols(const DetectorResults& results) const;
 };
@@ -1,55 +1,81 @@
 #include "ArbitrageLogger.hpp"
 
 ArbitrageLogger::ArbitrageLogger() {
-    // Constructor - can be used for initialization if needed
+    std::string filename = generateFilename();
+    latency_filename_ = "arbitrage_latency_" + filename.substr(std::string("arbitrage_").size());
+    latency_filename_.replace(latency_filename_.size() - 5, 5, ".jsonl");
+    stats_filename_ = "arbitrage_stats_" + latency_filename_.substr(std::string("arbitrage_latency_").size());
 }
 
 ArbitrageLogger::~ArbitrageLogger() {
     // Destructor - cleanup if needed
 }
 
-void ArbitrageLogger::logOpportunity(const ArbitrageOpportunity& opp) {
-    // Get current timestamp
-    auto now = std::chrono::system_clock::now();
-    auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto tm = *std::localtime(&time_t);
+void ArbitrageLogger::logLatency(const std::array<HistogramSnapshot, PIPELINE_STAGE_COUNT>& current,
+                                 const std::array<HistogramSnapshot, PIPELINE_STAGE_COUNT>& previous) {
+    auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
     
-    // Generate filename
-    std::string filename = generateFilename();
+    // One line per dump, values in microseconds
+    std::ostringstream json_oss;
+    json_oss << std::fixed << std::setprecision(3);
+    json_oss << "{\"timestamp_ms\": " << now_ms;
+    for (size_t stage = 0; stage < PIPELINE_STAGE_COUNT; ++stage) {
+        HistogramSnapshot interval = current[stage].since(previous[stage]);
+        json_oss << ", \"" << PipelineLatency::stageName(static_cast<PipelineStage>(stage)) << "\": {";
+        json_oss << "\"count\": " << interval.total;
+        json_oss << ", \"p50_us\": " << interval.percentile(0.50) / 1000.0;
+        json_oss << ", \"p99_us\": " << interval.percentile(0.99) / 1000.0;
+        json_oss << ", \"p999_us\": " << interval.percentile(0.999) / 1000.0;
+        json_oss << ", \"max_since_start_us\": " << current[stage].max_ns / 1000.0;
+        json_oss << "}";
+    }
+    json_oss << "}\n";
     
-    // Get current timestamp in milliseconds for JSON
+    try {
+        if (!latency_file_.is_open()) {
+            latency_file_.open(latency_filename_, std::ios::out | std::ios::app);
+        }
+        if (latency_file_.is_open()) {
+            latency_file_ << json_oss.str();
+            latency_file_.flush();
+        }
+    } catch (const std::exception&) {
+        // Silent failure - don't spam console
+    }
+}
+
+void ArbitrageLogger::logStats(const EngineStats& current, const EngineStats& previous) {
     auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()).count();
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    double seconds = previous.snapshot_ns != 0 && current.snapshot_ns > previous.snapshot_ns
+        ? (current.snapshot_ns - previous.snapshot_ns) / 1e9
+        : 0.0;
+    auto rate = [seconds](double delta) { return seconds > 0.0 ? delta / seconds : 0.0; };
     
-    // Create JSON content (manual JSON construction - no external library)
     std::ostringstream json_oss;
-    json_oss << std::fixed << std::setprecision(8);
-    
-    json_oss << "{\n";
-    json_oss << "  \"timestamp_ms\": " << now_ms << ",\n";
-    json_oss << "  \"timestamp\": \"" << formatTimestamp(tm) << "\",\n";
-    json_oss << "  \"direction\": " << opp.direction << ",\n";
-    json_oss << "  \"route_name\": \"" << opp.route_name << "\",\n";
-    json_oss << "  \"trade_sequence\": \"" << opp.trade_sequence << "\",\n";
-    json_oss << "  \"profit_percent\": " << opp.profit_percent << ",\n";
-    json_oss << "  \"max_tradable_amount\": " << opp.max_tradable_amount << ",\n";
-    json_oss << "  \"max_tradable_currency\": \"" << opp.max_tradable_currency << "\",\n";
-    json_oss << "  \"prices\": {\n";
-    json_oss << "    \"arb_usdt_bid\": " << opp.arb_usdt_bid << ",\n";
-    json_oss << "    \"arb_usdt_ask\": " << opp.arb_usdt_ask << ",\n";
-    json_oss << "    \"arb_other_bid\": " << opp.arb_other_bid << ",\n";
-    json_oss << "    \"arb_other_ask\": " << opp.arb_other_ask << ",\n";
-    json_oss << "    \"other_usdt_bid\": " << opp.other_usdt_bid << ",\n";
-    json_oss << "    \"other_usdt_ask\": " << opp.other_usdt_ask << "\n";
-    json_oss << "  }\n";
+    json_oss << std::fixed << std::setprecision(1);
+    json_oss << "{\"timestamp_ms\": " << now_ms;
+    json_oss << ", \"feeds_up\": " << current.feeds_connected << ", \"feeds\": " << current.feeds;
+    json_oss << ", \"msgs_per_sec\": " << rate(double(current.messages - previous.messages));
+    json_oss << ", \"kbytes_per_sec\": " << rate((current.bytes - previous.bytes) / 1024.0);
+    json_oss << ", \"checks_per_sec\": " << rate(double(current.check_count - previous.check_count));
+    json_oss << ", \"messages\": " << current.messages;
+    json_oss << ", \"parse_failures\": " << current.parse_failures;
+    json_oss << ", \"reconnects\": " << current.reconnects;
+    json_oss << ", \"journal_written\": " << current.journal_written;
+    json_oss << ", \"journal_dropped\": " << current.journal_dropped;
+    json_oss << ", \"ticks_captured\": " << current.ticks_captured;
+    json_oss << ", \"ring_overflows\": " << current.ring_overflows;
     json_oss << "}\n";
     
-    // Write to file
     try {
-        std::ofstream file(filename, std::ios::out | std::ios::trunc);
-        if (file.is_open()) {
-            file << json_oss.str();
-            file.close();
+        if (!stats_file_.is_open()) {
+            stats_file_.open(stats_filename_, std::ios::out | std::ios::app);
+        }
+        if (stats_file_.is_open()) {
+            stats_file_ << json_oss.str();
+            stats_file_.flush();
         }
     } catch (const std::exception&) {
         // Silent failure - don't spam console
@@ -67,9 +93,3 @@ std::string ArbitrageLogger::generateFilename() const {
     oss << ".json";
     return oss.str();
 }
-
-std::string ArbitrageLogger::formatTimestamp(const std::tm& tm) const {
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
-}
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "src/core/ArbitrageDetector.hpp"
+#include "LatencyHistogram.hpp"
+#include <array>
 #include <string>
 #include <fstream>
 #include <sstream>
@@ -8,18 +9,43 @@
 #include <ctime>
 #include <chrono>
 
+// Engine-wide counters since start, sampled for the periodic stats line
+struct EngineStats {
+    size_t feeds = 0;
+    size_t feeds_connected = 0;
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    uint64_t parse_failures = 0;
+    uint64_t reconnects = 0;
+    uint64_t check_count = 0;
+    uint64_t journal_written = 0;
+    uint64_t journal_dropped = 0;
+    uint64_t ticks_captured = 0;
+    uint64_t ring_overflows = 0;  // Updates dropped by full pipeline rings (single-writer mode)
+    int64_t snapshot_ns = 0;  // PipelineLatency::nowNs() when sampled
+};
+
 class ArbitrageLogger {
 public:
     ArbitrageLogger();
     ~ArbitrageLogger();
     
-    // Log an arbitrage opportunity to JSON file
-    void logOpportunity(const ArbitrageOpportunity& opp);
+    // Append p50/p99/p99.9 per pipeline stage for the interval since previous
+    void logLatency(const std::array<HistogramSnapshot, PIPELINE_STAGE_COUNT>& current,
+                    const std::array<HistogramSnapshot, PIPELINE_STAGE_COUNT>& previous);
     
+    // Append one compact line of totals and rates since previous
+    void logStats(const EngineStats& current, const EngineStats& previous);
+
 private:
+    // arbitrage_latency_<session start>.jsonl, opened on first dump
+    std::string latency_filename_;
+    std::ofstream latency_file_;
+    
+    // arbitrage_stats_<session start>.jsonl, opened on first line
+    std::string stats_filename_;
+    std::ofstream stats_file_;
+    
     // Generate filename with timestamp
     std::string generateFilename() const;
-    
-    // Format timestamp string
-    std::string formatTimestamp(const std::tm& tm) const;
 };
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Time source in epoch milliseconds
+// Live code reads the wall clock; replay drives a SimulatedClock from the
+// recorded tick timestamps so results do not depend on when they are computed.
+class Clock {
+public:
+    virtual ~Clock() = default;
+    virtual int64_t nowMs() const = 0;
+};
+
+class SystemClock : public Clock {
+public:
+    int64_t nowMs() const override {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+    
+    // Shared instance for code that has no clock injected
+    static const SystemClock& instance() {
+        static const SystemClock clock;
+        return clock;
+    }
+};
+
+class SimulatedClock : public Clock {
+public:
+    explicit SimulatedClock(int64_t start_ms = 0) : now_ms_(start_ms) {}
+    
+    int64_t nowMs() const override { return now_ms_.load(std::memory_order_relaxed); }
+    
+    // Time never moves backwards
+    void set(int64_t now_ms) {
+        if (now_ms > now_ms_.load(std::memory_order_relaxed)) {
+            now_ms_.store(now_ms, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<int64_t> now_ms_;
+};
@@ -0,0 +1,183 @@
+#include "EngineMetrics.hpp"
+#include "LatencyHistogram.hpp"
+#include "LockContention.hpp"
+#include "OpportunityJournal.hpp"
+#include "PrometheusWriter.hpp"
+#include "src/core/ArbitrageDetector.hpp"
+#include "src/core/MarketUpdatePipeline.hpp"
+#include "src/core/OpportunityFormatter.hpp"
+#include "src/net/MarketDataGateway.hpp"
+#include "src/net/WebSocketClient.hpp"
+#include <chrono>
+
+namespace {
+    const char* routeKindName(RouteKind kind) {
+        switch (kind) {
+            case RouteKind::CrossPair:
+                return "cross_pair";
+            case RouteKind::DirectComparison:
+                return "direct";
+            case RouteKind::MultiLeg:
+                return "multi_leg";
+        }
+        return "unknown";
+    }
+}
+
+EngineMetrics::EngineMetrics(const MarketState& market_state, const ArbitrageDetector& detector)
+    : market_state_(market_state), detector_(detector) {}
+
+void EngineMetrics::addFeed(const WebSocketClient* client) {
+    feeds_.push_back(client);
+}
+
+void EngineMetrics::setPipeline(const MarketUpdatePipeline* pipeline) {
+    pipeline_ = pipeline;
+}
+
+void EngineMetrics::setJournal(const OpportunityJournal* journal) {
+    journal_ = journal;
+}
+
+void EngineMetrics::setGateway(const MarketDataGateway* gateway) {
+    gateway_ = gateway;
+}
+
+void EngineMetrics::write(PrometheusWriter& writer) {
+    writeBooks(writer);
+    writeDetector(writer);
+    writeFeeds(writer);
+    writeQueues(writer);
+    writeLatency(writer);
+    writeLocks(writer);
+}
+
+void EngineMetrics::writeBooks(PrometheusWriter& writer) {
+    if (books_.size() != market_state_.getBookCount()) {
+        books_ = market_state_.getBooks();
+    }
+    int64_t now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    writer.family("arb_book_updates_total", "counter", "Top-of-book updates applied per symbol");
+    for (const auto& book : books_) {
+        writer.sample("arb_book_updates_total", {{"symbol", book.first}},
+                      static_cast<double>(book.second->activity().updates));
+    }
+    writer.family("arb_book_age_seconds", "gauge", "Time since the last update of each book that has data");
+    for (const auto& book : books_) {
+        int64_t timestamp_ms = book.second->activity().timestamp_ms;
+        if (timestamp_ms != 0) {
+            writer.sample("arb_book_age_seconds", {{"symbol", book.first}}, (now_ms - timestamp_ms) / 1000.0);
+        }
+    }
+}
+
+void EngineMetrics::writeDetector(PrometheusWriter& writer) {
+    writer.family("arb_detector_checks_total", "counter", "Event-path trigger checks; rate() gives checks per second");
+    writer.sample("arb_detector_checks_total", static_cast<double>(detector_.getCheckCount()));
+    writer.family("arb_detector_opportunities_total", "counter", "Opportunities found on the event path");
+    writer.sample("arb_detector_opportunities_total", static_cast<double>(detector_.getOpportunityCount()));
+    
+    // Published every 100 ms by the detector thread
+    auto results = detector_.getResults();
+    // A reload can keep the route count but change the routes
+    if (route_names_version_ != results->config_version) {
+        route_names_version_ = results->config_version;
+        route_names_.clear();
+        for (const auto& route : results->routes) {
+            route_names_.push_back(OpportunityFormatter::routeName(route.kind, route.legs, market_state_));
+        }
+    }
+    writer.family("arb_route_profit_percent", "gauge", "Current profit of the best direction per route, also below threshold");
+    for (size_t i = 0; i < results->routes.size(); ++i) {
+        const auto& route = results->routes[i];
+        if (route.has_data) {
+            writer.sample("arb_route_profit_percent",
+                          {{"route", route_names_[i]}, {"kind", routeKindName(route.kind)}}, route.profit_percent);
+        }
+    }
+    writer.family("arb_detector_threshold_percent", "gauge", "Profit threshold of the detector");
+    writer.sample("arb_detector_threshold_percent", results->threshold_percent);
+}
+
+void EngineMetrics::writeFeeds(PrometheusWriter& writer) {
+    std::vector<FeedStats> feeds;
+    feeds.reserve(feeds_.size());
+    for (const auto* client : feeds_) {
+        feeds.push_back(client->getStats());
+    }
+    
+    writer.family("arb_feed_connected", "gauge", "1 while the feed connection is up");
+    for (const auto& feed : feeds) {
+        writer.sample("arb_feed_connected", {{"feed", feed.stream}}, feed.connected ? 1.0 : 0.0);
+    }
+    writer.family("arb_feed_messages_total", "counter", "Frames received per feed connection");
+    for (const auto& feed : feeds) {
+        writer.sample("arb_feed_messages_total", {{"feed", feed.stream}}, static_cast<double>(feed.messages));
+    }
+    writer.family("arb_feed_parse_failures_total", "counter", "Frames that did not parse as a bookTicker update");
+    for (const auto& feed : feeds) {
+        writer.sample("arb_feed_parse_failures_total", {{"feed", feed.stream}}, static_cast<double>(feed.parse_failures));
+    }
+    writer.family("arb_feed_reconnects_total", "counter", "Reconnects per feed connection");
+    for (const auto& feed : feeds) {
+        writer.sample("arb_feed_reconnects_total", {{"feed", feed.stream}}, static_cast<double>(feed.reconnects));
+    }
+}
+
+void EngineMetrics::writeQueues(PrometheusWriter& writer) {
+    writer.family("arb_queue_depth", "gauge", "Items waiting in an internal queue (approximate)");
+    if (pipeline_) {
+        writer.sample("arb_queue_depth", {{"queue", "pipeline"}}, static_cast<double>(pipeline_->getStats().queued));
+    }
+    if (journal_) {
+        writer.sample("arb_queue_depth", {{"queue", "journal"}}, static_cast<double>(journal_->getQueueDepth()));
+    }
+    if (gateway_) {
+        writer.sample("arb_queue_depth", {{"queue", "gateway"}}, static_cast<double>(gateway_->getStats().queued));
+    }
+    
+    writer.family("arb_queue_dropped_total", "counter", "Items dropped because a queue was full");
+    if (pipeline_) {
+        writer.sample("arb_queue_dropped_total", {{"queue", "pipeline"}}, static_cast<double>(pipeline_->getStats().overflows));
+    }
+    if (journal_) {
+        writer.sample("arb_queue_dropped_total", {{"queue", "journal"}}, static_cast<double>(journal_->getDroppedCount()));
+    }
+    
+    if (gateway_) {
+        GatewayStats gateway = gateway_->getStats();
+        writer.family("arb_gateway_clients", "gauge", "Connected market-data gateway subscribers");
+        writer.sample("arb_gateway_clients", static_cast<double>(gateway.clients));
+        writer.family("arb_gateway_quotes_total", "counter", "Quotes sent by the gateway, by outcome");
+        writer.sample("arb_gateway_quotes_total", {{"outcome", "sent"}}, static_cast<double>(gateway.quotes_sent));
+        writer.sample("arb_gateway_quotes_total", {{"outcome", "conflated"}}, static_cast<double>(gateway.quotes_conflated));
+    }
+}
+
+void EngineMetrics::writeLatency(PrometheusWriter& writer) {
+    auto latency = PipelineLatency::merge();
+    writer.family("arb_pipeline_latency_seconds", "histogram", "Market-data pipeline stage latency since start");
+    for (size_t i = 0; i < PIPELINE_STAGE_COUNT; ++i) {
+        if (latency[i].total > 0) {
+            writer.histogram("arb_pipeline_latency_seconds",
+                             {{"stage", PipelineLatency::stageName(static_cast<PipelineStage>(i))}}, latency[i]);
+        }
+    }
+}
+
+void EngineMetrics::writeLocks(PrometheusWriter& writer) {
+    writer.family("arb_lock_contended_total", "counter", "Lock acquisitions that had to wait, per lock site");
+    for (size_t i = 0; i < LOCK_SITE_COUNT; ++i) {
+        auto site = static_cast<LockSite>(i);
+        writer.sample("arb_lock_contended_total", {{"lock", LockContention::siteName(site)}},
+                      static_cast<double>(LockContention::get(site).contended));
+    }
+    writer.family("arb_lock_wait_seconds_total", "counter", "Time spent waiting for contended locks, per lock site");
+    for (size_t i = 0; i < LOCK_SITE_COUNT; ++i) {
+        auto site = static_cast<LockSite>(i);
+        writer.sample("arb_lock_wait_seconds_total", {{"lock", LockContention::siteName(site)}},
+                      static_cast<double>(LockContention::get(site).wait_ns) / 1e9);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "src/core/MarketState.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ArbitrageDetector;
+class MarketDataGateway;
+class MarketUpdatePipeline;
+class OpportunityJournal;
+class PrometheusWriter;
+class WebSocketClient;
+
+// Prometheus view of the running engine
+// Every value comes from a relaxed counter, OrderBook::activity() or the
+// detector's published results, so a scrape never takes a lock the feed or
+// detection threads contend on. MarketState's lock is taken only when the
+// book count grew since the previous scrape.
+class EngineMetrics {
+public:
+    EngineMetrics(const MarketState& market_state, const ArbitrageDetector& detector);
+    
+    // Optional sources; must be added before the metrics thread starts and outlive it
+    void addFeed(const WebSocketClient* client);
+    void setPipeline(const MarketUpdatePipeline* pipeline);
+    void setJournal(const OpportunityJournal* journal);
+    void setGateway(const MarketDataGateway* gateway);
+    
+    // Metrics thread only
+    void write(PrometheusWriter& writer);
+
+private:
+    void writeBooks(PrometheusWriter& writer);
+    void writeDetector(PrometheusWriter& writer);
+    void writeFeeds(PrometheusWriter& writer);
+    void writeQueues(PrometheusWriter& writer);
+    void writeLatency(PrometheusWriter& writer);
+    void writeLocks(PrometheusWriter& writer);
+    
+    const MarketState& market_state_;
+    const ArbitrageDetector& detector_;
+    std::vector<const WebSocketClient*> feeds_;
+    const MarketUpdatePipeline* pipeline_ = nullptr;
+    const OpportunityJournal* journal_ = nullptr;
+    const MarketDataGateway* gateway_ = nullptr;
+    
+    // Metrics thread caches
+    std::vector<std::pair<std::string, const OrderBook*>> books_;
+    std::vector<std::string> route_names_;  // Indexed by route id
+    uint64_t route_names_version_ = 0;      // Route table route_names_ was built for; 0 is the empty table
+};
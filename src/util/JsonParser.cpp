@@ -1,10 +1,12 @@
 #include "JsonParser.hpp"
+#include "src/config/ExchangeInfo.hpp"
 #include <algorithm>
+#include <charconv>
 #include <sstream>
 #include <iomanip>
 #include <vector>
 
-BookTickerData JsonParser::parseBookTicker(const std::string& json) {
+BookTickerData JsonParser::parseBookTicker(const std::string& json, const SymbolUniverse* universe) {
     BookTickerData data;
     
     // Extract symbol
@@ -12,7 +14,10 @@ BookTickerData JsonParser::parseBookTicker(const std::string& json) {
     if (!symbol_opt.has_value()) {
         return data; // invalid
     }
-    data.symbol = normalizeSymbol(symbol_opt.value());
+    data.symbol = normalizeSymbol(symbol_opt.value(), universe);
+    
+    // Update id is optional (not part of every stream payload)
+    data.update_id = extractIntegerField(json, "u").value_or(0);
     
     // Extract bid price
     auto bid_price_opt = extractNumericField(json, "b");
@@ -52,7 +57,15 @@ BookTickerData JsonParser::parseBookTicker(const std::string& json) {
     return data;
 }
 
-std::string JsonParser::normalizeSymbol(const std::string& symbol) {
+std::string JsonParser::normalizeSymbol(const std::string& symbol, const SymbolUniverse* universe) {
+    // Exact base/quote split from exchangeInfo when loaded
+    if (universe != nullptr) {
+        const SymbolInfo* info = universe->findBySymbol(symbol);
+        if (info != nullptr) {
+            return info->pair();
+        }
+    }
+    
     // Common quote currencies to detect
     const std::vector<std::string> quote_currencies = {
         "USDT", "USDC", "FDUSD", "TUSD", "BTC", "ETH", "EUR", "TRY", "BNB", "BUSD"
@@ -138,6 +151,23 @@ std::optional<double> JsonParser::extractNumericField(const std::string& json, c
     return stringToDouble(value_str);
 }
 
+std::optional<uint64_t> JsonParser::extractIntegerField(const std::string& json, const std::string& field_name) {
+    std::string pattern = "\"" + field_name + "\":";
+    size_t pos = json.find(pattern);
+    if (pos == std::string::npos) {
+        return std::nullopt;
+    }
+    
+    const char* first = json.data() + pos + pattern.length();
+    const char* last = json.data() + json.size();
+    uint64_t value = 0;
+    auto result = std::from_chars(first, last, value);
+    if (result.ec != std::errc()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
 double JsonParser::stringToDouble(const std::string& str) {
     try {
         return std::stod(str);
@@ -1,29 +1,35 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <optional>
 
+class SymbolUniverse;
+
 // Simple JSON parser for Binance bookTicker messages
 // Format: {"u":123,"s":"ARBUSDT","b":"0.19700000","B":"216197.40000000","a":"0.19710000","A":"12194.70000000"}
 
 struct BookTickerData {
     std::string symbol;
+    uint64_t update_id;  // "u", 0 if absent
     double bid_price;
     double bid_qty;
     double ask_price;
     double ask_qty;
     bool valid;
 
-    BookTickerData() : bid_price(0.0), bid_qty(0.0), ask_price(0.0), ask_qty(0.0), valid(false) {}
+    BookTickerData() : update_id(0), bid_price(0.0), bid_qty(0.0), ask_price(0.0), ask_qty(0.0), valid(false) {}
 };
 
 class JsonParser {
 public:
     // Parse bookTicker JSON message
-    static BookTickerData parseBookTicker(const std::string& json);
+    // If a universe is given, symbols are normalized from its base/quote table
+    static BookTickerData parseBookTicker(const std::string& json, const SymbolUniverse* universe = nullptr);
     
     // Normalize symbol: "ARBUSDT" -> "ARB/USDT"
-    static std::string normalizeSymbol(const std::string& symbol);
+    // Uses the universe when available, otherwise guesses from known quote suffixes
+    static std::string normalizeSymbol(const std::string& symbol, const SymbolUniverse* universe = nullptr);
 
 private:
     // Extract string field from JSON
@@ -32,6 +38,9 @@ private:
     // Extract numeric field from JSON and convert to double
     static std::optional<double> extractNumericField(const std::string& json, const std::string& field_name);
     
+    // Extract unsigned integer field ("u":123), exact for 64-bit ids
+    static std::optional<uint64_t> extractIntegerField(const std::string& json, const std::string& field_name);
+    
     // Safe string to double conversion
     static double stringToDouble(const std::string& str);
 };
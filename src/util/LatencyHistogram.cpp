@@ -0,0 +1,141 @@
+#include "LatencyHistogram.hpp"
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+LatencyHistogram::LatencyHistogram()
+    : max_ns_(0) {
+    for (auto& bucket : counts_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) {
+    if (index < 2 * SUB_BUCKET_COUNT) {
+        return index;
+    }
+    size_t shift = index / SUB_BUCKET_COUNT - 1;
+    return static_cast<uint64_t>(index - shift * SUB_BUCKET_COUNT) << shift;
+}
+
+void LatencyHistogram::mergeInto(HistogramSnapshot& snapshot) const {
+    if (snapshot.counts.size() != BUCKET_COUNT) {
+        snapshot.counts.assign(BUCKET_COUNT, 0);
+    }
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        uint64_t count = counts_[i].load(std::memory_order_relaxed);
+        snapshot.counts[i] += count;
+        snapshot.total += count;
+    }
+    uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+    if (max_ns > snapshot.max_ns) {
+        snapshot.max_ns = max_ns;
+    }
+}
+
+uint64_t HistogramSnapshot::percentile(double q) const {
+    if (total == 0) {
+        return 0;
+    }
+    
+    // Nearest-rank: the smallest value with at least q of the samples at or below it
+    // (1-based); the epsilon keeps q * total that is an integer up to rounding from
+    // being pushed one rank up
+    double exact_rank = std::ceil(q * static_cast<double>(total) - 1e-9);
+    uint64_t rank = exact_rank < 1.0 ? 1 : static_cast<uint64_t>(exact_rank);
+    if (rank > total) {
+        rank = total;
+    }
+    
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return LatencyHistogram::bucketLowerBound(i);
+        }
+    }
+    return max_ns;
+}
+
+HistogramSnapshot HistogramSnapshot::since(const HistogramSnapshot& earlier) const {
+    HistogramSnapshot delta = *this;
+    if (earlier.counts.size() != counts.size()) {
+        return delta;
+    }
+    delta.total = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        delta.counts[i] = counts[i] >= earlier.counts[i] ? counts[i] - earlier.counts[i] : 0;
+        delta.total += delta.counts[i];
+    }
+    return delta;
+}
+
+namespace {
+    // Histograms owned by one recording thread
+    struct ThreadHistograms {
+        std::array<LatencyHistogram, PIPELINE_STAGE_COUNT> stages;
+    };
+    
+    // Every thread set ever created; kept after the thread exits so totals stay cumulative
+    std::mutex& registryMutex() {
+        static std::mutex mutex;
+        return mutex;
+    }
+    
+    std::vector<std::unique_ptr<ThreadHistograms>>& registry() {
+        static std::vector<std::unique_ptr<ThreadHistograms>> threads;
+        return threads;
+    }
+    
+    ThreadHistograms& localHistograms() {
+        thread_local ThreadHistograms* local = nullptr;
+        if (local == nullptr) {
+            auto owned = std::make_unique<ThreadHistograms>();
+            local = owned.get();
+            std::lock_guard<std::mutex> lock(registryMutex());
+            registry().push_back(std::move(owned));
+        }
+        return *local;
+    }
+}
+
+uint64_t PipelineLatency::nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void PipelineLatency::record(PipelineStage stage, uint64_t elapsed_ns) {
+    localHistograms().stages[static_cast<size_t>(stage)].record(elapsed_ns);
+}
+
+std::array<HistogramSnapshot, PIPELINE_STAGE_COUNT> PipelineLatency::merge() {
+    std::array<HistogramSnapshot, PIPELINE_STAGE_COUNT> merged;
+    std::lock_guard<std::mutex> lock(registryMutex());
+    for (const auto& thread : registry()) {
+        for (size_t stage = 0; stage < PIPELINE_STAGE_COUNT; ++stage) {
+            thread->stages[stage].mergeInto(merged[stage]);
+        }
+    }
+    return merged;
+}
+
+const char* PipelineLatency::stageName(PipelineStage stage) {
+    switch (stage) {
+        case PipelineStage::Parse:
+            return "parse";
+        case PipelineStage::BookUpdate:
+            return "book_update";
+        case PipelineStage::Detect:
+            return "detect";
+        case PipelineStage::ReceiveToDetect:
+            return "receive_to_detect";
+        case PipelineStage::ReceiveToEmit:
+            return "receive_to_emit";
+        case PipelineStage::RingWait:
+            return "ring_wait";
+        case PipelineStage::Count:
+        default:
+            return "unknown";
+    }
+}
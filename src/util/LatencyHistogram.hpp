@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Stages of the market data pipeline, measured on the thread that runs them
+enum class PipelineStage : uint8_t {
+    Parse,            // Frame received -> parsed
+    BookUpdate,       // Parsed -> order book updated
+    Detect,           // Book updated -> detector evaluated (update callback)
+    ReceiveToDetect,  // Frame received -> detector evaluated
+    ReceiveToEmit,    // Frame received -> event-path opportunity emitted (opportunity callback returned)
+    RingWait,         // Parsed -> drained by the market-state thread (SPSC pipeline only)
+    Count
+};
+
+constexpr size_t PIPELINE_STAGE_COUNT = static_cast<size_t>(PipelineStage::Count);
+
+// Merged bucket counts of one stage; plain data, owned by the reader
+struct HistogramSnapshot {
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t max_ns = 0;
+    
+    // Value at quantile q (0..1) in nanoseconds, bucket lower bound
+    uint64_t percentile(double q) const;
+    
+    // Counts recorded since an earlier snapshot of the same histogram
+    HistogramSnapshot since(const HistogramSnapshot& earlier) const;
+};
+
+// HDR-style log-linear histogram of nanosecond values
+// 32 sub-buckets per power of two (~3% relative error) up to 2^40 ns.
+// Single writer, any number of readers: the writer never takes a lock or
+// issues a locked read-modify-write, readers see relaxed counts.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t SUB_BUCKET_COUNT = 1ULL << SUB_BUCKET_BITS;
+    static constexpr int MAX_VALUE_BITS = 40;
+    static constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+    
+    LatencyHistogram();
+    
+    // Owning thread only
+    void record(uint64_t value_ns) {
+        auto& bucket = counts_[bucketIndex(value_ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if (value_ns > max_ns_.load(std::memory_order_relaxed)) {
+            max_ns_.store(value_ns, std::memory_order_relaxed);
+        }
+    }
+    
+    // Add this histogram's counts to a snapshot (any thread)
+    void mergeInto(HistogramSnapshot& snapshot) const;
+    
+    static size_t bucketIndex(uint64_t value_ns);
+    static uint64_t bucketLowerBound(size_t index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts_;
+    std::atomic<uint64_t> max_ns_;
+};
+
+// Process-wide pipeline latency recorder
+// Each recording thread lazily gets its own set of histograms; summarize()
+// merges all of them. Registration is the only step that takes a lock.
+class PipelineLatency {
+public:
+    // Monotonic clock in nanoseconds, used for every stage timestamp
+    static uint64_t nowNs();
+    
+    static void record(PipelineStage stage, uint64_t elapsed_ns);
+    
+    // Cumulative merge over every thread, indexed by stage
+    static std::array<HistogramSnapshot, PIPELINE_STAGE_COUNT> merge();
+    
+    static const char* stageName(PipelineStage stage);
+};
+
+inline size_t LatencyHistogram::bucketIndex(uint64_t value_ns) {
+    // Values below 2 * SUB_BUCKET_COUNT map 1:1
+    if (value_ns < 2 * SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value_ns);
+    }
+
+#ifdef _MSC_VER
+    unsigned long msb = 0;
+    _BitScanReverse64(&msb, value_ns);
+    int bits = static_cast<int>(msb) + 1;
+#else
+    int bits = 64 - __builtin_clzll(value_ns);
+#endif
+    if (bits > MAX_VALUE_BITS) {
+        return BUCKET_COUNT - 1;
+    }
+    int shift = bits - 1 - SUB_BUCKET_BITS;
+    return static_cast<size_t>(shift * SUB_BUCKET_COUNT + (value_ns >> shift));
+}
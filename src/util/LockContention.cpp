@@ -0,0 +1,37 @@
+#include "LockContention.hpp"
+#include <array>
+
+namespace {
+    struct alignas(64) SiteCounters {
+        std::atomic<uint64_t> contended{0};
+        std::atomic<uint64_t> wait_ns{0};
+    };
+    
+    std::array<SiteCounters, LOCK_SITE_COUNT> site_counters;
+}
+
+void LockContention::record(LockSite site, uint64_t wait_ns) {
+    SiteCounters& counters = site_counters[static_cast<size_t>(site)];
+    counters.contended.fetch_add(1, std::memory_order_relaxed);
+    counters.wait_ns.fetch_add(wait_ns, std::memory_order_relaxed);
+}
+
+LockContentionStats LockContention::get(LockSite site) {
+    const SiteCounters& counters = site_counters[static_cast<size_t>(site)];
+    LockContentionStats stats;
+    stats.contended = counters.contended.load(std::memory_order_relaxed);
+    stats.wait_ns = counters.wait_ns.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const char* LockContention::siteName(LockSite site) {
+    switch (site) {
+        case LockSite::MarketState:
+            return "market_state";
+        case LockSite::OrderBook:
+            return "order_book";
+        case LockSite::Count:
+        default:
+            return "unknown";
+    }
+}
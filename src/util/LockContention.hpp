@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// Locks on the market-data path whose contention is counted process-wide
+enum class LockSite : uint8_t {
+    MarketState,  // MarketState symbol map (get, getSymbolId, getBooks)
+    OrderBook,    // Per-book lock, all books together
+    Count
+};
+
+constexpr size_t LOCK_SITE_COUNT = static_cast<size_t>(LockSite::Count);
+
+// Acquisitions that had to wait, and the total time spent waiting
+struct LockContentionStats {
+    uint64_t contended = 0;
+    uint64_t wait_ns = 0;
+};
+
+class LockContention {
+public:
+    // Called only after a failed try_lock, so the shared counters stay off the uncontended path
+    static void record(LockSite site, uint64_t wait_ns);
+    
+    // Cumulative since start; relaxed, any thread
+    static LockContentionStats get(LockSite site);
+    
+    static const char* siteName(LockSite site);
+};
+
+// std::mutex that counts waiting acquisitions for its site
+// An uncontended lock() is a single try_lock; only a lock that has to wait
+// reads the clock and adds to the site counters
+template <LockSite Site>
+class CountingMutex {
+public:
+    void lock() {
+        if (mutex_.try_lock()) {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        mutex_.lock();
+        LockContention::record(Site, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+    }
+    
+    bool try_lock() { return mutex_.try_lock(); }
+    void unlock() { mutex_.unlock(); }
+
+private:
+    std::mutex mutex_;
+};
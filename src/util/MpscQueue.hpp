@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// Bounded lock-free multi-producer single-consumer queue (Vyukov ring)
+// Every slot carries a sequence number; producers claim a slot with one CAS
+// on the tail and publish it by bumping the slot sequence. tryPush never
+// blocks: when the ring is full it returns false and the caller decides.
+template <typename T>
+class MpscQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "MpscQueue holds plain records");
+
+public:
+    // capacity is rounded up to a power of two
+    explicit MpscQueue(size_t capacity)
+        : mask_(roundUp(capacity) - 1),
+          slots_(new Slot[mask_ + 1]),
+          head_(0),
+          tail_(0) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+    
+    // Any thread
+    bool tryPush(const T& value) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // Full
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    // Consumer thread only
+    bool tryPop(T& value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[head & mask_];
+        size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != head + 1) {
+            return false; // Empty, or the producer has not published yet
+        }
+        value = slot.value;
+        slot.sequence.store(head + mask_ + 1, std::memory_order_release);
+        head_.store(head + 1, std::memory_order_relaxed);
+        return true;
+    }
+    
+    // Any thread; approximate while producers or the consumer are active
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+    
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+    
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+    
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> head_;  // Consumer position, written by the consumer only
+    alignas(64) std::atomic<size_t> tail_;  // Producer claim position
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+// Strict number parsing for command-line values
+// The whole string must be the number: unlike atoi/atof a typo never silently
+// becomes 0, and unlike stoi/stod nothing throws.
+class NumberParser {
+public:
+    // Integer in [min_value, max_value]; nullopt on junk, overflow or out of range
+    static std::optional<int64_t> parseInteger(std::string_view text, int64_t min_value, int64_t max_value) {
+        int64_t value = 0;
+        const char* last = text.data() + text.size();
+        auto result = std::from_chars(text.data(), last, value);
+        if (text.empty() || result.ec != std::errc() || result.ptr != last || value < min_value || value > max_value) {
+            return std::nullopt;
+        }
+        return value;
+    }
+    
+    // Finite decimal in [min_value, max_value]; nullopt on junk, overflow or out of range
+    static std::optional<double> parseDouble(std::string_view text, double min_value, double max_value) {
+        double value = 0.0;
+        const char* last = text.data() + text.size();
+        auto result = std::from_chars(text.data(), last, value);
+        if (text.empty() || result.ec != std::errc() || result.ptr != last || !std::isfinite(value) ||
+            value < min_value || value > max_value) {
+            return std::nullopt;
+        }
+        return value;
+    }
+};
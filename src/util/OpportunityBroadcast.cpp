@@ -0,0 +1,75 @@
+#include "OpportunityBroadcast.hpp"
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <cstring>
+
+namespace bip = boost::interprocess;
+
+std::optional<OpportunitySubscriber> OpportunitySubscriber::open(const std::string& name, bool from_oldest) {
+    OpportunitySubscriber subscriber;
+    try {
+        bip::shared_memory_object shm(bip::open_only, name.c_str(), bip::read_only);
+        subscriber.region_ = std::make_shared<bip::mapped_region>(shm, bip::read_only);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+    
+    const auto* base = static_cast<const char*>(subscriber.region_->get_address());
+    size_t size = subscriber.region_->get_size();
+    if (size < sizeof(OpportunityBroadcastHeader)) {
+        return std::nullopt;
+    }
+    
+    const auto* header = reinterpret_cast<const OpportunityBroadcastHeader*>(base);
+    if (std::memcmp(header->magic, OPPORTUNITY_BROADCAST_MAGIC, sizeof(OPPORTUNITY_BROADCAST_MAGIC)) != 0 ||
+        header->version != OPPORTUNITY_BROADCAST_VERSION ||
+        header->message_size != sizeof(OpportunityMessage) ||
+        header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0 ||
+        sizeof(OpportunityBroadcastHeader) + header->capacity * sizeof(OpportunityBroadcastSlot) > size) {
+        return std::nullopt;
+    }
+    
+    subscriber.header_ = header;
+    subscriber.slots_ = reinterpret_cast<const OpportunityBroadcastSlot*>(base + sizeof(OpportunityBroadcastHeader));
+    subscriber.mask_ = header->capacity - 1;
+    
+    uint64_t latest = header->published.load(std::memory_order_acquire);
+    if (from_oldest) {
+        subscriber.cursor_ = latest >= header->capacity ? latest - header->capacity + 1 : 1;
+    } else {
+        subscriber.cursor_ = latest + 1;
+    }
+    return subscriber;
+}
+
+BroadcastPoll OpportunitySubscriber::poll(OpportunityMessage& message) {
+    const OpportunityBroadcastSlot& slot = slots_[cursor_ & mask_];
+    uint64_t expected = 2 * cursor_;
+    
+    uint64_t before = slot.version.load(std::memory_order_acquire);
+    if (before < expected) {
+        return BroadcastPoll::Empty; // Older message, or ours is still being written
+    }
+    
+    if (before == expected) {
+        uint64_t words[OPPORTUNITY_MESSAGE_WORDS];
+        for (size_t i = 0; i < OPPORTUNITY_MESSAGE_WORDS; ++i) {
+            words[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) == expected) {
+            std::memcpy(&message, words, sizeof(message));
+            ++cursor_;
+            return BroadcastPoll::Message;
+        }
+    }
+    
+    // Lapped: resume half a ring behind the writer so the next reads have slack
+    uint64_t latest = header_->published.load(std::memory_order_acquire);
+    uint64_t resume = latest + 1 > header_->capacity / 2 ? latest + 1 - header_->capacity / 2 : 1;
+    if (resume <= cursor_) {
+        resume = cursor_ + 1;
+    }
+    lost_ += resume - cursor_;
+    cursor_ = resume;
+    return BroadcastPoll::Overrun;
+}
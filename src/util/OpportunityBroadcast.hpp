@@ -0,0 +1,98 @@
+#pragma once
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+// Shared-memory broadcast ring of opportunity records (native layout, same host only)
+//   OpportunityBroadcastHeader | OpportunityBroadcastSlot[capacity]
+// The engine is the only writer and never waits for readers. Sequence n
+// (1-based) lives in slot n % capacity; every slot carries a version that is
+// 2n - 1 while message n is being written and 2n once it is complete, so a
+// reader knows whether its slot holds the message it expects, an older one
+// (not yet published) or a newer one (the writer lapped it: overrun).
+// On Linux the segment is /dev/shm/<name>.
+constexpr char OPPORTUNITY_BROADCAST_MAGIC[8] = {'A', 'R', 'B', 'B', 'C', 'S', 'T', '1'};
+constexpr uint32_t OPPORTUNITY_BROADCAST_VERSION = 1;
+
+// One opportunity, self-contained: legs are symbol names, not engine ids
+struct OpportunityMessage {
+    uint64_t sequence;      // Broadcast sequence, 1-based, no gaps
+    uint64_t publish_ns;    // Monotonic clock (steady_clock) when written
+    uint64_t receive_ns;    // Monotonic clock when the triggering frame was read; 0 if unknown
+    int64_t timestamp_ms;   // Wall clock, epoch ms
+    uint32_t route_id;      // Engine route table index
+    uint8_t kind;           // RouteKind
+    int8_t direction;       // 1 or 2
+    uint16_t reserved;
+    double profit_percent;
+    double max_tradable_amount;
+    double arb_usdt_bid;
+    double arb_usdt_ask;
+    double arb_other_bid;
+    double arb_other_ask;
+    double other_usdt_bid;
+    double other_usdt_ask;
+    char legs[3][24];       // "ARB/USDT", NUL terminated; same order as ArbitrageOpportunity::legs
+};
+
+static_assert(sizeof(OpportunityMessage) == 176, "OpportunityMessage layout is part of the broadcast format");
+
+constexpr size_t OPPORTUNITY_MESSAGE_WORDS = sizeof(OpportunityMessage) / sizeof(uint64_t);
+
+// The payload is copied word by word through relaxed atomics so that a
+// reader racing the writer sees torn data only, never undefined behavior
+struct alignas(64) OpportunityBroadcastSlot {
+    std::atomic<uint64_t> version;
+    std::atomic<uint64_t> words[OPPORTUNITY_MESSAGE_WORDS];
+};
+
+struct OpportunityBroadcastHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t message_size;
+    uint64_t capacity;         // Slots, a power of two
+    int64_t created_time_ns;   // Wall clock, epoch ns
+    alignas(64) std::atomic<uint64_t> published;  // Last complete sequence, 0 before the first
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared-memory counters must be lock-free");
+
+enum class BroadcastPoll {
+    Empty,    // Nothing new yet
+    Message,  // message holds the next sequence
+    Overrun   // The writer lapped this reader; the cursor moved forward, see getLostCount()
+};
+
+// Consumer side, for any number of local processes
+// Wait-free: poll() reads a few words of shared memory and never blocks or
+// retries. Each subscriber keeps its own cursor; the writer does not know
+// about readers.
+class OpportunitySubscriber {
+public:
+    // Attach to a running broadcast; starts after the latest message,
+    // or at the oldest message still in the ring with from_oldest
+    static std::optional<OpportunitySubscriber> open(const std::string& name, bool from_oldest = false);
+    
+    BroadcastPoll poll(OpportunityMessage& message);
+    
+    uint64_t nextSequence() const { return cursor_; }
+    uint64_t latestSequence() const { return header_->published.load(std::memory_order_acquire); }
+    uint64_t capacity() const { return header_->capacity; }
+    
+    // Messages skipped because of overruns
+    uint64_t getLostCount() const { return lost_; }
+
+private:
+    OpportunitySubscriber() = default;
+    
+    std::shared_ptr<boost::interprocess::mapped_region> region_;
+    const OpportunityBroadcastHeader* header_ = nullptr;
+    const OpportunityBroadcastSlot* slots_ = nullptr;
+    uint64_t mask_ = 0;
+    uint64_t cursor_ = 1;  // Next sequence to read
+    uint64_t lost_ = 0;
+};
@@ -0,0 +1,119 @@
+#include "OpportunityBroadcaster.hpp"
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <new>
+
+namespace bip = boost::interprocess;
+
+namespace {
+    uint64_t roundUp(uint64_t capacity) {
+        uint64_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+}
+
+std::unique_ptr<OpportunityBroadcaster> OpportunityBroadcaster::create(const std::string& name,
+                                                                       const MarketState& market_state,
+                                                                       uint64_t capacity) {
+    try {
+        return std::unique_ptr<OpportunityBroadcaster>(new OpportunityBroadcaster(name, market_state, capacity));
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+OpportunityBroadcaster::OpportunityBroadcaster(const std::string& name, const MarketState& market_state,
+                                               uint64_t capacity)
+    : name_(name),
+      market_state_(market_state),
+      mask_(roundUp(capacity) - 1),
+      header_(nullptr),
+      slots_(nullptr),
+      sequence_(0) {
+    // A segment left behind by a crashed engine is replaced, not reused
+    bip::shared_memory_object::remove(name.c_str());
+    shm_ = bip::shared_memory_object(bip::create_only, name.c_str(), bip::read_write);
+    shm_.truncate(static_cast<bip::offset_t>(sizeof(OpportunityBroadcastHeader) +
+                                             (mask_ + 1) * sizeof(OpportunityBroadcastSlot)));
+    region_ = bip::mapped_region(shm_, bip::read_write);
+    
+    auto* base = static_cast<char*>(region_.get_address());
+    header_ = new (base) OpportunityBroadcastHeader();
+    slots_ = reinterpret_cast<OpportunityBroadcastSlot*>(base + sizeof(OpportunityBroadcastHeader));
+    for (uint64_t i = 0; i <= mask_; ++i) {
+        new (&slots_[i]) OpportunityBroadcastSlot();
+        slots_[i].version.store(0, std::memory_order_relaxed);
+    }
+    
+    header_->published.store(0, std::memory_order_relaxed);
+    header_->version = OPPORTUNITY_BROADCAST_VERSION;
+    header_->message_size = sizeof(OpportunityMessage);
+    header_->capacity = mask_ + 1;
+    header_->created_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    // Readers check the magic last: a valid magic means a complete header
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header_->magic, OPPORTUNITY_BROADCAST_MAGIC, sizeof(OPPORTUNITY_BROADCAST_MAGIC));
+}
+
+OpportunityBroadcaster::~OpportunityBroadcaster() {
+    bip::shared_memory_object::remove(name_.c_str());
+}
+
+const std::array<char, 24>& OpportunityBroadcaster::legName(SymbolId symbol_id) {
+    if (symbol_id >= leg_names_.size()) {
+        leg_names_.resize(symbol_id + 1, std::array<char, 24>{});
+    }
+    std::array<char, 24>& entry = leg_names_[symbol_id];
+    if (entry[0] == '\0') {
+        const std::string& name = market_state_.getSymbolName(symbol_id);
+        size_t length = std::min(name.size(), entry.size() - 1);
+        std::memcpy(entry.data(), name.data(), length);
+        entry[length] = '\0';
+    }
+    return entry;
+}
+
+void OpportunityBroadcaster::publish(const ArbitrageOpportunity& opp, uint64_t receive_ns, int64_t timestamp_ms) {
+    OpportunityMessage message{};
+    message.sequence = sequence_ + 1;
+    message.receive_ns = receive_ns;
+    message.timestamp_ms = timestamp_ms;
+    message.route_id = opp.route_id;
+    message.kind = static_cast<uint8_t>(opp.kind);
+    message.direction = static_cast<int8_t>(opp.direction);
+    message.profit_percent = opp.profit_percent;
+    message.max_tradable_amount = opp.max_tradable_amount;
+    message.arb_usdt_bid = opp.arb_usdt_bid;
+    message.arb_usdt_ask = opp.arb_usdt_ask;
+    message.arb_other_bid = opp.arb_other_bid;
+    message.arb_other_ask = opp.arb_other_ask;
+    message.other_usdt_bid = opp.other_usdt_bid;
+    message.other_usdt_ask = opp.other_usdt_ask;
+    size_t leg_count = opp.kind == RouteKind::DirectComparison ? 2 : 3;
+    for (size_t leg = 0; leg < leg_count; ++leg) {
+        std::memcpy(message.legs[leg], legName(opp.legs[leg]).data(), sizeof(message.legs[leg]));
+    }
+    message.publish_ns = PipelineLatency::nowNs();
+    
+    uint64_t words[OPPORTUNITY_MESSAGE_WORDS];
+    std::memcpy(words, &message, sizeof(message));
+    
+    // Odd version while the payload is in flux, even once it is complete
+    OpportunityBroadcastSlot& slot = slots_[message.sequence & mask_];
+    slot.version.store(2 * message.sequence - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < OPPORTUNITY_MESSAGE_WORDS; ++i) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.version.store(2 * message.sequence, std::memory_order_release);
+    
+    sequence_ = message.sequence;
+    header_->published.store(sequence_, std::memory_order_release);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "OpportunityBroadcast.hpp"
+#include "src/core/ArbitrageDetector.hpp"
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Engine side of the shared-memory opportunity ring (see OpportunityBroadcast.hpp)
+// publish() copies one record into the next slot and bumps the sequence:
+// no locks, no syscalls, never waits for readers. Leg symbol names are
+// resolved through MarketState once per symbol and cached.
+class OpportunityBroadcaster {
+public:
+    // Create (replace) the named segment with capacity slots, rounded up to
+    // a power of two; nullptr on failure
+    static std::unique_ptr<OpportunityBroadcaster> create(const std::string& name, const MarketState& market_state,
+                                                          uint64_t capacity = 4096);
+    
+    // Removes the name; readers that are attached keep their mapping
+    ~OpportunityBroadcaster();
+    
+    OpportunityBroadcaster(const OpportunityBroadcaster&) = delete;
+    OpportunityBroadcaster& operator=(const OpportunityBroadcaster&) = delete;
+    
+    // One thread at a time (the detector calls it under its trigger lock)
+    void publish(const ArbitrageOpportunity& opp, uint64_t receive_ns, int64_t timestamp_ms);
+    
+    uint64_t getPublishedCount() const { return sequence_; }
+    const std::string& getName() const { return name_; }
+
+private:
+    OpportunityBroadcaster(const std::string& name, const MarketState& market_state, uint64_t capacity);
+    
+    const std::array<char, 24>& legName(SymbolId symbol_id);
+    
+    std::string name_;
+    const MarketState& market_state_;
+    uint64_t mask_;
+    boost::interprocess::shared_memory_object shm_;
+    boost::interprocess::mapped_region region_;
+    OpportunityBroadcastHeader* header_;
+    OpportunityBroadcastSlot* slots_;
+    uint64_t sequence_;  // Last published
+    
+    std::vector<std::array<char, 24>> leg_names_;  // Indexed by SymbolId, empty name until resolved
+};
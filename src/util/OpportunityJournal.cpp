@@ -0,0 +1,271 @@
+#include "OpportunityJournal.hpp"
+#include "src/core/OpportunityFormatter.hpp"
+#include <algorithm>
+#include <charconv>
+#include <ctime>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+    // Append helpers over the batch buffer; no streams, no locale
+    void appendInt(std::string& out, int64_t value) {
+        char buffer[24];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    }
+    
+    void appendDouble(std::string& out, double value) {
+        char buffer[64];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, 8);
+        if (result.ec != std::errc()) {
+            out += '0';
+            return;
+        }
+        out.append(buffer, result.ptr);
+    }
+    
+    void appendKey(std::string& out, const char* key) {
+        out += ", \"";
+        out += key;
+        out += "\": ";
+    }
+    
+    void appendString(std::string& out, const char* key, const std::string& value) {
+        appendKey(out, key);
+        out += '"';
+        out += value;
+        out += '"';
+    }
+    
+    void appendPrices(std::string& out, const char* key, const ArbitrageOpportunity& opp) {
+        appendKey(out, key);
+        out += "{\"arb_usdt_bid\": ";
+        appendDouble(out, opp.arb_usdt_bid);
+        appendKey(out, "arb_usdt_ask");
+        appendDouble(out, opp.arb_usdt_ask);
+        appendKey(out, "arb_other_bid");
+        appendDouble(out, opp.arb_other_bid);
+        appendKey(out, "arb_other_ask");
+        appendDouble(out, opp.arb_other_ask);
+        appendKey(out, "other_usdt_bid");
+        appendDouble(out, opp.other_usdt_bid);
+        appendKey(out, "other_usdt_ask");
+        appendDouble(out, opp.other_usdt_ask);
+        out += '}';
+    }
+    
+    constexpr size_t BATCH_FLUSH_BYTES = 64 * 1024;
+}
+
+OpportunityJournal::OpportunityJournal(const MarketState& market_state, JournalConfig config)
+    : market_state_(market_state),
+      config_(std::move(config)),
+      queue_(config_.queue_capacity),
+      running_(true),
+      written_(0),
+      dropped_(0),
+      file_(nullptr),
+      file_bytes_(0),
+      unsynced_(false) {
+    batch_.reserve(2 * BATCH_FLUSH_BYTES);
+    writer_ = std::thread(&OpportunityJournal::run, this);
+}
+
+OpportunityJournal::~OpportunityJournal() {
+    stop();
+}
+
+bool OpportunityJournal::appendOpportunity(const ArbitrageOpportunity& opp, int64_t timestamp_ms) {
+    Entry entry;
+    entry.type = EntryType::Opportunity;
+    entry.timestamp_ms = timestamp_ms;
+    entry.episode.peak = opp;
+    if (!queue_.tryPush(entry)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool OpportunityJournal::appendEpisode(const OpportunityEpisode& episode) {
+    Entry entry;
+    entry.type = EntryType::Episode;
+    entry.timestamp_ms = episode.close_ms;
+    entry.episode = episode;
+    if (!queue_.tryPush(entry)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void OpportunityJournal::stop() {
+    running_ = false;
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+}
+
+void OpportunityJournal::run() {
+    last_fsync_ = std::chrono::steady_clock::now();
+    Entry entry;
+    
+    for (;;) {
+        // Read the flag before draining so nothing queued before stop() is lost
+        bool running = running_.load();
+        
+        while (queue_.tryPop(entry)) {
+            formatEntry(entry);
+            if (batch_.size() >= BATCH_FLUSH_BYTES) {
+                writeBatch();
+            }
+        }
+        writeBatch();
+        maybeSync();
+        
+        if (!running) {
+            break;
+        }
+        std::this_thread::sleep_for(config_.idle_sleep);
+    }
+    
+    closeFile();
+}
+
+void OpportunityJournal::formatEntry(const Entry& entry) {
+    const OpportunityEpisode& episode = entry.episode;
+    const ArbitrageOpportunity& opp = episode.peak;
+    
+    batch_ += "{\"type\": \"";
+    batch_ += entry.type == EntryType::Episode ? "episode" : "opportunity";
+    batch_ += "\", \"timestamp_ms\": ";
+    appendInt(batch_, entry.timestamp_ms);
+    
+    if (entry.type == EntryType::Episode) {
+        appendKey(batch_, "open_timestamp_ms");
+        appendInt(batch_, episode.open_ms);
+        appendKey(batch_, "duration_ms");
+        appendInt(batch_, episode.durationMs());
+        appendKey(batch_, "observations");
+        appendInt(batch_, episode.observations);
+    }
+    
+    appendString(batch_, "source", opp.source == OpportunitySource::UniverseScan ? "scan" : "detector");
+    appendKey(batch_, "direction");
+    appendInt(batch_, opp.direction);
+    appendString(batch_, "route_name", OpportunityFormatter::routeName(opp, market_state_));
+    appendString(batch_, "trade_sequence", OpportunityFormatter::tradeSequence(opp, market_state_));
+    
+    if (entry.type == EntryType::Episode) {
+        appendKey(batch_, "entry_profit_percent");
+        appendDouble(batch_, episode.entry.profit_percent);
+        appendKey(batch_, "peak_profit_percent");
+        appendDouble(batch_, opp.profit_percent);
+        appendKey(batch_, "peak_max_tradable_amount");
+        appendDouble(batch_, episode.peak_tradable_amount);
+    } else {
+        appendKey(batch_, "profit_percent");
+        appendDouble(batch_, opp.profit_percent);
+        appendKey(batch_, "max_tradable_amount");
+        appendDouble(batch_, opp.max_tradable_amount);
+    }
+    
+    appendString(batch_, "max_tradable_currency", OpportunityFormatter::tradableCurrency(opp, market_state_));
+    appendPrices(batch_, entry.type == EntryType::Episode ? "peak_prices" : "prices", opp);
+    batch_ += "}\n";
+}
+
+void OpportunityJournal::writeBatch() {
+    if (batch_.empty()) {
+        return;
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    bool rotate_size = config_.rotate_bytes > 0 && file_bytes_ + batch_.size() > config_.rotate_bytes && file_bytes_ > 0;
+    bool rotate_time = config_.rotate_interval.count() > 0 && file_ != nullptr && now - file_opened_ >= config_.rotate_interval;
+    if (file_ == nullptr || rotate_size || rotate_time) {
+        closeFile();
+        openFile();
+    }
+    
+    if (file_ == nullptr) {
+        // Silent failure - don't spam console; the batch is lost
+        batch_.clear();
+        return;
+    }
+    
+    size_t lines = static_cast<size_t>(std::count(batch_.begin(), batch_.end(), '\n'));
+    std::fwrite(batch_.data(), 1, batch_.size(), file_);
+    std::fflush(file_);
+    file_bytes_ += batch_.size();
+    written_.fetch_add(lines, std::memory_order_relaxed);
+    batch_.clear();
+    unsynced_ = true;
+    
+    if (config_.fsync_policy == FsyncPolicy::EveryBatch) {
+        syncFile();
+    }
+}
+
+void OpportunityJournal::maybeSync() {
+    // Interval policy also covers the tail of a burst once the queue goes idle
+    auto now = std::chrono::steady_clock::now();
+    if (config_.fsync_policy == FsyncPolicy::Interval && unsynced_ && now - last_fsync_ >= config_.fsync_interval) {
+        syncFile();
+    }
+}
+
+void OpportunityJournal::openFile() {
+    auto now = std::chrono::system_clock::now();
+    auto time_t = std::chrono::system_clock::to_time_t(now);
+    std::tm tm = *std::localtime(&time_t);
+    
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y-%m-%d_%H-%M-%S", &tm);
+    
+    // A second rotation within the same second gets a numeric suffix
+    std::string base = config_.directory + "/" + config_.prefix + "_" + stamp;
+    std::string path = base + ".ndjson";
+    for (int suffix = 1; suffix < 1000; ++suffix) {
+        std::FILE* existing = std::fopen(path.c_str(), "rb");
+        if (existing == nullptr) {
+            break;
+        }
+        std::fclose(existing);
+        path = base + "_" + std::to_string(suffix) + ".ndjson";
+    }
+    
+    file_ = std::fopen(path.c_str(), "ab");
+    file_bytes_ = 0;
+    file_opened_ = std::chrono::steady_clock::now();
+}
+
+void OpportunityJournal::closeFile() {
+    if (file_ == nullptr) {
+        return;
+    }
+    std::fflush(file_);
+    if (config_.fsync_policy != FsyncPolicy::Never) {
+        syncFile();
+    }
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+void OpportunityJournal::syncFile() {
+    if (file_ == nullptr) {
+        return;
+    }
+#ifdef _WIN32
+    _commit(_fileno(file_));
+#else
+    fsync(fileno(file_));
+#endif
+    unsynced_ = false;
+    last_fsync_ = std::chrono::steady_clock::now();
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "MpscQueue.hpp"
+#include "src/core/MarketState.hpp"
+#include "src/core/OpportunityTracker.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+
+enum class FsyncPolicy {
+    Never,       // Leave flushing to the OS
+    EveryBatch,  // fsync after every batch write
+    Interval     // fsync at most once per fsync_interval
+};
+
+struct JournalConfig {
+    std::string directory = ".";
+    std::string prefix = "arbitrage_journal";
+    size_t queue_capacity = 4096;
+    uint64_t rotate_bytes = 64ULL * 1024 * 1024;  // 0: no size rotation
+    std::chrono::seconds rotate_interval{3600};    // 0: no time rotation
+    FsyncPolicy fsync_policy = FsyncPolicy::Interval;
+    std::chrono::milliseconds fsync_interval{1000};
+    std::chrono::milliseconds idle_sleep{10};      // Writer poll period when the queue is empty
+};
+
+// Append-only newline-delimited JSON journal written by a background thread
+// Producers (detection, scanner) hand plain records to a bounded lock-free
+// queue and never touch the disk; when the queue is full the record is
+// dropped and counted. The writer formats with std::to_chars, writes whole
+// batches, applies the fsync policy and rotates files by size or age.
+// Files: <directory>/<prefix>_YYYY-MM-DD_HH-MM-SS.ndjson
+class OpportunityJournal {
+public:
+    // Symbol names are resolved through market_state on the writer thread
+    OpportunityJournal(const MarketState& market_state, JournalConfig config = JournalConfig());
+    ~OpportunityJournal();
+    
+    OpportunityJournal(const OpportunityJournal&) = delete;
+    OpportunityJournal& operator=(const OpportunityJournal&) = delete;
+    
+    // Any thread, never blocks; false if the record was dropped
+    bool appendOpportunity(const ArbitrageOpportunity& opp, int64_t timestamp_ms);
+    bool appendEpisode(const OpportunityEpisode& episode);
+    
+    // Drain the queue, flush and close the file
+    void stop();
+    
+    uint64_t getWrittenCount() const { return written_.load(std::memory_order_relaxed); }
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    
+    // Records waiting for the writer (approximate)
+    size_t getQueueDepth() const { return queue_.size(); }
+
+private:
+    enum class EntryType : uint8_t {
+        Opportunity,
+        Episode
+    };
+    
+    struct Entry {
+        EntryType type;
+        int64_t timestamp_ms;
+        OpportunityEpisode episode;  // Opportunity records use episode.peak
+    };
+    
+    const MarketState& market_state_;
+    JournalConfig config_;
+    MpscQueue<Entry> queue_;
+    
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> written_;
+    std::atomic<uint64_t> dropped_;
+    std::thread writer_;
+    
+    // Writer thread state
+    std::FILE* file_;
+    uint64_t file_bytes_;
+    bool unsynced_;  // Written since the last fsync
+    std::chrono::steady_clock::time_point file_opened_;
+    std::chrono::steady_clock::time_point last_fsync_;
+    std::string batch_;
+    
+    void run();
+    void writeBatch();
+    void openFile();
+    void closeFile();
+    void syncFile();
+    void maybeSync();
+    void formatEntry(const Entry& entry);
+};
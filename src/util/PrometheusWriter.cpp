@@ -0,0 +1,123 @@
+#include "PrometheusWriter.hpp"
+#include <array>
+#include <charconv>
+#include <cmath>
+
+namespace {
+    // Latency bucket upper bounds in nanoseconds: 1 us .. 1 s
+    constexpr std::array<uint64_t, 19> LATENCY_BUCKETS_NS = {
+        1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+        1000000, 2500000, 5000000, 10000000, 25000000, 50000000, 100000000, 250000000, 500000000,
+        1000000000};
+    
+    void appendEscaped(std::string& out, const std::string& value) {
+        for (char c : value) {
+            if (c == '\\' || c == '"') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else {
+                out += c;
+            }
+        }
+    }
+}
+
+void PrometheusWriter::family(const char* name, const char* type, const char* help) {
+    out_ += "# HELP ";
+    out_ += name;
+    out_ += ' ';
+    out_ += help;
+    out_ += "\n# TYPE ";
+    out_ += name;
+    out_ += ' ';
+    out_ += type;
+    out_ += '\n';
+}
+
+void PrometheusWriter::sample(const char* name, double value) {
+    sample(name, {}, value);
+}
+
+void PrometheusWriter::sample(const char* name, std::initializer_list<Label> labels, double value) {
+    out_ += name;
+    appendLabels(labels, nullptr);
+    appendValue(value);
+}
+
+void PrometheusWriter::histogram(const char* name, std::initializer_list<Label> labels,
+                                 const HistogramSnapshot& snapshot) {
+    std::string bucket_name = std::string(name) + "_bucket";
+    
+    // A histogram bucket counts toward an edge once its upper bound is within it
+    size_t index = 0;
+    uint64_t cumulative = 0;
+    double sum_seconds = 0.0;
+    for (uint64_t edge_ns : LATENCY_BUCKETS_NS) {
+        while (index < snapshot.counts.size() && LatencyHistogram::bucketLowerBound(index + 1) <= edge_ns + 1) {
+            cumulative += snapshot.counts[index];
+            sum_seconds += snapshot.counts[index] * (LatencyHistogram::bucketLowerBound(index) / 1e9);
+            ++index;
+        }
+        char le[32];
+        auto result = std::to_chars(le, le + sizeof(le), edge_ns / 1e9);
+        *result.ptr = '\0';
+        out_ += bucket_name;
+        appendLabels(labels, le);
+        appendValue(static_cast<double>(cumulative));
+    }
+    for (; index < snapshot.counts.size(); ++index) {
+        sum_seconds += snapshot.counts[index] * (LatencyHistogram::bucketLowerBound(index) / 1e9);
+    }
+    
+    out_ += bucket_name;
+    appendLabels(labels, "+Inf");
+    appendValue(static_cast<double>(snapshot.total));
+    out_ += name;
+    out_ += "_sum";
+    appendLabels(labels, nullptr);
+    appendValue(sum_seconds);
+    out_ += name;
+    out_ += "_count";
+    appendLabels(labels, nullptr);
+    appendValue(static_cast<double>(snapshot.total));
+}
+
+void PrometheusWriter::appendLabels(std::initializer_list<Label> labels, const char* le) {
+    if (labels.size() == 0 && le == nullptr) {
+        return;
+    }
+    out_ += '{';
+    bool first = true;
+    for (const auto& label : labels) {
+        if (!first) {
+            out_ += ',';
+        }
+        first = false;
+        out_ += label.first;
+        out_ += "=\"";
+        appendEscaped(out_, label.second);
+        out_ += '"';
+    }
+    if (le != nullptr) {
+        out_ += first ? "le=\"" : ",le=\"";
+        out_ += le;
+        out_ += '"';
+    }
+    out_ += '}';
+}
+
+void PrometheusWriter::appendValue(double value) {
+    out_ += ' ';
+    if (std::isnan(value)) {
+        out_ += "NaN";
+    } else if (std::isinf(value)) {
+        out_ += value > 0 ? "+Inf" : "-Inf";
+    } else {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out_.append(buffer, result.ptr);
+    }
+    out_ += '\n';
+}
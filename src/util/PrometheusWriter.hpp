@@ -0,0 +1,32 @@
+#pragma once
+
+#include "LatencyHistogram.hpp"
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+// Builder for the Prometheus text exposition format (version 0.0.4)
+// Each metric family is declared once with family(), followed by its samples.
+class PrometheusWriter {
+public:
+    using Label = std::pair<const char*, std::string>;
+    
+    // # HELP and # TYPE lines; type is "counter", "gauge" or "histogram"
+    void family(const char* name, const char* type, const char* help);
+    
+    void sample(const char* name, double value);
+    void sample(const char* name, std::initializer_list<Label> labels, double value);
+    
+    // Cumulative _bucket/_sum/_count samples of a nanosecond histogram, in seconds
+    // Bucket edges fall on histogram bucket bounds (~3% error); _sum is built
+    // from bucket lower bounds
+    void histogram(const char* name, std::initializer_list<Label> labels, const HistogramSnapshot& snapshot);
+    
+    const std::string& str() const { return out_; }
+
+private:
+    void appendLabels(std::initializer_list<Label> labels, const char* le);
+    void appendValue(double value);
+    
+    std::string out_;
+};
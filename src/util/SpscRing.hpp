@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+// Bounded lock-free single-producer single-consumer ring
+// Head and tail live on separate cache lines and each side keeps a cached
+// copy of the other side's index, so the shared line is only read when the
+// ring looks full (producer) or empty (consumer). tryPush never blocks.
+template <typename T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value, "SpscRing holds plain records");
+
+public:
+    // capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity)
+        : mask_(roundUp(capacity) - 1),
+          slots_(new T[mask_ + 1]),
+          head_(0),
+          cached_tail_(0),
+          tail_(0),
+          cached_head_(0) {}
+    
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    
+    // Producer thread only
+    bool tryPush(const T& value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ > mask_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ > mask_) {
+                return false; // Full
+            }
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    // Consumer thread only: hand up to max_items to consume(const T&) in
+    // order and release their slots in one store; returns the count
+    template <typename Consumer>
+    size_t drain(size_t max_items, Consumer&& consume) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (cached_tail_ == head) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (cached_tail_ == head) {
+                return 0; // Empty
+            }
+        }
+        size_t count = std::min(cached_tail_ - head, max_items);
+        for (size_t i = 0; i < count; ++i) {
+            consume(slots_[(head + i) & mask_]);
+        }
+        head_.store(head + count, std::memory_order_release);
+        return count;
+    }
+    
+    // Consumer thread only
+    bool tryPop(T& value) {
+        return drain(1, [&value](const T& item) { value = item; }) == 1;
+    }
+    
+    // Any thread; approximate while either side is active
+    size_t size() const {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+    
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    static size_t roundUp(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        return size;
+    }
+    
+    const size_t mask_;
+    std::unique_ptr<T[]> slots_;
+    alignas(64) std::atomic<size_t> head_;  // Consumer position
+    size_t cached_tail_;                     // Consumer's view of tail_
+    alignas(64) std::atomic<size_t> tail_;  // Producer position
+    size_t cached_head_;                     // Producer's view of head_
+};
@@ -0,0 +1,403 @@
+#include "TickArchive.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    constexpr int MAX_EXPONENT = 12;
+    constexpr double MAX_SCALED = 9007199254740992.0;  // 2^53: larger integers are not exact in a double
+    
+    const double POWERS_OF_TEN[MAX_EXPONENT + 1] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12
+    };
+    
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+    
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+    
+    void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+        while (value >= 0x80) {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+    
+    // Returns false on truncated or overlong input
+    inline bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+        // Most deltas fit one byte
+        if (in != end && *in < 0x80) {
+            value = *in++;
+            return true;
+        }
+        value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (in == end) {
+                return false;
+            }
+            uint8_t byte = *in++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    
+    // Price/quantity columns in block order
+    double TickRecord::* const PRICE_FIELDS[4] = {
+        &TickRecord::bid_price, &TickRecord::bid_qty, &TickRecord::ask_price, &TickRecord::ask_qty
+    };
+    
+    // Smallest number of decimals that reproduces every value exactly
+    uint8_t chooseExponent(const std::vector<TickRecord>& ticks, double TickRecord::* field) {
+        for (int exponent = 0; exponent <= MAX_EXPONENT; ++exponent) {
+            double scale = POWERS_OF_TEN[exponent];
+            bool exact = true;
+            for (const auto& tick : ticks) {
+                double value = tick.*field;
+                double scaled = std::round(value * scale);
+                if (!(std::fabs(scaled) < MAX_SCALED) || scaled / scale != value) {
+                    exact = false;
+                    break;
+                }
+            }
+            if (exact) {
+                return static_cast<uint8_t>(exponent);
+            }
+        }
+        return TICK_ARCHIVE_RAW_COLUMN;
+    }
+    
+    bool seekTo(std::FILE* file, uint64_t offset) {
+#ifdef _WIN32
+        return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+        return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+    }
+}
+
+std::unique_ptr<TickArchiveWriter> TickArchiveWriter::create(const std::string& path, uint32_t block_ticks) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return nullptr;
+    }
+    auto writer = std::unique_ptr<TickArchiveWriter>(new TickArchiveWriter(file, std::max<uint32_t>(block_ticks, 1)));
+    
+    // Placeholder header, completed by close()
+    TickArchiveHeader header{};
+    if (!writer->write(&header, sizeof(header))) {
+        return nullptr;
+    }
+    return writer;
+}
+
+bool TickArchiveWriter::convert(const TickCaptureReader& capture, const std::string& path, uint32_t block_ticks) {
+    auto writer = create(path, block_ticks);
+    if (!writer) {
+        return false;
+    }
+    for (size_t i = 0; i < capture.size(); ++i) {
+        const TickRecord& tick = capture.at(i);
+        if (!writer->append(tick, capture.symbolName(tick.symbol_id))) {
+            return false;
+        }
+    }
+    return writer->close();
+}
+
+TickArchiveWriter::TickArchiveWriter(std::FILE* file, uint32_t block_ticks)
+    : file_(file),
+      block_ticks_(block_ticks),
+      offset_(0),
+      tick_count_(0),
+      failed_(false) {}
+
+TickArchiveWriter::~TickArchiveWriter() {
+    if (file_ != nullptr) {
+        close();
+    }
+}
+
+bool TickArchiveWriter::write(const void* data, size_t bytes) {
+    if (failed_ || std::fwrite(data, 1, bytes, file_) != bytes) {
+        failed_ = true;
+        return false;
+    }
+    offset_ += bytes;
+    return true;
+}
+
+bool TickArchiveWriter::append(const TickRecord& tick, const std::string& symbol) {
+    if (file_ == nullptr || failed_) {
+        return false;
+    }
+    uint32_t symbol_id = tick.symbol_id;
+    if (symbol_id >= pending_.size()) {
+        pending_.resize(symbol_id + 1);
+        symbols_.resize(symbol_id + 1);
+    }
+    if (symbols_[symbol_id].empty()) {
+        symbols_[symbol_id] = symbol;
+    }
+    
+    auto& block = pending_[symbol_id];
+    if (block.empty()) {
+        block.reserve(block_ticks_);
+    }
+    block.push_back(tick);
+    tick_count_++;
+    return block.size() < block_ticks_ || writeBlock(symbol_id);
+}
+
+bool TickArchiveWriter::writeBlock(uint32_t symbol_id) {
+    auto& ticks = pending_[symbol_id];
+    if (ticks.empty()) {
+        return true;
+    }
+    
+    TickArchiveBlockHeader header{};
+    header.symbol_id = symbol_id;
+    header.tick_count = static_cast<uint32_t>(ticks.size());
+    header.min_time_ns = ticks.front().receive_time_ns;
+    header.max_time_ns = ticks.front().receive_time_ns;
+    for (const auto& tick : ticks) {
+        header.min_time_ns = std::min(header.min_time_ns, tick.receive_time_ns);
+        header.max_time_ns = std::max(header.max_time_ns, tick.receive_time_ns);
+    }
+    
+    for (auto& column : columns_) {
+        column.clear();
+    }
+    
+    // Times start from the block minimum, update ids from zero
+    int64_t previous_time = header.min_time_ns;
+    uint64_t previous_update_id = 0;
+    for (const auto& tick : ticks) {
+        putVarint(columns_[0], zigzag(tick.receive_time_ns - previous_time));
+        putVarint(columns_[1], zigzag(static_cast<int64_t>(tick.update_id - previous_update_id)));
+        previous_time = tick.receive_time_ns;
+        previous_update_id = tick.update_id;
+    }
+    
+    for (size_t field = 0; field < 4; ++field) {
+        auto& column = columns_[2 + field];
+        double TickRecord::* member = PRICE_FIELDS[field];
+        uint8_t exponent = chooseExponent(ticks, member);
+        header.exponents[field] = exponent;
+        if (exponent == TICK_ARCHIVE_RAW_COLUMN) {
+            for (const auto& tick : ticks) {
+                double value = tick.*member;
+                const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+                column.insert(column.end(), bytes, bytes + sizeof(value));
+            }
+            continue;
+        }
+        double scale = POWERS_OF_TEN[exponent];
+        int64_t previous = 0;
+        for (const auto& tick : ticks) {
+            int64_t scaled = static_cast<int64_t>(std::round(tick.*member * scale));
+            putVarint(column, zigzag(scaled - previous));
+            previous = scaled;
+        }
+    }
+    
+    uint64_t block_bytes = sizeof(header);
+    for (size_t c = 0; c < TICK_ARCHIVE_COLUMNS; ++c) {
+        header.column_bytes[c] = static_cast<uint32_t>(columns_[c].size());
+        block_bytes += columns_[c].size();
+    }
+    
+    TickArchiveBlockEntry entry{};
+    entry.offset = offset_;
+    entry.bytes = static_cast<uint32_t>(block_bytes);
+    entry.symbol_id = symbol_id;
+    entry.tick_count = header.tick_count;
+    entry.min_time_ns = header.min_time_ns;
+    entry.max_time_ns = header.max_time_ns;
+    
+    bool written = write(&header, sizeof(header));
+    for (const auto& column : columns_) {
+        written = written && write(column.data(), column.size());
+    }
+    index_.push_back(entry);
+    ticks.clear();
+    return written;
+}
+
+bool TickArchiveWriter::close() {
+    if (file_ == nullptr) {
+        return false;
+    }
+    
+    for (uint32_t symbol_id = 0; symbol_id < pending_.size(); ++symbol_id) {
+        writeBlock(symbol_id);
+    }
+    
+    TickArchiveHeader header{};
+    std::memcpy(header.magic, TICK_ARCHIVE_MAGIC, sizeof(TICK_ARCHIVE_MAGIC));
+    header.version = TICK_ARCHIVE_VERSION;
+    header.block_ticks = block_ticks_;
+    header.tick_count = tick_count_;
+    header.block_count = index_.size();
+    header.symbol_count = static_cast<uint32_t>(symbols_.size());
+    header.created_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    header.dictionary_offset = offset_;
+    for (const auto& symbol : symbols_) {
+        TickSymbolEntry entry{};
+        std::memcpy(entry.name, symbol.data(), std::min(symbol.size(), sizeof(entry.name) - 1));
+        write(&entry, sizeof(entry));
+    }
+    header.index_offset = offset_;
+    if (!index_.empty()) {
+        write(index_.data(), index_.size() * sizeof(TickArchiveBlockEntry));
+    }
+    
+    bool ok = !failed_ && seekTo(file_, 0) && std::fwrite(&header, sizeof(header), 1, file_) == 1;
+    ok = std::fclose(file_) == 0 && ok;
+    file_ = nullptr;
+    return ok;
+}
+
+std::optional<TickArchiveReader> TickArchiveReader::open(const std::string& path) {
+    std::FILE* raw = std::fopen(path.c_str(), "rb");
+    if (raw == nullptr) {
+        return std::nullopt;
+    }
+    
+    TickArchiveReader reader;
+    reader.file_ = std::shared_ptr<std::FILE>(raw, std::fclose);
+    TickArchiveHeader& header = reader.header_;
+    if (std::fread(&header, sizeof(header), 1, raw) != 1 ||
+        std::memcmp(header.magic, TICK_ARCHIVE_MAGIC, sizeof(TICK_ARCHIVE_MAGIC)) != 0 ||
+        header.version != TICK_ARCHIVE_VERSION ||
+        header.dictionary_offset == 0) {
+        return std::nullopt;
+    }
+    
+    std::vector<TickSymbolEntry> dictionary(header.symbol_count);
+    reader.index_.resize(static_cast<size_t>(header.block_count));
+    if (!seekTo(raw, header.dictionary_offset) ||
+        std::fread(dictionary.data(), sizeof(TickSymbolEntry), dictionary.size(), raw) != dictionary.size() ||
+        !seekTo(raw, header.index_offset) ||
+        std::fread(reader.index_.data(), sizeof(TickArchiveBlockEntry), reader.index_.size(), raw) != reader.index_.size()) {
+        return std::nullopt;
+    }
+    
+    reader.symbols_.resize(dictionary.size());
+    for (size_t i = 0; i < dictionary.size(); ++i) {
+        const char* name = dictionary[i].name;
+        reader.symbols_[i].assign(name, strnlen(name, sizeof(dictionary[i].name)));
+    }
+    return reader;
+}
+
+std::vector<size_t> TickArchiveReader::blocksInRange(int64_t from_ns, int64_t to_ns) const {
+    std::vector<size_t> blocks;
+    for (size_t i = 0; i < index_.size(); ++i) {
+        if (index_[i].max_time_ns >= from_ns && index_[i].min_time_ns <= to_ns) {
+            blocks.push_back(i);
+        }
+    }
+    return blocks;
+}
+
+bool TickArchiveReader::readBlock(size_t index, std::vector<TickRecord>& ticks) {
+    ticks.clear();
+    if (index >= index_.size()) {
+        return false;
+    }
+    const TickArchiveBlockEntry& entry = index_[index];
+    if (entry.bytes < sizeof(TickArchiveBlockHeader)) {
+        return false;
+    }
+    buffer_.resize(entry.bytes);
+    if (!seekTo(file_.get(), entry.offset) || std::fread(buffer_.data(), 1, buffer_.size(), file_.get()) != buffer_.size()) {
+        return false;
+    }
+    
+    TickArchiveBlockHeader header;
+    std::memcpy(&header, buffer_.data(), sizeof(header));
+    
+    // Column boundaries
+    const uint8_t* columns[TICK_ARCHIVE_COLUMNS + 1];
+    columns[0] = buffer_.data() + sizeof(header);
+    const uint8_t* end = buffer_.data() + buffer_.size();
+    for (size_t c = 0; c < TICK_ARCHIVE_COLUMNS; ++c) {
+        if (header.column_bytes[c] > static_cast<size_t>(end - columns[c])) {
+            return false;
+        }
+        columns[c + 1] = columns[c] + header.column_bytes[c];
+    }
+    
+    ticks.resize(header.tick_count);
+    uint64_t value = 0;
+    
+    const uint8_t* in = columns[0];
+    int64_t time = header.min_time_ns;
+    for (auto& tick : ticks) {
+        if (!getVarint(in, columns[1], value)) {
+            return false;
+        }
+        time += unzigzag(value);
+        tick.receive_time_ns = time;
+        tick.symbol_id = header.symbol_id;
+        tick.reserved = 0;
+    }
+    
+    in = columns[1];
+    uint64_t update_id = 0;
+    for (auto& tick : ticks) {
+        if (!getVarint(in, columns[2], value)) {
+            return false;
+        }
+        update_id += static_cast<uint64_t>(unzigzag(value));
+        tick.update_id = update_id;
+    }
+    
+    for (size_t field = 0; field < 4; ++field) {
+        in = columns[2 + field];
+        const uint8_t* column_end = columns[3 + field];
+        double TickRecord::* member = PRICE_FIELDS[field];
+        uint8_t exponent = header.exponents[field];
+        if (exponent == TICK_ARCHIVE_RAW_COLUMN) {
+            if (static_cast<size_t>(column_end - in) != ticks.size() * sizeof(double)) {
+                return false;
+            }
+            for (auto& tick : ticks) {
+                std::memcpy(&(tick.*member), in, sizeof(double));
+                in += sizeof(double);
+            }
+            continue;
+        }
+        if (exponent > MAX_EXPONENT) {
+            return false;
+        }
+        double scale = POWERS_OF_TEN[exponent];
+        int64_t scaled = 0;
+        for (auto& tick : ticks) {
+            if (!getVarint(in, column_end, value)) {
+                return false;
+            }
+            scaled += unzigzag(value);
+            tick.*member = static_cast<double>(scaled) / scale;
+        }
+    }
+    return true;
+}
+
+const std::string& TickArchiveReader::symbolName(uint32_t symbol_id) const {
+    static const std::string unknown = "?";
+    if (symbol_id >= symbols_.size() || symbols_[symbol_id].empty()) {
+        return unknown;
+    }
+    return symbols_[symbol_id];
+}
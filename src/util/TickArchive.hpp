@@ -0,0 +1,138 @@
+#pragma once
+
+#include "TickCapture.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Compressed columnar tick archive for long-term storage (little endian):
+//   TickArchiveHeader | block... | TickSymbolEntry[symbol_count] | TickArchiveBlockEntry[block_count]
+// A block holds up to block_ticks consecutive ticks of one symbol, stored as six
+// columns: receive time, update id, bid price, bid qty, ask price, ask qty. Every
+// column is a run of zigzag varint deltas; prices and quantities are first scaled
+// to integers with the smallest decimal exponent that round-trips every value of
+// the column exactly, so decoding reproduces the captured doubles bit for bit.
+// The trailing block index carries per-block min/max receive times for seeking.
+constexpr char TICK_ARCHIVE_MAGIC[8] = {'A', 'R', 'B', 'A', 'R', 'C', 'H', '1'};
+constexpr uint32_t TICK_ARCHIVE_VERSION = 1;
+
+struct TickArchiveHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t block_ticks;
+    uint64_t tick_count;
+    uint64_t block_count;
+    uint32_t symbol_count;
+    uint32_t reserved;
+    uint64_t dictionary_offset;  // 0 until the archive is closed
+    uint64_t index_offset;
+    int64_t created_time_ns;     // Wall clock, epoch ns
+};
+
+constexpr size_t TICK_ARCHIVE_COLUMNS = 6;
+constexpr uint8_t TICK_ARCHIVE_RAW_COLUMN = 0xFF;  // Column exponent: values stored as raw doubles
+
+// Precedes the column data of every block
+struct TickArchiveBlockHeader {
+    uint32_t symbol_id;
+    uint32_t tick_count;
+    int64_t min_time_ns;
+    int64_t max_time_ns;
+    uint8_t exponents[4];   // Decimal digits of bid price, bid qty, ask price, ask qty
+    uint32_t column_bytes[TICK_ARCHIVE_COLUMNS];
+    uint32_t reserved;
+};
+
+// Block index entry
+struct TickArchiveBlockEntry {
+    uint64_t offset;  // File offset of the block header
+    uint32_t bytes;   // Header plus column data
+    uint32_t symbol_id;
+    uint32_t tick_count;
+    uint32_t reserved;
+    int64_t min_time_ns;
+    int64_t max_time_ns;
+};
+
+static_assert(sizeof(TickArchiveBlockHeader) == 56, "TickArchiveBlockHeader layout is part of the file format");
+static_assert(sizeof(TickArchiveBlockEntry) == 40, "TickArchiveBlockEntry layout is part of the file format");
+
+// Streaming archive writer
+// Ticks are buffered per symbol and a block is encoded and written as soon as
+// it is full, so memory stays at one open block per symbol. Symbol ids are
+// kept as given; close() writes the dictionary and the block index.
+class TickArchiveWriter {
+public:
+    // Create (truncate) path; nullptr on failure
+    static std::unique_ptr<TickArchiveWriter> create(const std::string& path, uint32_t block_ticks = 1024);
+    
+    // Convert a live capture file in file order; false on write failure
+    static bool convert(const TickCaptureReader& capture, const std::string& path, uint32_t block_ticks = 1024);
+    
+    ~TickArchiveWriter();
+    
+    TickArchiveWriter(const TickArchiveWriter&) = delete;
+    TickArchiveWriter& operator=(const TickArchiveWriter&) = delete;
+    
+    // Ticks of one symbol must arrive in receive-time order
+    bool append(const TickRecord& tick, const std::string& symbol);
+    
+    // Flush open blocks, write dictionary and index; the archive is unreadable before this
+    bool close();
+    
+    uint64_t getTickCount() const { return tick_count_; }
+    uint64_t getBytesWritten() const { return offset_; }
+
+private:
+    TickArchiveWriter(std::FILE* file, uint32_t block_ticks);
+    
+    bool writeBlock(uint32_t symbol_id);
+    bool write(const void* data, size_t bytes);
+    
+    std::FILE* file_;
+    uint32_t block_ticks_;
+    uint64_t offset_;
+    uint64_t tick_count_;
+    bool failed_;
+    
+    std::vector<std::vector<TickRecord>> pending_;  // Open block per symbol id
+    std::vector<std::string> symbols_;              // Indexed by symbol id
+    std::vector<TickArchiveBlockEntry> index_;
+    std::vector<uint8_t> columns_[TICK_ARCHIVE_COLUMNS];  // Encoding scratch
+};
+
+// Block-at-a-time archive decoder
+// Only the header, dictionary and index are read up front; readBlock() reads
+// and decodes one block into reused buffers.
+class TickArchiveReader {
+public:
+    static std::optional<TickArchiveReader> open(const std::string& path);
+    
+    uint64_t tickCount() const { return header_.tick_count; }
+    size_t blockCount() const { return index_.size(); }
+    const TickArchiveBlockEntry& block(size_t index) const { return index_[index]; }
+    
+    // Blocks whose time range overlaps [from_ns, to_ns], in file order
+    std::vector<size_t> blocksInRange(int64_t from_ns, int64_t to_ns) const;
+    
+    // Decode one block into ticks (replaced); false if the block is corrupt
+    bool readBlock(size_t index, std::vector<TickRecord>& ticks);
+    
+    // "?" for ids without a dictionary entry
+    const std::string& symbolName(uint32_t symbol_id) const;
+    uint32_t symbolCount() const { return static_cast<uint32_t>(symbols_.size()); }
+    
+    const TickArchiveHeader& header() const { return header_; }
+
+private:
+    TickArchiveReader() = default;
+    
+    std::shared_ptr<std::FILE> file_;
+    TickArchiveHeader header_{};
+    std::vector<std::string> symbols_;
+    std::vector<TickArchiveBlockEntry> index_;
+    std::vector<uint8_t> buffer_;
+};
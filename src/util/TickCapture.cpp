@@ -0,0 +1,152 @@
+#include "TickCapture.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+namespace bip = boost::interprocess;
+
+std::unique_ptr<TickCapture> TickCapture::create(const std::string& path, const MarketState& market_state,
+                                                 uint64_t record_capacity, uint32_t dictionary_capacity) {
+    try {
+        return std::unique_ptr<TickCapture>(new TickCapture(path, market_state, record_capacity, dictionary_capacity));
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+TickCapture::TickCapture(const std::string& path, const MarketState& market_state,
+                         uint64_t record_capacity, uint32_t dictionary_capacity)
+    : path_(path),
+      market_state_(market_state),
+      record_capacity_(record_capacity),
+      dictionary_capacity_(dictionary_capacity),
+      header_(nullptr),
+      dictionary_(nullptr),
+      records_(nullptr),
+      dictionary_state_(new std::atomic<uint8_t>[dictionary_capacity]),
+      next_(0),
+      dropped_(0) {
+    uint64_t dictionary_offset = sizeof(TickFileHeader);
+    uint64_t records_offset = dictionary_offset + uint64_t(dictionary_capacity) * sizeof(TickSymbolEntry);
+    records_offset = (records_offset + 63) & ~uint64_t(63);
+    uint64_t file_size = records_offset + record_capacity * sizeof(TickRecord);
+    
+    // Create and size the file (sparse where the filesystem supports it)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("cannot create " + path);
+        }
+    }
+    std::filesystem::resize_file(path, file_size);
+    
+    mapping_ = bip::file_mapping(path.c_str(), bip::read_write);
+    region_ = bip::mapped_region(mapping_, bip::read_write);
+    
+    auto* base = static_cast<char*>(region_.get_address());
+    header_ = reinterpret_cast<TickFileHeader*>(base);
+    dictionary_ = reinterpret_cast<TickSymbolEntry*>(base + dictionary_offset);
+    records_ = reinterpret_cast<TickRecord*>(base + records_offset);
+    
+    for (uint32_t i = 0; i < dictionary_capacity; ++i) {
+        dictionary_state_[i].store(DICTIONARY_EMPTY, std::memory_order_relaxed);
+    }
+    
+    std::memcpy(header_->magic, TICK_FILE_MAGIC, sizeof(TICK_FILE_MAGIC));
+    header_->version = TICK_FILE_VERSION;
+    header_->record_size = sizeof(TickRecord);
+    header_->dictionary_capacity = dictionary_capacity;
+    header_->dictionary_entry_size = sizeof(TickSymbolEntry);
+    header_->record_capacity = record_capacity;
+    header_->record_count = 0;
+    header_->dictionary_offset = dictionary_offset;
+    header_->records_offset = records_offset;
+    header_->created_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+TickCapture::~TickCapture() {
+    try {
+        flush();
+    } catch (...) {
+        // Silent failure on shutdown
+    }
+}
+
+void TickCapture::writeDictionaryEntry(SymbolId symbol_id) {
+    uint8_t expected = DICTIONARY_EMPTY;
+    if (!dictionary_state_[symbol_id].compare_exchange_strong(expected, DICTIONARY_WRITING, std::memory_order_acq_rel)) {
+        return; // Another feed thread is writing it
+    }
+    
+    const std::string& name = market_state_.getSymbolName(symbol_id);
+    TickSymbolEntry& entry = dictionary_[symbol_id];
+    size_t length = std::min(name.size(), sizeof(entry.name) - 1);
+    std::memcpy(entry.name, name.data(), length);
+    entry.name[length] = '\0';
+    
+    dictionary_state_[symbol_id].store(DICTIONARY_WRITTEN, std::memory_order_release);
+}
+
+uint64_t TickCapture::getRecordCount() const {
+    return std::min(next_.load(std::memory_order_relaxed), record_capacity_);
+}
+
+void TickCapture::flush() {
+    header_->record_count = getRecordCount();
+    region_.flush();
+}
+
+std::optional<TickCaptureReader> TickCaptureReader::open(const std::string& path) {
+    TickCaptureReader reader;
+    try {
+        bip::file_mapping mapping(path.c_str(), bip::read_only);
+        reader.region_ = std::make_shared<bip::mapped_region>(mapping, bip::read_only);
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+    
+    const auto* base = static_cast<const char*>(reader.region_->get_address());
+    size_t file_size = reader.region_->get_size();
+    if (file_size < sizeof(TickFileHeader)) {
+        return std::nullopt;
+    }
+    
+    reader.header_ = reinterpret_cast<const TickFileHeader*>(base);
+    const TickFileHeader& header = *reader.header_;
+    if (std::memcmp(header.magic, TICK_FILE_MAGIC, sizeof(TICK_FILE_MAGIC)) != 0 ||
+        header.version != TICK_FILE_VERSION ||
+        header.record_size != sizeof(TickRecord) ||
+        header.dictionary_entry_size != sizeof(TickSymbolEntry) ||
+        header.records_offset + header.record_capacity * sizeof(TickRecord) > file_size) {
+        return std::nullopt;
+    }
+    
+    const auto* dictionary = reinterpret_cast<const TickSymbolEntry*>(base + header.dictionary_offset);
+    reader.symbols_.resize(header.dictionary_capacity);
+    for (uint32_t i = 0; i < header.dictionary_capacity; ++i) {
+        const char* name = dictionary[i].name;
+        reader.symbols_[i].assign(name, strnlen(name, sizeof(dictionary[i].name)));
+    }
+    
+    // The header count may be stale after a crash: continue to the first unwritten slot
+    reader.records_ = reinterpret_cast<const TickRecord*>(base + header.records_offset);
+    size_t count = static_cast<size_t>(std::min(header.record_count, header.record_capacity));
+    while (count < header.record_capacity && reader.records_[count].receive_time_ns != 0) {
+        ++count;
+    }
+    reader.record_count_ = count;
+    
+    return reader;
+}
+
+const std::string& TickCaptureReader::symbolName(uint32_t symbol_id) const {
+    static const std::string unknown = "?";
+    if (symbol_id >= symbols_.size() || symbols_[symbol_id].empty()) {
+        return unknown;
+    }
+    return symbols_[symbol_id];
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "src/core/MarketState.hpp"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Binary tick capture file layout (little endian, native doubles):
+//   TickFileHeader | TickSymbolEntry[dictionary_capacity] | TickRecord[record_capacity]
+// Symbol ids in records index the per-file dictionary.
+constexpr char TICK_FILE_MAGIC[8] = {'A', 'R', 'B', 'T', 'I', 'C', 'K', '1'};
+constexpr uint32_t TICK_FILE_VERSION = 1;
+
+struct TickFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t dictionary_capacity;
+    uint32_t dictionary_entry_size;
+    uint64_t record_capacity;
+    uint64_t record_count;      // Written on flush/close; after a crash scan for receive_time_ns == 0
+    uint64_t dictionary_offset;
+    uint64_t records_offset;
+    int64_t created_time_ns;    // Wall clock, epoch ns
+};
+
+struct TickSymbolEntry {
+    char name[32];  // "ARB/USDT", NUL terminated; empty if unused
+};
+
+// One applied bookTicker update
+struct TickRecord {
+    int64_t receive_time_ns;  // Wall clock at frame receive, epoch ns; 0 = never written
+    uint64_t update_id;       // Exchange update id ("u")
+    double bid_price;
+    double bid_qty;
+    double ask_price;
+    double ask_qty;
+    uint32_t symbol_id;       // Index into the file's symbol dictionary
+    uint32_t reserved;
+};
+
+static_assert(sizeof(TickRecord) == 56, "TickRecord layout is part of the file format");
+
+// Append-only, memory-mapped capture of every applied book update
+// The file is sized up front and mapped once. Recording claims a slot with
+// one atomic increment and writes the record straight into the mapping: no
+// formatting and no syscalls per record. Symbol ids are MarketState ids; the
+// dictionary slot of an id is filled the first time that symbol is recorded.
+// When the file is full further records are dropped and counted.
+class TickCapture {
+public:
+    // Create (truncate) path sized for record_capacity records; nullptr on failure
+    static std::unique_ptr<TickCapture> create(const std::string& path, const MarketState& market_state,
+                                               uint64_t record_capacity = 8ULL * 1024 * 1024,
+                                               uint32_t dictionary_capacity = 8192);
+    ~TickCapture();
+    
+    TickCapture(const TickCapture&) = delete;
+    TickCapture& operator=(const TickCapture&) = delete;
+    
+    // Any feed thread
+    void record(SymbolId symbol_id, uint64_t update_id, int64_t receive_time_ns,
+                double bid_price, double bid_qty, double ask_price, double ask_qty) {
+        uint64_t index = next_.fetch_add(1, std::memory_order_relaxed);
+        if (index >= record_capacity_ || symbol_id >= dictionary_capacity_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (dictionary_state_[symbol_id].load(std::memory_order_acquire) != DICTIONARY_WRITTEN) {
+            writeDictionaryEntry(symbol_id);
+        }
+        records_[index] = TickRecord{receive_time_ns, update_id, bid_price, bid_qty, ask_price, ask_qty, symbol_id, 0};
+    }
+    
+    // Publish the record count in the header and flush dirty pages to disk
+    void flush();
+    
+    uint64_t getRecordCount() const;
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    const std::string& getPath() const { return path_; }
+
+private:
+    static constexpr uint8_t DICTIONARY_EMPTY = 0;
+    static constexpr uint8_t DICTIONARY_WRITING = 1;
+    static constexpr uint8_t DICTIONARY_WRITTEN = 2;
+    
+    TickCapture(const std::string& path, const MarketState& market_state,
+                uint64_t record_capacity, uint32_t dictionary_capacity);
+    
+    void writeDictionaryEntry(SymbolId symbol_id);
+    
+    std::string path_;
+    const MarketState& market_state_;
+    uint64_t record_capacity_;
+    uint32_t dictionary_capacity_;
+    
+    boost::interprocess::file_mapping mapping_;
+    boost::interprocess::mapped_region region_;
+    TickFileHeader* header_;
+    TickSymbolEntry* dictionary_;
+    TickRecord* records_;
+    
+    std::unique_ptr<std::atomic<uint8_t>[]> dictionary_state_;
+    std::atomic<uint64_t> next_;
+    std::atomic<uint64_t> dropped_;
+};
+
+// Read-only view of a capture file
+class TickCaptureReader {
+public:
+    static std::optional<TickCaptureReader> open(const std::string& path);
+    
+    size_t size() const { return record_count_; }
+    const TickRecord& at(size_t index) const { return records_[index]; }
+    
+    // "?" for ids without a dictionary entry
+    const std::string& symbolName(uint32_t symbol_id) const;
+    
+    const TickFileHeader& header() const { return *header_; }
+
+private:
+    TickCaptureReader() = default;
+    
+    std::shared_ptr<boost::interprocess::mapped_region> region_;
+    const TickFileHeader* header_ = nullptr;
+    const TickRecord* records_ = nullptr;
+    size_t record_count_ = 0;
+    std::vector<std::string> symbols_;
+};
@@ -0,0 +1,55 @@
+#include "TickSource.hpp"
+#include <algorithm>
+#include <numeric>
+#include <tuple>
+
+CaptureTickSource::CaptureTickSource(TickCaptureReader reader)
+    : reader_(std::move(reader)), order_(reader_.size()), position_(0) {
+    std::iota(order_.begin(), order_.end(), 0);
+    std::stable_sort(order_.begin(), order_.end(), [this](uint32_t a, uint32_t b) {
+        const TickRecord& left = reader_.at(a);
+        const TickRecord& right = reader_.at(b);
+        return std::tie(left.receive_time_ns, left.symbol_id) < std::tie(right.receive_time_ns, right.symbol_id);
+    });
+}
+
+ArchiveTickSource::ArchiveTickSource(TickArchiveReader reader) : reader_(std::move(reader)), complete_(true) {
+    streams_.resize(reader_.symbolCount());
+    for (size_t block = 0; block < reader_.blockCount(); ++block) {
+        uint32_t symbol_id = reader_.block(block).symbol_id;
+        if (symbol_id < streams_.size()) {
+            streams_[symbol_id].blocks.push_back(block);
+        }
+    }
+    for (uint32_t symbol_id = 0; symbol_id < streams_.size(); ++symbol_id) {
+        advance(symbol_id);
+    }
+}
+
+const TickRecord* ArchiveTickSource::next() {
+    if (heads_.empty()) {
+        return nullptr;
+    }
+    uint32_t symbol_id = heads_.top().second;
+    heads_.pop();
+    current_ = streams_[symbol_id].ticks[streams_[symbol_id].position++];
+    advance(symbol_id);
+    return &current_;
+}
+
+void ArchiveTickSource::advance(uint32_t symbol_id) {
+    Stream& stream = streams_[symbol_id];
+    while (stream.position == stream.ticks.size()) {
+        if (stream.next_block == stream.blocks.size()) {
+            return;
+        }
+        stream.position = 0;
+        if (!reader_.readBlock(stream.blocks[stream.next_block++], stream.ticks)) {
+            complete_ = false;
+            stream.ticks.clear();
+            stream.next_block = stream.blocks.size();
+            return;
+        }
+    }
+    heads_.push({stream.ticks[stream.position].receive_time_ns, symbol_id});
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "TickArchive.hpp"
+#include "TickCapture.hpp"
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Sequential readers over recorded ticks for offline tools (replay, simulation).
+// Both yield ticks in the same order: receive time, then symbol id, then file order,
+// so a capture and the archive made from it replay identically.
+
+// Capture file in replay order
+class CaptureTickSource {
+public:
+    explicit CaptureTickSource(TickCaptureReader reader);
+    
+    uint32_t dictionarySize() const { return reader_.header().dictionary_capacity; }
+    const std::string& symbolName(uint32_t symbol_id) const { return reader_.symbolName(symbol_id); }
+    bool isComplete() const { return true; }
+    
+    // nullptr at the end
+    const TickRecord* next() {
+        return position_ < order_.size() ? &reader_.at(order_[position_++]) : nullptr;
+    }
+
+private:
+    TickCaptureReader reader_;
+    std::vector<uint32_t> order_;
+    size_t position_;
+};
+
+// Archive in replay order: k-way merge of the per-symbol block streams,
+// decoding one block per symbol at a time
+class ArchiveTickSource {
+public:
+    explicit ArchiveTickSource(TickArchiveReader reader);
+    
+    uint32_t dictionarySize() const { return reader_.symbolCount(); }
+    const std::string& symbolName(uint32_t symbol_id) const { return reader_.symbolName(symbol_id); }
+    
+    // False once a block failed to decode; its symbol's remaining ticks are skipped
+    bool isComplete() const { return complete_; }
+    
+    // nullptr at the end; valid until the next call
+    const TickRecord* next();
+
+private:
+    struct Stream {
+        std::vector<size_t> blocks;
+        size_t next_block = 0;
+        std::vector<TickRecord> ticks;  // Current decoded block
+        size_t position = 0;
+    };
+    
+    // Queue the next tick of a symbol, decoding its next block when needed
+    void advance(uint32_t symbol_id);
+    
+    using Head = std::pair<int64_t, uint32_t>;  // Receive time, symbol id
+    
+    TickArchiveReader reader_;
+    std::vector<Stream> streams_;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads_;
+    TickRecord current_{};
+    bool complete_;
+};
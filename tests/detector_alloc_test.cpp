@@ -0,0 +1,113 @@
+// The detection pass must not touch the heap: onBookUpdate (trigger check and,
+// when a trigger crosses, the full route scan) and checkOpportunities.
+// Every operator new in the process is counted; the counted window covers only
+// the detector calls, after a warm-up that lets lazy structures settle.
+
+#include "src/core/ArbitrageDetector.hpp"
+#include "src/core/MarketState.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+    std::atomic<bool> counting{false};
+    std::atomic<uint64_t> allocations{0};
+    
+    void* allocate(std::size_t size) {
+        if (counting.load(std::memory_order_relaxed)) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+    
+    void* allocateAligned(std::size_t size, std::align_val_t alignment) {
+        if (counting.load(std::memory_order_relaxed)) {
+            allocations.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::size_t align = static_cast<std::size_t>(alignment);
+        if (void* memory = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+            return memory;
+        }
+        throw std::bad_alloc();
+    }
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete[](void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void* memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+int main() {
+    constexpr int WARMUP_PASSES = 100;
+    constexpr int COUNTED_PASSES = 1000;
+    
+    MarketState market_state;
+    ArbitrageDetector detector(market_state, 0.10);
+    
+    // Built-in route table, every book near a consistent mid
+    const std::vector<std::pair<std::string, double>> mids = {
+        {"ARB/USDT", 0.80}, {"ARB/BTC", 0.80 / 90000.0}, {"ARB/ETH", 0.80 / 3000.0}, {"ARB/FDUSD", 0.80},
+        {"ARB/USDC", 0.80}, {"ARB/TUSD", 0.80}, {"ARB/TRY", 0.80 * 34.0}, {"ARB/EUR", 0.80 / 1.08},
+        {"BTC/USDT", 90000.0}, {"ETH/USDT", 3000.0}, {"EUR/USDT", 1.08}, {"TRY/USDT", 1.0 / 34.0}};
+    std::vector<std::pair<const std::string*, OrderBook*>> books;
+    for (const auto& [pair, mid] : mids) {
+        OrderBook& book = market_state.get(pair);
+        book.update(mid * 0.9997, 1000.0, mid * 1.0003, 1000.0, 1);
+        books.emplace_back(&pair, &book);
+    }
+    
+    // BTC/USDT swings in and out of a cross-route opportunity, so triggers cross
+    // and the full scan runs; the other books move a little on every pass
+    uint64_t opportunities = 0;
+    auto pass = [&](int i, bool count) {
+        double btc = 90000.0 * (i % 2 == 0 ? 1.01 : 1.0);
+        OrderBook& btc_book = market_state.get("BTC/USDT");
+        btc_book.update(btc * 0.9997, 5.0, btc * 1.0003, 5.0, 2 + i);
+        const auto& [pair, book] = books[static_cast<size_t>(i) % books.size()];
+        auto snap = book->snapshot();
+        book->update(snap.bid_price * 1.00001, 1000.0, snap.ask_price * 1.00001, 1000.0, 2 + i);
+        
+        counting.store(count, std::memory_order_relaxed);
+        auto triggered = detector.onBookUpdate("BTC/USDT", btc_book, 0);
+        auto moved = detector.onBookUpdate(*pair, *book, 0);
+        auto scanned = detector.checkOpportunities();
+        counting.store(false, std::memory_order_relaxed);
+        
+        opportunities += triggered.has_value() + moved.has_value() + scanned.has_value();
+    };
+    
+    for (int i = 0; i < WARMUP_PASSES; ++i) {
+        pass(i, false);
+    }
+    for (int i = WARMUP_PASSES; i < WARMUP_PASSES + COUNTED_PASSES; ++i) {
+        pass(i, true);
+    }
+    
+    uint64_t counted = allocations.load();
+    std::printf("%d detection passes, %llu opportunities, %llu heap allocations\n", COUNTED_PASSES,
+                static_cast<unsigned long long>(opportunities), static_cast<unsigned long long>(counted));
+    if (opportunities == 0) {
+        std::printf("FAIL: no opportunity found, the full route scan was not exercised\n");
+        return 1;
+    }
+    if (counted != 0) {
+        std::printf("FAIL: the detection pass allocated\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+// Convert a tick capture file into a compressed columnar archive
+// Usage: arb_archive <capture file> <archive file> [--block-ticks N] [--verify]
+//
+// Reports the compression ratio against the captured records and times a
+// full block-at-a-time decode. --verify compares every decoded tick with the
+// capture (per symbol, in file order).
+
+#include "src/util/TickArchive.hpp"
+#include "src/util/TickCapture.hpp"
+#include "src/util/NumberParser.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Blocks are reserved up front per symbol, so keep them to a sane size
+constexpr int64_t MAX_BLOCK_TICKS = 1 << 20;
+
+int usage() {
+    std::fprintf(stderr, "usage: arb_archive <capture file> <archive file> [--block-ticks N] [--verify]\n");
+    return 2;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+// Every archived tick must equal the capture record, bit for bit
+bool verify(const TickCaptureReader& capture, TickArchiveReader& archive) {
+    std::vector<std::vector<TickRecord>> by_symbol(archive.symbolCount());
+    for (size_t i = 0; i < capture.size(); ++i) {
+        const TickRecord& tick = capture.at(i);
+        if (tick.symbol_id >= by_symbol.size()) {
+            return false;
+        }
+        by_symbol[tick.symbol_id].push_back(tick);
+    }
+    
+    std::vector<size_t> positions(by_symbol.size(), 0);
+    std::vector<TickRecord> ticks;
+    for (size_t block = 0; block < archive.blockCount(); ++block) {
+        if (!archive.readBlock(block, ticks)) {
+            return false;
+        }
+        for (const auto& tick : ticks) {
+            auto& expected = by_symbol[tick.symbol_id];
+            size_t& position = positions[tick.symbol_id];
+            if (position >= expected.size() || std::memcmp(&expected[position], &tick, sizeof(TickRecord)) != 0) {
+                return false;
+            }
+            ++position;
+        }
+    }
+    for (size_t symbol_id = 0; symbol_id < by_symbol.size(); ++symbol_id) {
+        if (positions[symbol_id] != by_symbol[symbol_id].size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        return usage();
+    }
+    std::string capture_path = argv[1];
+    std::string archive_path = argv[2];
+    uint32_t block_ticks = 1024;
+    bool check = false;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--block-ticks" && i + 1 < argc) {
+            auto value = NumberParser::parseInteger(argv[++i], 1, MAX_BLOCK_TICKS);
+            if (!value.has_value()) {
+                std::fprintf(stderr, "--block-ticks must be in 1..%lld\n", static_cast<long long>(MAX_BLOCK_TICKS));
+                return usage();
+            }
+            block_ticks = static_cast<uint32_t>(value.value());
+        } else if (arg == "--verify") {
+            check = true;
+        } else {
+            return usage();
+        }
+    }
+    
+    auto capture = TickCaptureReader::open(capture_path);
+    if (!capture.has_value()) {
+        std::fprintf(stderr, "cannot open capture %s\n", capture_path.c_str());
+        return 1;
+    }
+    
+    auto started = std::chrono::steady_clock::now();
+    if (!TickArchiveWriter::convert(capture.value(), archive_path, block_ticks)) {
+        std::fprintf(stderr, "cannot write archive %s\n", archive_path.c_str());
+        return 1;
+    }
+    double convert_seconds = secondsSince(started);
+    
+    auto archive = TickArchiveReader::open(archive_path);
+    if (!archive.has_value()) {
+        std::fprintf(stderr, "cannot read back %s\n", archive_path.c_str());
+        return 1;
+    }
+    
+    // Decode everything once, block at a time
+    started = std::chrono::steady_clock::now();
+    std::vector<TickRecord> ticks;
+    uint64_t decoded = 0;
+    uint64_t archive_bytes = sizeof(TickArchiveHeader);
+    for (size_t block = 0; block < archive->blockCount(); ++block) {
+        if (!archive->readBlock(block, ticks)) {
+            std::fprintf(stderr, "corrupt block %zu\n", block);
+            return 1;
+        }
+        decoded += ticks.size();
+        archive_bytes += archive->block(block).bytes;
+    }
+    double decode_seconds = secondsSince(started);
+    
+    uint64_t record_bytes = capture->size() * sizeof(TickRecord);
+    std::printf("ticks:       %llu in %zu blocks (%u symbols)\n", static_cast<unsigned long long>(decoded),
+                archive->blockCount(), archive->symbolCount());
+    std::printf("captured:    %.1f MB of records\n", record_bytes / 1e6);
+    std::printf("archive:     %.1f MB of blocks, %.2f bytes/tick, ratio %.1fx\n", archive_bytes / 1e6,
+                decoded > 0 ? double(archive_bytes) / decoded : 0.0,
+                archive_bytes > 0 ? double(record_bytes) / archive_bytes : 0.0);
+    std::printf("convert:     %.3f s\n", convert_seconds);
+    std::printf("decode:      %.3f s, %.1f M ticks/s, %.0f MB/s of archive\n", decode_seconds,
+                decode_seconds > 0.0 ? decoded / decode_seconds / 1e6 : 0.0,
+                decode_seconds > 0.0 ? archive_bytes / decode_seconds / 1e6 : 0.0);
+    
+    if (check) {
+        bool ok = verify(capture.value(), archive.value());
+        std::printf("verify:      %s\n", ok ? "ok" : "MISMATCH");
+        return ok ? 0 : 1;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+// Shared-memory opportunity broadcast: cross-process latency test and consumer example
+// Usage: arb_broadcast_latency [messages=100000] [rate=20000]
+//        arb_broadcast_latency --subscribe <name>
+//
+// The default mode creates a private broadcast segment and forks a consumer
+// process that busy-polls it, then publishes synthetic opportunities at the
+// given rate (messages/s, 0 = flat out). The consumer reports publish ->
+// observe latency percentiles over the monotonic clock the two processes
+// share, and how many messages it lost to overruns.
+// --subscribe attaches to a running engine (arb_engine --broadcast <name>)
+// and prints every opportunity with its receive -> observe latency.
+
+#include "src/core/ArbitrageDetector.hpp"
+#include "src/core/MarketState.hpp"
+#include "src/util/LatencyHistogram.hpp"
+#include "src/util/OpportunityBroadcast.hpp"
+#include "src/util/OpportunityBroadcaster.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Steady = std::chrono::steady_clock;
+
+int subscribe(const std::string& name) {
+    auto subscriber = OpportunitySubscriber::open(name);
+    if (!subscriber.has_value()) {
+        std::fprintf(stderr, "cannot attach to broadcast %s\n", name.c_str());
+        return 1;
+    }
+    std::printf("attached to %s (%llu slots), next sequence %llu\n", name.c_str(),
+                static_cast<unsigned long long>(subscriber->capacity()),
+                static_cast<unsigned long long>(subscriber->nextSequence()));
+    OpportunityMessage message;
+    for (;;) {
+        BroadcastPoll result = subscriber->poll(message);
+        if (result == BroadcastPoll::Empty) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (result == BroadcastPoll::Overrun) {
+            std::printf("overrun: %llu messages lost so far\n", static_cast<unsigned long long>(subscriber->getLostCount()));
+            continue;
+        }
+        uint64_t observed_ns = PipelineLatency::nowNs();
+        std::printf("#%llu route %u dir%d %s %s %s %.4f%% receive->observe %.1f us\n",
+                    static_cast<unsigned long long>(message.sequence), message.route_id, message.direction,
+                    message.legs[0], message.legs[1], message.legs[2], message.profit_percent,
+                    message.receive_ns != 0 ? (observed_ns - message.receive_ns) / 1000.0 : 0.0);
+    }
+}
+
+#ifndef _WIN32
+
+// Consumer process: read every sequence up to messages, then report
+int consume(const std::string& name, uint64_t messages) {
+    std::optional<OpportunitySubscriber> subscriber;
+    auto deadline = Steady::now() + std::chrono::seconds(5);
+    while (!(subscriber = OpportunitySubscriber::open(name, true)).has_value()) {
+        if (Steady::now() > deadline) {
+            std::fprintf(stderr, "consumer: cannot attach to %s\n", name.c_str());
+            return 1;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    
+    LatencyHistogram latency;
+    uint64_t received = 0;
+    OpportunityMessage message;
+    while (subscriber->nextSequence() <= messages) {
+        BroadcastPoll result = subscriber->poll(message);
+        if (result == BroadcastPoll::Message) {
+            latency.record(PipelineLatency::nowNs() - message.publish_ns);
+            ++received;
+        }
+    }
+    
+    HistogramSnapshot snapshot;
+    latency.mergeInto(snapshot);
+    std::printf("received %llu, lost %llu\n", static_cast<unsigned long long>(received),
+                static_cast<unsigned long long>(subscriber->getLostCount()));
+    std::printf("publish->observe us: p50 %.2f  p99 %.2f  p99.9 %.2f  max %.2f\n",
+                snapshot.percentile(0.50) / 1000.0, snapshot.percentile(0.99) / 1000.0,
+                snapshot.percentile(0.999) / 1000.0, snapshot.max_ns / 1000.0);
+    return 0;
+}
+
+#endif
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::string(argv[1]) == "--subscribe") {
+        return subscribe(argv[2]);
+    }
+
+#ifdef _WIN32
+    std::fprintf(stderr, "the forked latency test needs POSIX; use --subscribe <name> against a running engine\n");
+    return 2;
+#else
+    uint64_t messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000;
+    double rate = argc > 2 ? std::atof(argv[2]) : 20000.0;
+    std::string name = "arb_broadcast_test_" + std::to_string(getpid());
+    
+    MarketState market_state;
+    ArbitrageOpportunity opp;
+    opp.kind = RouteKind::CrossPair;
+    opp.direction = 1;
+    opp.legs = {market_state.getSymbolId("ARB/BTC"), market_state.getSymbolId("BTC/USDT"),
+                market_state.getSymbolId("ARB/USDT")};
+    opp.profit_percent = 0.25;
+    opp.valid = true;
+    
+    auto broadcaster = OpportunityBroadcaster::create(name, market_state);
+    if (!broadcaster) {
+        std::fprintf(stderr, "cannot create broadcast %s\n", name.c_str());
+        return 1;
+    }
+    
+    pid_t child = fork();
+    if (child < 0) {
+        std::perror("fork");
+        return 1;
+    }
+    if (child == 0) {
+        int result = consume(name, messages);
+        std::fflush(stdout);
+        _exit(result); // Skip destructors: the parent owns the segment
+    }
+    
+    // Let the consumer attach and start spinning
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::printf("publishing %llu messages at %s to %s\n", static_cast<unsigned long long>(messages),
+                rate > 0.0 ? (std::to_string(static_cast<long long>(rate)) + "/s").c_str() : "full speed", name.c_str());
+    std::fflush(stdout);
+    
+    auto started = Steady::now();
+    for (uint64_t n = 0; n < messages; ++n) {
+        if (rate > 0.0) {
+            auto due = started + std::chrono::duration_cast<Steady::duration>(std::chrono::duration<double>(n / rate));
+            while (Steady::now() < due) {
+            }
+        }
+        opp.route_id = static_cast<uint32_t>(n);
+        broadcaster->publish(opp, 0, 0);
+    }
+    
+    int status = 0;
+    waitpid(child, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+#endif
+}
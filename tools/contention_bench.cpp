@@ -0,0 +1,386 @@
+// MarketState / OrderBook contention stress harness
+// Usage: arb_contention_bench [--writers 1,2,4,8] [--readers 0,2,4] [--modes lookup,cached]
+//                             [--symbols 256] [--seconds 1] [--overlap] [--csv scaling.csv]
+//
+// Writer threads play feed connections and apply top-of-book updates to their
+// own slice of the symbols (every writer to every symbol with --overlap).
+// Reader threads play the detector and snapshot one random book per read.
+// Every combination of writer count, reader count and mode runs for the given
+// number of seconds:
+//   lookup  every access goes through MarketState::get by name, like the feed
+//           clients and the detector's full scan (symbol map lock + book lock)
+//   cached  books are resolved once up front, like the pipeline and the
+//           trigger index (book lock only)
+// Reported per configuration: update and read throughput, p50/p99/p99.9 of
+// single operations (every 8th one is timed) and the time contended
+// MarketState and OrderBook acquisitions spent waiting (LockContention), as a
+// share of total thread time. --csv writes the same table as one row per
+// configuration. A new book store is compared by adding a mode to access().
+
+#include "src/core/MarketState.hpp"
+#include "src/util/LatencyHistogram.hpp"
+#include "src/util/LockContention.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t SEQUENCE_SIZE = 4096;  // Pre-generated access pattern per thread, power of two
+constexpr size_t STOP_CHECK_EVERY = 64;
+constexpr uint64_t TIME_EVERY = 8;      // Timing every operation would dominate the cached mode
+
+enum class Mode {
+    Lookup,
+    Cached
+};
+
+const char* modeName(Mode mode) {
+    return mode == Mode::Lookup ? "lookup" : "cached";
+}
+
+struct Settings {
+    std::vector<size_t> writers{1, 2, 4, 8};
+    std::vector<size_t> readers{0, 2, 4};
+    std::vector<Mode> modes{Mode::Lookup, Mode::Cached};
+    size_t symbols = 256;
+    double seconds = 1.0;
+    bool overlap = false;
+    std::string csv_path;
+};
+
+struct Result {
+    Mode mode;
+    size_t writers;
+    size_t readers;
+    double seconds;
+    uint64_t updates = 0;
+    uint64_t reads = 0;
+    HistogramSnapshot update_latency;
+    HistogramSnapshot read_latency;
+    LockContentionStats map_wait;
+    LockContentionStats book_wait;
+    
+    double waitShare(const LockContentionStats& wait) const {
+        double thread_ns = static_cast<double>(writers + readers) * seconds * 1e9;
+        return thread_ns > 0.0 ? 100.0 * static_cast<double>(wait.wait_ns) / thread_ns : 0.0;
+    }
+};
+
+// One benchmark thread's counters; LatencyHistogram is single writer
+struct ThreadResult {
+    uint64_t operations = 0;
+    double checksum = 0.0;  // Keeps the snapshots observable
+    LatencyHistogram latency;
+};
+
+std::vector<size_t> parseList(const std::string& text) {
+    std::vector<size_t> values;
+    std::istringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(std::strtoull(item.c_str(), nullptr, 10));
+        }
+    }
+    return values;
+}
+
+bool parseSettings(int argc, char* argv[], Settings& settings) {
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (flag == "--overlap") {
+            settings.overlap = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for option: %s\n", flag.c_str());
+            return false;
+        }
+        std::string value = argv[++i];
+        if (flag == "--writers") {
+            settings.writers = parseList(value);
+        } else if (flag == "--readers") {
+            settings.readers = parseList(value);
+        } else if (flag == "--modes") {
+            settings.modes.clear();
+            std::istringstream stream(value);
+            std::string mode;
+            while (std::getline(stream, mode, ',')) {
+                if (mode == "lookup") {
+                    settings.modes.push_back(Mode::Lookup);
+                } else if (mode == "cached") {
+                    settings.modes.push_back(Mode::Cached);
+                } else {
+                    std::fprintf(stderr, "Unknown mode: %s (lookup, cached)\n", mode.c_str());
+                    return false;
+                }
+            }
+        } else if (flag == "--symbols") {
+            settings.symbols = std::max<size_t>(1, std::strtoull(value.c_str(), nullptr, 10));
+        } else if (flag == "--seconds") {
+            settings.seconds = std::max(0.05, std::atof(value.c_str()));
+        } else if (flag == "--csv") {
+            settings.csv_path = value;
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", flag.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t xorshift(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Random indices into [begin, end)
+std::vector<uint32_t> buildSequence(size_t begin, size_t end, uint64_t seed) {
+    std::vector<uint32_t> sequence(SEQUENCE_SIZE);
+    uint64_t state = seed * 0x9E3779B97F4A7C15ULL + 1;
+    for (auto& index : sequence) {
+        index = static_cast<uint32_t>(begin + xorshift(state) % (end - begin));
+    }
+    return sequence;
+}
+
+class ContentionBench {
+public:
+    explicit ContentionBench(const Settings& settings) : settings_(settings) {
+        // Every book exists and has data before the clock starts
+        for (size_t i = 0; i < settings_.symbols; ++i) {
+            char name[32];
+            std::snprintf(name, sizeof(name), "S%04zu/USDT", i);
+            names_.emplace_back(name);
+            books_.push_back(&market_state_.get(names_.back()));
+            books_.back()->update(1.0, 1.0, 1.001, 1.0, 1);
+        }
+    }
+    
+    Result run(Mode mode, size_t writers, size_t readers) {
+        std::vector<std::unique_ptr<ThreadResult>> writer_results;
+        std::vector<std::unique_ptr<ThreadResult>> reader_results;
+        std::vector<std::thread> threads;
+        std::atomic<size_t> ready{0};
+        std::atomic<bool> go{false};
+        stop_.store(false);
+        
+        for (size_t w = 0; w < writers; ++w) {
+            size_t begin = settings_.overlap ? 0 : settings_.symbols * w / writers;
+            size_t end = settings_.overlap ? settings_.symbols : std::max(begin + 1, settings_.symbols * (w + 1) / writers);
+            writer_results.push_back(std::make_unique<ThreadResult>());
+            ThreadResult* result = writer_results.back().get();
+            std::vector<uint32_t> sequence = buildSequence(begin, std::min(end, settings_.symbols), w + 1);
+            threads.emplace_back([this, mode, result, sequence, &ready, &go]() {
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                writeLoop(mode, sequence, *result);
+            });
+        }
+        for (size_t r = 0; r < readers; ++r) {
+            reader_results.push_back(std::make_unique<ThreadResult>());
+            ThreadResult* result = reader_results.back().get();
+            std::vector<uint32_t> sequence = buildSequence(0, settings_.symbols, 1000 + r);
+            threads.emplace_back([this, mode, result, sequence, &ready, &go]() {
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                readLoop(mode, sequence, *result);
+            });
+        }
+        
+        while (ready.load() < threads.size()) {
+            std::this_thread::yield();
+        }
+        LockContentionStats map_before = LockContention::get(LockSite::MarketState);
+        LockContentionStats book_before = LockContention::get(LockSite::OrderBook);
+        auto start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        std::this_thread::sleep_for(std::chrono::duration<double>(settings_.seconds));
+        stop_.store(true, std::memory_order_relaxed);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        
+        Result result;
+        result.mode = mode;
+        result.writers = writers;
+        result.readers = readers;
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        for (const auto& thread : writer_results) {
+            result.updates += thread->operations;
+            thread->latency.mergeInto(result.update_latency);
+        }
+        for (const auto& thread : reader_results) {
+            result.reads += thread->operations;
+            thread->latency.mergeInto(result.read_latency);
+        }
+        LockContentionStats map_after = LockContention::get(LockSite::MarketState);
+        LockContentionStats book_after = LockContention::get(LockSite::OrderBook);
+        result.map_wait = {map_after.contended - map_before.contended, map_after.wait_ns - map_before.wait_ns};
+        result.book_wait = {book_after.contended - book_before.contended, book_after.wait_ns - book_before.wait_ns};
+        return result;
+    }
+
+private:
+    OrderBook& access(Mode mode, uint32_t index) {
+        switch (mode) {
+            case Mode::Lookup:
+                return market_state_.get(names_[index]);
+            case Mode::Cached:
+            default:
+                return *books_[index];
+        }
+    }
+    
+    void writeLoop(Mode mode, const std::vector<uint32_t>& sequence, ThreadResult& result) {
+        uint64_t operations = 0;
+        double price = 1.0;
+        while (!stop_.load(std::memory_order_relaxed)) {
+            for (size_t i = 0; i < STOP_CHECK_EVERY; ++i, ++operations) {
+                uint32_t index = sequence[operations & (SEQUENCE_SIZE - 1)];
+                price = price > 1.01 ? 1.0 : price + 0.00001;
+                if (operations % TIME_EVERY == 0) {
+                    uint64_t start_ns = PipelineLatency::nowNs();
+                    access(mode, index).update(price, 1.0, price * 1.001, 1.0, static_cast<int64_t>(operations));
+                    result.latency.record(PipelineLatency::nowNs() - start_ns);
+                } else {
+                    access(mode, index).update(price, 1.0, price * 1.001, 1.0, static_cast<int64_t>(operations));
+                }
+            }
+        }
+        result.operations = operations;
+    }
+    
+    void readLoop(Mode mode, const std::vector<uint32_t>& sequence, ThreadResult& result) {
+        uint64_t operations = 0;
+        double checksum = 0.0;
+        while (!stop_.load(std::memory_order_relaxed)) {
+            for (size_t i = 0; i < STOP_CHECK_EVERY; ++i, ++operations) {
+                uint32_t index = sequence[operations & (SEQUENCE_SIZE - 1)];
+                if (operations % TIME_EVERY == 0) {
+                    uint64_t start_ns = PipelineLatency::nowNs();
+                    checksum += access(mode, index).snapshot().bid_price;
+                    result.latency.record(PipelineLatency::nowNs() - start_ns);
+                } else {
+                    checksum += access(mode, index).snapshot().bid_price;
+                }
+            }
+        }
+        result.operations = operations;
+        result.checksum = checksum;
+    }
+    
+    const Settings& settings_;
+    MarketState market_state_;
+    std::vector<std::string> names_;
+    std::vector<OrderBook*> books_;
+    std::atomic<bool> stop_{false};
+};
+
+void printHeader() {
+    std::printf("%-7s %3s %3s %12s %12s %22s %22s %9s %9s\n", "mode", "W", "R", "updates/s", "reads/s",
+                "update p50/p99/p999 ns", "read p50/p99/p999 ns", "map wait", "book wait");
+}
+
+void printResult(const Result& result) {
+    char update_latency[32] = "-";
+    char read_latency[32] = "-";
+    if (result.update_latency.total > 0) {
+        std::snprintf(update_latency, sizeof(update_latency), "%llu/%llu/%llu",
+                      static_cast<unsigned long long>(result.update_latency.percentile(0.50)),
+                      static_cast<unsigned long long>(result.update_latency.percentile(0.99)),
+                      static_cast<unsigned long long>(result.update_latency.percentile(0.999)));
+    }
+    if (result.read_latency.total > 0) {
+        std::snprintf(read_latency, sizeof(read_latency), "%llu/%llu/%llu",
+                      static_cast<unsigned long long>(result.read_latency.percentile(0.50)),
+                      static_cast<unsigned long long>(result.read_latency.percentile(0.99)),
+                      static_cast<unsigned long long>(result.read_latency.percentile(0.999)));
+    }
+    std::printf("%-7s %3zu %3zu %12.0f %12.0f %22s %22s %8.2f%% %8.2f%%\n", modeName(result.mode),
+                result.writers, result.readers, static_cast<double>(result.updates) / result.seconds,
+                static_cast<double>(result.reads) / result.seconds, update_latency, read_latency,
+                result.waitShare(result.map_wait), result.waitShare(result.book_wait));
+    std::fflush(stdout);
+}
+
+bool writeCsv(const std::string& path, const Settings& settings, const std::vector<Result>& results) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fprintf(file, "mode,writers,readers,symbols,overlap,seconds,updates_per_s,reads_per_s,"
+                       "update_p50_ns,update_p99_ns,update_p999_ns,read_p50_ns,read_p99_ns,read_p999_ns,"
+                       "market_state_contended,market_state_wait_ns,market_state_wait_share,"
+                       "order_book_contended,order_book_wait_ns,order_book_wait_share\n");
+    for (const auto& result : results) {
+        std::fprintf(file, "%s,%zu,%zu,%zu,%d,%.3f,%.0f,%.0f,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%llu,%.4f,%llu,%llu,%.4f\n",
+                     modeName(result.mode), result.writers, result.readers, settings.symbols, settings.overlap ? 1 : 0,
+                     result.seconds, static_cast<double>(result.updates) / result.seconds,
+                     static_cast<double>(result.reads) / result.seconds,
+                     static_cast<unsigned long long>(result.update_latency.percentile(0.50)),
+                     static_cast<unsigned long long>(result.update_latency.percentile(0.99)),
+                     static_cast<unsigned long long>(result.update_latency.percentile(0.999)),
+                     static_cast<unsigned long long>(result.read_latency.percentile(0.50)),
+                     static_cast<unsigned long long>(result.read_latency.percentile(0.99)),
+                     static_cast<unsigned long long>(result.read_latency.percentile(0.999)),
+                     static_cast<unsigned long long>(result.map_wait.contended),
+                     static_cast<unsigned long long>(result.map_wait.wait_ns), result.waitShare(result.map_wait) / 100.0,
+                     static_cast<unsigned long long>(result.book_wait.contended),
+                     static_cast<unsigned long long>(result.book_wait.wait_ns), result.waitShare(result.book_wait) / 100.0);
+    }
+    std::fclose(file);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Settings settings;
+    if (!parseSettings(argc, argv, settings)) {
+        return 1;
+    }
+    
+    std::printf("%zu symbols, %s writer slices, %.2fs per configuration, %u hardware threads\n",
+                settings.symbols, settings.overlap ? "overlapping" : "disjoint", settings.seconds,
+                std::thread::hardware_concurrency());
+    printHeader();
+    
+    ContentionBench bench(settings);
+    std::vector<Result> results;
+    for (Mode mode : settings.modes) {
+        for (size_t writers : settings.writers) {
+            for (size_t readers : settings.readers) {
+                if (writers + readers == 0) {
+                    continue;
+                }
+                results.push_back(bench.run(mode, writers, readers));
+                printResult(results.back());
+            }
+        }
+    }
+    
+    if (!settings.csv_path.empty()) {
+        if (!writeCsv(settings.csv_path, settings, results)) {
+            std::fprintf(stderr, "Cannot write %s\n", settings.csv_path.c_str());
+            return 1;
+        }
+        std::printf("Scaling table written to %s\n", settings.csv_path.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,333 @@
+// Market-data gateway: subscriber example and fan-out load test
+// Usage: arb_gateway_client --subscribe <port|socket path> [symbols=*]
+//        arb_gateway_client [clients=300] [symbols=500] [seconds=5] [rate=50000]
+//
+// --subscribe connects to a running engine (arb_engine --gateway-port N or
+// --gateway-socket path), subscribes to a comma-separated symbol list and
+// prints every quote with its receive -> decode latency.
+// The default mode starts an in-process gateway and a publisher thread that
+// pushes synthetic updates at the given rate (updates/s, 0 = flat out), then
+// connects the given number of subscribers on one client thread: a quarter
+// take every symbol, the rest 16 symbols each, and every 50th client reads
+// slowly so conflation can be observed. It reports the cost of publish() on
+// the feed thread, receive -> decode latency and the gateway counters.
+
+#include "src/core/MarketState.hpp"
+#include "src/net/GatewayProtocol.hpp"
+#include "src/net/MarketDataGateway.hpp"
+#include "src/util/JsonParser.hpp"
+#include "src/util/LatencyHistogram.hpp"
+#include <boost/asio.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Steady = std::chrono::steady_clock;
+using boost::asio::ip::tcp;
+
+constexpr size_t READ_CHUNK = 64 * 1024;
+constexpr uint16_t LOAD_TEST_PORT = 47100;  // Loopback port for the load test without Unix sockets
+
+int64_t wallNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Splits a byte stream into gateway frames
+class FrameDecoder {
+public:
+    // Append received bytes; invokes on_symbol/on_quote per complete frame
+    template <typename OnSymbol, typename OnQuote>
+    void feed(const char* data, size_t size, OnSymbol&& on_symbol, OnQuote&& on_quote) {
+        buffer_.insert(buffer_.end(), data, data + size);
+        size_t offset = 0;
+        while (buffer_.size() - offset >= sizeof(uint16_t) + sizeof(uint8_t)) {
+            uint16_t length;
+            std::memcpy(&length, buffer_.data() + offset, sizeof(length));
+            if (length < 4 || buffer_.size() - offset < length) {
+                break;
+            }
+            uint8_t type = static_cast<uint8_t>(buffer_[offset + 2]);
+            if (type == GATEWAY_FRAME_SYMBOL && length == sizeof(GatewaySymbolFrame)) {
+                GatewaySymbolFrame frame;
+                std::memcpy(&frame, buffer_.data() + offset, sizeof(frame));
+                on_symbol(frame);
+            } else if (type == GATEWAY_FRAME_QUOTE && length == sizeof(GatewayQuoteFrame)) {
+                GatewayQuoteFrame frame;
+                std::memcpy(&frame, buffer_.data() + offset, sizeof(frame));
+                on_quote(frame);
+            }
+            offset += length; // Unknown types are skipped
+        }
+        buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(offset));
+    }
+
+private:
+    std::vector<char> buffer_;
+};
+
+int subscribe(const std::string& endpoint, const std::string& symbols) {
+    boost::asio::io_context io;
+    std::unique_ptr<tcp::socket> tcp_socket;
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    std::unique_ptr<boost::asio::local::stream_protocol::socket> unix_socket;
+#endif
+    try {
+        if (!endpoint.empty() && std::all_of(endpoint.begin(), endpoint.end(), ::isdigit)) {
+            tcp_socket = std::make_unique<tcp::socket>(io);
+            tcp_socket->connect(tcp::endpoint(boost::asio::ip::address_v4::loopback(),
+                                              static_cast<uint16_t>(std::stoi(endpoint))));
+        } else {
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+            unix_socket = std::make_unique<boost::asio::local::stream_protocol::socket>(io);
+            unix_socket->connect(boost::asio::local::stream_protocol::endpoint(endpoint));
+#else
+            std::fprintf(stderr, "Unix sockets are not available; pass a TCP port\n");
+            return 2;
+#endif
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "cannot connect to %s: %s\n", endpoint.c_str(), e.what());
+        return 1;
+    }
+    
+    // Both socket types share the read/write calls used here
+    auto run = [&](auto& socket) {
+        std::string command = "SUB " + symbols + "\n";
+        boost::asio::write(socket, boost::asio::buffer(command));
+        std::printf("subscribed to %s on %s\n", symbols.c_str(), endpoint.c_str());
+        
+        FrameDecoder decoder;
+        std::unordered_map<uint32_t, std::string> names;
+        std::vector<char> chunk(READ_CHUNK);
+        boost::system::error_code ec;
+        for (;;) {
+            size_t bytes = socket.read_some(boost::asio::buffer(chunk), ec);
+            if (ec) {
+                std::printf("disconnected: %s\n", ec.message().c_str());
+                return 0;
+            }
+            decoder.feed(chunk.data(), bytes,
+                         [&](const GatewaySymbolFrame& frame) { names[frame.symbol_id] = frame.name; },
+                         [&](const GatewayQuoteFrame& quote) {
+                             std::printf("%-12s #%llu bid %.8f x %.4f ask %.8f x %.4f%s receive->decode %.1f us\n",
+                                         names[quote.symbol_id].c_str(), static_cast<unsigned long long>(quote.update_id),
+                                         quote.bid_price, quote.bid_qty, quote.ask_price, quote.ask_qty,
+                                         (quote.flags & GATEWAY_QUOTE_CONFLATED) ? " (conflated)" : "",
+                                         (wallNs() - quote.receive_time_ns) / 1000.0);
+                         });
+        }
+    };
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    if (unix_socket) {
+        return run(*unix_socket);
+    }
+#endif
+    return run(*tcp_socket);
+}
+
+// Load-test subscriber; all of them share the client io thread
+template <typename Socket>
+class LoadClient : public std::enable_shared_from_this<LoadClient<Socket>> {
+public:
+    LoadClient(Socket socket, LatencyHistogram& latency, bool slow)
+        : socket_(std::move(socket)), timer_(socket_.get_executor()), latency_(latency),
+          slow_(slow), chunk_(READ_CHUNK) {}
+    
+    void start(const std::string& symbols) {
+        command_ = "SUB " + symbols + "\n";
+        boost::asio::write(socket_, boost::asio::buffer(command_));
+        read();
+    }
+    
+    uint64_t getQuotes() const { return quotes_; }
+    uint64_t getConflated() const { return conflated_; }
+    bool isSlow() const { return slow_; }
+
+private:
+    void read() {
+        auto self = this->shared_from_this();
+        socket_.async_read_some(boost::asio::buffer(chunk_), [this, self](const boost::system::error_code& ec, size_t bytes) {
+            if (ec) {
+                return;
+            }
+            int64_t now_ns = wallNs();
+            decoder_.feed(chunk_.data(), bytes, [](const GatewaySymbolFrame&) {},
+                          [&](const GatewayQuoteFrame& quote) {
+                              ++quotes_;
+                              if (quote.flags & GATEWAY_QUOTE_CONFLATED) {
+                                  ++conflated_;
+                              }
+                              if (!slow_ && now_ns > quote.receive_time_ns) {
+                                  latency_.record(static_cast<uint64_t>(now_ns - quote.receive_time_ns));
+                              }
+                          });
+            if (!slow_) {
+                read();
+                return;
+            }
+            // Slow consumer: stall between reads so the gateway has to conflate
+            timer_.expires_after(std::chrono::milliseconds(20));
+            timer_.async_wait([this, self](const boost::system::error_code& wait_ec) {
+                if (!wait_ec) {
+                    read();
+                }
+            });
+        });
+    }
+    
+    Socket socket_;
+    boost::asio::steady_timer timer_;
+    LatencyHistogram& latency_;
+    bool slow_;
+    std::string command_;
+    std::vector<char> chunk_;
+    FrameDecoder decoder_;
+    uint64_t quotes_ = 0;
+    uint64_t conflated_ = 0;
+};
+
+void printPercentiles(const char* label, const LatencyHistogram& histogram) {
+    HistogramSnapshot snapshot;
+    histogram.mergeInto(snapshot);
+    std::printf("%s us: p50 %.2f  p99 %.2f  p99.9 %.2f  max %.2f  (%llu samples)\n", label,
+                snapshot.percentile(0.50) / 1000.0, snapshot.percentile(0.99) / 1000.0,
+                snapshot.percentile(0.999) / 1000.0, snapshot.max_ns / 1000.0,
+                static_cast<unsigned long long>(snapshot.total));
+}
+
+int loadTest(size_t client_count, uint32_t symbol_count, int seconds, double rate) {
+    MarketState market_state;
+    std::vector<SymbolId> ids;
+    for (uint32_t i = 0; i < symbol_count; ++i) {
+        ids.push_back(market_state.getSymbolId("S" + std::to_string(i) + "/USDT"));
+    }
+    
+    GatewayConfig config;
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    using Protocol = boost::asio::local::stream_protocol;
+    config.unix_path = "/tmp/arb_gateway_test_" + std::to_string(getpid()) + ".sock";
+    Protocol::endpoint endpoint(config.unix_path);
+#else
+    using Protocol = tcp;
+    config.tcp_port = LOAD_TEST_PORT;
+    Protocol::endpoint endpoint(boost::asio::ip::address_v4::loopback(), LOAD_TEST_PORT);
+#endif
+    auto gateway = MarketDataGateway::create(market_state, config);
+    if (!gateway) {
+        std::fprintf(stderr, "cannot start the gateway\n");
+        return 1;
+    }
+    gateway->start();
+    
+    // Subscribers connect before the publisher starts
+    boost::asio::io_context io;
+    LatencyHistogram latency;
+    std::vector<std::shared_ptr<LoadClient<Protocol::socket>>> clients;
+    for (size_t k = 0; k < client_count; ++k) {
+        Protocol::socket socket(io);
+        socket.connect(endpoint);
+        std::string symbols;
+        if (k % 4 == 0) {
+            symbols = "*";
+        } else {
+            for (uint32_t j = 0; j < 16; ++j) {
+                symbols += (j > 0 ? "," : "") + market_state.getSymbolName(ids[(k * 7 + j) % symbol_count]);
+            }
+        }
+        clients.push_back(std::make_shared<LoadClient<Protocol::socket>>(std::move(socket), latency, k % 50 == 49));
+        clients.back()->start(symbols);
+    }
+    std::thread client_thread([&io]() { io.run(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    
+    std::printf("publishing to %zu clients over %u symbols at %s for %d s\n", client_count, symbol_count,
+                rate > 0.0 ? (std::to_string(static_cast<long long>(rate)) + "/s").c_str() : "full speed", seconds);
+    std::fflush(stdout);
+    
+    // Feed thread stand-in
+    LatencyHistogram publish_cost;
+    uint64_t published = 0;
+    BookTickerData data;
+    data.valid = true;
+    auto started = Steady::now();
+    auto deadline = started + std::chrono::seconds(seconds);
+    while (Steady::now() < deadline) {
+        if (rate > 0.0) {
+            auto due = started + std::chrono::duration_cast<Steady::duration>(std::chrono::duration<double>(published / rate));
+            while (Steady::now() < due) {
+            }
+        }
+        data.update_id = published;
+        data.bid_price = 1.0 + (published % 100) * 0.0001;
+        data.ask_price = data.bid_price + 0.0001;
+        data.bid_qty = 10.0;
+        data.ask_qty = 12.0;
+        int64_t receive_time_ns = wallNs();
+        auto before = Steady::now();
+        gateway->publish(ids[published % symbol_count], data, receive_time_ns);
+        publish_cost.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Steady::now() - before).count()));
+        ++published;
+    }
+    
+    // Let the last flush reach the clients
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    GatewayStats stats = gateway->getStats();
+    gateway->stop();
+    io.stop();
+    client_thread.join();
+    
+    uint64_t fast_quotes = 0;
+    uint64_t slow_quotes = 0;
+    uint64_t slow_conflated = 0;
+    for (const auto& client : clients) {
+        if (client->isSlow()) {
+            slow_quotes += client->getQuotes();
+            slow_conflated += client->getConflated();
+        } else {
+            fast_quotes += client->getQuotes();
+        }
+    }
+    std::printf("published %llu updates (%.0f/s)\n", static_cast<unsigned long long>(published),
+                published / std::chrono::duration<double>(Steady::now() - started).count());
+    printPercentiles("publish() cost", publish_cost);
+    printPercentiles("receive->decode", latency);
+    std::printf("clients %llu, quotes sent %llu (%llu conflated), %.1f MB\n",
+                static_cast<unsigned long long>(stats.accepted), static_cast<unsigned long long>(stats.quotes_sent),
+                static_cast<unsigned long long>(stats.quotes_conflated), stats.bytes_sent / 1e6);
+    std::printf("fast clients decoded %llu quotes; slow clients %llu (%llu flagged conflated)\n",
+                static_cast<unsigned long long>(fast_quotes), static_cast<unsigned long long>(slow_quotes),
+                static_cast<unsigned long long>(slow_conflated));
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 2 && std::string(argv[1]) == "--subscribe") {
+        return subscribe(argv[2], argc > 3 ? argv[3] : "*");
+    }
+    
+    size_t clients = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 300;
+    uint32_t symbols = argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 500;
+    int seconds = argc > 3 ? std::atoi(argv[3]) : 5;
+    double rate = argc > 4 ? std::atof(argv[4]) : 50000.0;
+    return loadTest(std::max<size_t>(clients, 1), std::max<uint32_t>(symbols, 16), std::max(seconds, 1), rate);
+}
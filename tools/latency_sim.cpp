@@ -0,0 +1,531 @@
+// Latency sensitivity of detected profit, from tick capture or archive files
+// Usage: arb_latency_sim <capture/archive files...> [--threads N] [--threshold PERCENT]
+//                        [--fee PERCENT] [--latencies-us 0,10,100,...] [--csv out.csv]
+//
+// Every file is replayed through the detector as in arb_replay, recording each
+// opportunity the event path reports. Each opportunity is then re-priced as if
+// its orders reached the exchange X microseconds after the triggering frame was
+// received: every leg is read at the last recorded book state at or before t + X,
+// and the same route and direction are evaluated again for profit and size.
+// The result is a decay curve per route and direction over the latency sweep.
+//
+// Detection is sequential per file, one file per worker thread; re-pricing is
+// split into fixed chunks of opportunities spread over all workers and merged
+// in chunk order, so output depends only on the input files.
+
+#include "src/core/ArbitrageDetector.hpp"
+#include "src/core/MarketState.hpp"
+#include "src/core/OpportunityFormatter.hpp"
+#include "src/util/Clock.hpp"
+#include "src/util/NumberParser.hpp"
+#include "src/util/TickSource.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t CHUNK_OPPORTUNITIES = 4096;
+
+struct Options {
+    std::vector<std::string> files;
+    unsigned threads = 0;
+    double threshold_percent = 0.10;
+    double fee_percent = 0.0;
+    std::vector<int64_t> latencies_us = {0, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 50000};
+    std::string csv_path;
+};
+
+// Top of book of one symbol from one recorded tick on
+struct BookPoint {
+    int64_t time_ns;
+    double bid_price;
+    double bid_qty;
+    double ask_price;
+    double ask_qty;
+};
+
+// One opportunity reported by the event path
+struct Detection {
+    int64_t time_ns;  // Receive time of the frame that triggered it
+    uint32_t route_id;
+    int direction;
+    double profit_percent;
+    double max_tradable_amount;
+};
+
+// Everything re-pricing needs from one replayed file
+struct FileReplay {
+    std::string path;
+    bool opened = false;
+    bool complete = true;
+    uint64_t ticks = 0;
+    double elapsed_seconds = 0.0;
+    std::vector<std::vector<BookPoint>> timelines;  // By MarketState symbol id, in time order
+    std::vector<RouteKind> route_kinds;             // By route id
+    std::vector<std::array<SymbolId, 4>> route_books;  // Route pairs incl. valuation, by route id
+    std::vector<std::string> route_names;           // By route id
+    std::vector<Detection> detections;
+};
+
+// One point of a decay curve
+struct CurvePoint {
+    uint64_t samples = 0;
+    uint64_t above_threshold = 0;  // Still at or above the detection threshold
+    uint64_t profitable = 0;       // Still above zero after fees
+    double detected_profit_sum = 0.0;
+    double captured_profit_sum = 0.0;
+    double detected_size_sum = 0.0;
+    double captured_size_sum = 0.0;
+};
+
+using Curves = std::map<std::string, std::vector<CurvePoint>>;  // "route name dirN" -> one point per latency
+
+// Profit and size of one route direction at given leg prices
+struct Evaluation {
+    bool valid = false;
+    double profit_percent = 0.0;
+    double max_tradable_amount = 0.0;  // In the base asset of the first leg
+};
+
+// Books a route reads: its legs, plus the valuation pair of a multi-leg route
+size_t bookCount(RouteKind kind) {
+    switch (kind) {
+        case RouteKind::DirectComparison:
+            return 2;
+        case RouteKind::MultiLeg:
+            return 4;
+        case RouteKind::CrossPair:
+            break;
+    }
+    return 3;
+}
+
+// Same formulas and depth walk as ArbitrageDetector, for a fixed direction:
+// the direction detected is the one traded, even if the other one is better later
+Evaluation evaluate(RouteKind kind, int direction, const std::array<const BookPoint*, 4>& legs, double fee_factor) {
+    Evaluation result;
+    for (size_t i = 0; i < bookCount(kind); ++i) {
+        if (legs[i] == nullptr || legs[i]->bid_price <= 0.0 || legs[i]->ask_price <= 0.0) {
+            return result;
+        }
+    }
+    
+    double cost = 0.0;
+    double proceeds = 0.0;
+    switch (kind) {
+        case RouteKind::CrossPair: {
+            const BookPoint& arb_other = *legs[0];
+            const BookPoint& other_usdt = *legs[1];
+            const BookPoint& arb_usdt = *legs[2];
+            if (direction == 1) {
+                // Buy ARB/XXX -> Buy XXX/USDT -> Sell ARB/USDT
+                cost = arb_other.ask_price * other_usdt.ask_price;
+                proceeds = arb_usdt.bid_price;
+                double step2_xxx = std::min(other_usdt.ask_qty, arb_other.ask_qty * arb_other.ask_price / other_usdt.ask_price);
+                result.max_tradable_amount = std::min({arb_other.ask_qty, step2_xxx / arb_other.ask_price,
+                                                       std::min(arb_usdt.bid_qty, arb_other.ask_qty)});
+            } else {
+                // Buy ARB/USDT -> Sell ARB/XXX -> Sell XXX/USDT
+                cost = arb_usdt.ask_price;
+                proceeds = arb_other.bid_price * other_usdt.bid_price;
+                double step2_arb = std::min(arb_other.bid_qty, arb_usdt.ask_qty);
+                double step3_xxx = std::min(other_usdt.bid_qty, step2_arb * arb_other.bid_price);
+                result.max_tradable_amount = std::min({arb_usdt.ask_qty, step2_arb, step3_xxx / arb_other.bid_price});
+            }
+            break;
+        }
+        case RouteKind::DirectComparison: {
+            const BookPoint& arb_stable = *legs[0];
+            const BookPoint& arb_usdt = *legs[1];
+            const BookPoint& buy = direction == 1 ? arb_stable : arb_usdt;
+            const BookPoint& sell = direction == 1 ? arb_usdt : arb_stable;
+            cost = buy.ask_price;
+            proceeds = sell.bid_price;
+            result.max_tradable_amount = std::min(buy.ask_qty, sell.bid_qty);
+            break;
+        }
+        case RouteKind::MultiLeg: {
+            // Buy ARB/QUOTE -> Sell ARB/INTERMEDIATE -> Sell INTERMEDIATE/USDT, valued via QUOTE/USDT
+            const BookPoint& start = *legs[0];
+            const BookPoint& intermediate = *legs[1];
+            const BookPoint& final = *legs[2];
+            cost = legs[3]->ask_price;
+            proceeds = intermediate.bid_price * final.bid_price / start.ask_price;
+            double step2_arb = std::min(intermediate.bid_qty, start.ask_qty);
+            double step3_intermediate = std::min(final.bid_qty, step2_arb * intermediate.bid_price);
+            result.max_tradable_amount = std::min({start.ask_qty, step2_arb, step3_intermediate / intermediate.bid_price});
+            break;
+        }
+    }
+    
+    if (!std::isfinite(proceeds) || !std::isfinite(cost) || cost <= 0.0) {
+        return result;
+    }
+    result.profit_percent = (proceeds * fee_factor / cost - 1.0) * 100.0;
+    result.valid = true;
+    return result;
+}
+
+// Last state of a symbol at or before time_ns; nullptr if it has none yet
+const BookPoint* stateAt(const std::vector<BookPoint>& timeline, int64_t time_ns) {
+    auto it = std::upper_bound(timeline.begin(), timeline.end(), time_ns,
+                               [](int64_t time, const BookPoint& point) { return time < point.time_ns; });
+    return it == timeline.begin() ? nullptr : &*std::prev(it);
+}
+
+DetectorConfig detectorConfig(const Options& options) {
+    DetectorConfig config = DetectorConfig::defaults(options.threshold_percent);
+    config.fee_percent = options.fee_percent;
+    return config;
+}
+
+template <typename Source>
+void replayTicks(Source& source, const Options& options, FileReplay& replay) {
+    MarketState market_state;
+    DetectorConfig config = detectorConfig(options);
+    ArbitrageDetector detector(market_state, config);
+    SimulatedClock clock;
+    
+    // Resolve the file dictionary and the route table once
+    const uint32_t dictionary_size = source.dictionarySize();
+    std::vector<const std::string*> names(dictionary_size, nullptr);
+    std::vector<OrderBook*> books(dictionary_size, nullptr);
+    std::vector<SymbolId> symbol_ids(dictionary_size, 0);
+    for (uint32_t id = 0; id < dictionary_size; ++id) {
+        const std::string& name = source.symbolName(id);
+        if (name != "?") {
+            names[id] = &name;
+            books[id] = &market_state.get(name);
+            symbol_ids[id] = market_state.getSymbolId(name);
+        }
+    }
+    for (const auto& route : config.routes) {
+        std::array<SymbolId, 4> route_books{};
+        auto pairs = route.allPairs();
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            route_books[i] = market_state.getSymbolId(pairs[i]);
+        }
+        replay.route_kinds.push_back(route.kind);
+        replay.route_books.push_back(route_books);
+        
+        std::array<SymbolId, 3> legs{};
+        for (size_t i = 0; i < route.pairs.size(); ++i) {
+            legs[i] = route_books[i];
+        }
+        replay.route_names.push_back(OpportunityFormatter::routeName(route.kind, legs, market_state));
+    }
+    
+    while (const TickRecord* next = source.next()) {
+        const TickRecord& tick = *next;
+        if (tick.symbol_id >= dictionary_size || books[tick.symbol_id] == nullptr) {
+            continue;
+        }
+        
+        SymbolId symbol = symbol_ids[tick.symbol_id];
+        if (symbol >= replay.timelines.size()) {
+            replay.timelines.resize(symbol + 1);
+        }
+        replay.timelines[symbol].push_back({tick.receive_time_ns, tick.bid_price, tick.bid_qty, tick.ask_price, tick.ask_qty});
+        
+        clock.set(tick.receive_time_ns / 1000000);
+        books[tick.symbol_id]->update(tick.bid_price, tick.bid_qty, tick.ask_price, tick.ask_qty, clock.nowMs());
+        auto opportunity = detector.onBookUpdate(*names[tick.symbol_id]);
+        if (opportunity.has_value()) {
+            const ArbitrageOpportunity& opp = opportunity.value();
+            replay.detections.push_back({tick.receive_time_ns, opp.route_id, opp.direction, opp.profit_percent,
+                                         opp.max_tradable_amount});
+        }
+        replay.ticks++;
+    }
+    
+    // Route symbols that never ticked still need an (empty) timeline
+    for (size_t route = 0; route < replay.route_books.size(); ++route) {
+        for (size_t i = 0; i < bookCount(replay.route_kinds[route]); ++i) {
+            replay.timelines.resize(std::max<size_t>(replay.timelines.size(), replay.route_books[route][i] + 1));
+        }
+    }
+    replay.complete = source.isComplete();
+}
+
+// Capture or archive, recognised by the file header
+FileReplay replayFile(const std::string& path, const Options& options) {
+    FileReplay replay;
+    replay.path = path;
+    auto started = std::chrono::steady_clock::now();
+    
+    if (auto capture = TickCaptureReader::open(path)) {
+        replay.opened = true;
+        CaptureTickSource source(std::move(capture.value()));
+        replayTicks(source, options, replay);
+    } else if (auto archive = TickArchiveReader::open(path)) {
+        replay.opened = true;
+        ArchiveTickSource source(std::move(archive.value()));
+        replayTicks(source, options, replay);
+    }
+    
+    replay.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return replay;
+}
+
+// A range of one file's detections, re-priced by one worker
+struct Chunk {
+    size_t file;
+    size_t begin;
+    size_t end;
+};
+
+Curves repriceChunk(const FileReplay& replay, const Chunk& chunk, const Options& options) {
+    Curves curves;
+    double fee_per_trade = 1.0 - options.fee_percent / 100.0;
+    
+    for (size_t i = chunk.begin; i < chunk.end; ++i) {
+        const Detection& detection = replay.detections[i];
+        RouteKind kind = replay.route_kinds[detection.route_id];
+        const auto& route_books = replay.route_books[detection.route_id];
+        double fee_factor = std::pow(fee_per_trade, kind == RouteKind::DirectComparison ? 2 : 3);
+        
+        auto& curve = curves[replay.route_names[detection.route_id] + " dir" + std::to_string(detection.direction)];
+        curve.resize(options.latencies_us.size());
+        
+        for (size_t point = 0; point < options.latencies_us.size(); ++point) {
+            int64_t at_ns = detection.time_ns + options.latencies_us[point] * 1000;
+            std::array<const BookPoint*, 4> legs{};
+            for (size_t leg = 0; leg < bookCount(kind); ++leg) {
+                legs[leg] = stateAt(replay.timelines[route_books[leg]], at_ns);
+            }
+            
+            Evaluation evaluation = evaluate(kind, detection.direction, legs, fee_factor);
+            CurvePoint& sample = curve[point];
+            sample.samples++;
+            sample.detected_profit_sum += detection.profit_percent;
+            sample.detected_size_sum += detection.max_tradable_amount;
+            if (!evaluation.valid) {
+                continue; // Counts as nothing captured
+            }
+            sample.captured_profit_sum += evaluation.profit_percent;
+            sample.captured_size_sum += evaluation.max_tradable_amount;
+            if (evaluation.profit_percent >= options.threshold_percent) {
+                sample.above_threshold++;
+            }
+            if (evaluation.profit_percent > 0.0) {
+                sample.profitable++;
+            }
+        }
+    }
+    return curves;
+}
+
+void mergeInto(Curves& total, const Curves& curves) {
+    for (const auto& [key, curve] : curves) {
+        auto& merged = total[key];
+        merged.resize(curve.size());
+        for (size_t point = 0; point < curve.size(); ++point) {
+            merged[point].samples += curve[point].samples;
+            merged[point].above_threshold += curve[point].above_threshold;
+            merged[point].profitable += curve[point].profitable;
+            merged[point].detected_profit_sum += curve[point].detected_profit_sum;
+            merged[point].captured_profit_sum += curve[point].captured_profit_sum;
+            merged[point].detected_size_sum += curve[point].detected_size_sum;
+            merged[point].captured_size_sum += curve[point].captured_size_sum;
+        }
+    }
+}
+
+// Captured share of the detected profit; can go negative once the spread has flipped
+double captureRatio(const CurvePoint& point) {
+    return point.detected_profit_sum != 0.0 ? point.captured_profit_sum / point.detected_profit_sum : 0.0;
+}
+
+void printCurve(const std::string& key, const std::vector<CurvePoint>& curve, const Options& options) {
+    std::printf("%s (%llu opportunities)\n", key.c_str(),
+                static_cast<unsigned long long>(curve.empty() ? 0 : curve.front().samples));
+    std::printf("  %10s %11s %11s %9s %9s %9s %9s\n", "latency_us", "detected_%", "captured_%", "capture",
+                "above_thr", "positive", "size");
+    for (size_t point = 0; point < curve.size(); ++point) {
+        const CurvePoint& sample = curve[point];
+        double samples = static_cast<double>(std::max<uint64_t>(1, sample.samples));
+        double size_ratio = sample.detected_size_sum > 0.0 ? sample.captured_size_sum / sample.detected_size_sum : 0.0;
+        std::printf("  %10lld %11.4f %11.4f %8.1f%% %8.1f%% %8.1f%% %8.1f%%\n",
+                    static_cast<long long>(options.latencies_us[point]), sample.detected_profit_sum / samples,
+                    sample.captured_profit_sum / samples, captureRatio(sample) * 100.0,
+                    sample.above_threshold / samples * 100.0, sample.profitable / samples * 100.0, size_ratio * 100.0);
+    }
+    std::printf("\n");
+}
+
+bool writeCsv(const std::string& path, const Curves& curves, const Options& options) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fprintf(file, "route,latency_us,samples,detected_profit_percent,captured_profit_percent,capture_ratio,"
+                       "above_threshold_ratio,positive_ratio,detected_size,captured_size\n");
+    for (const auto& [key, curve] : curves) {
+        for (size_t point = 0; point < curve.size(); ++point) {
+            const CurvePoint& sample = curve[point];
+            double samples = static_cast<double>(std::max<uint64_t>(1, sample.samples));
+            std::fprintf(file, "%s,%lld,%llu,%.6f,%.6f,%.6f,%.6f,%.6f,%.8f,%.8f\n", key.c_str(),
+                         static_cast<long long>(options.latencies_us[point]),
+                         static_cast<unsigned long long>(sample.samples), sample.detected_profit_sum / samples,
+                         sample.captured_profit_sum / samples, captureRatio(sample), sample.above_threshold / samples,
+                         sample.profitable / samples, sample.detected_size_sum / samples,
+                         sample.captured_size_sum / samples);
+        }
+    }
+    std::fclose(file);
+    return true;
+}
+
+// Comma separated, non-negative, sorted and deduplicated
+bool parseLatencies(const std::string& text, std::vector<int64_t>& latencies) {
+    std::vector<int64_t> parsed;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        auto value = NumberParser::parseInteger(item, 0, std::numeric_limits<int64_t>::max());
+        if (!value.has_value()) {
+            return false;
+        }
+        parsed.push_back(value.value());
+    }
+    std::sort(parsed.begin(), parsed.end());
+    parsed.erase(std::unique(parsed.begin(), parsed.end()), parsed.end());
+    if (parsed.empty()) {
+        return false;
+    }
+    latencies.swap(parsed);
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    constexpr double ANY = std::numeric_limits<double>::max();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--threads" && has_value) {
+            auto threads = NumberParser::parseInteger(argv[++i], 1, 1024);
+            if (!threads.has_value()) {
+                return false;
+            }
+            options.threads = static_cast<unsigned>(threads.value());
+        } else if ((arg == "--threshold" || arg == "--fee") && has_value) {
+            // Ranges are checked with the rest of the config by DetectorConfig::validate
+            auto percent = NumberParser::parseDouble(argv[++i], -ANY, ANY);
+            if (!percent.has_value()) {
+                return false;
+            }
+            (arg == "--threshold" ? options.threshold_percent : options.fee_percent) = percent.value();
+        } else if (arg == "--latencies-us" && has_value) {
+            if (!parseLatencies(argv[++i], options.latencies_us)) {
+                return false;
+            }
+        } else if (arg == "--csv" && has_value) {
+            options.csv_path = argv[++i];
+        } else if (arg.rfind("--", 0) == 0) {
+            return false;
+        } else {
+            options.files.push_back(arg);
+        }
+    }
+    return !options.files.empty() && detectorConfig(options).validate();
+}
+
+// Run job(index) for every index below count on up to threads workers
+template <typename Job>
+void runJobs(size_t count, unsigned threads, Job job) {
+    std::atomic<size_t> next_job{0};
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < std::min<size_t>(threads, count); ++t) {
+        workers.emplace_back([&]() {
+            for (size_t index = next_job.fetch_add(1); index < count; index = next_job.fetch_add(1)) {
+                job(index);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: arb_latency_sim <capture/archive files...> [--threads N] [--threshold PERCENT] "
+                             "[--fee PERCENT] [--latencies-us 0,10,100,...] [--csv out.csv]\n");
+        return 2;
+    }
+    
+    unsigned threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    auto started = std::chrono::steady_clock::now();
+    
+    // Detection: whole files per worker
+    std::vector<FileReplay> replays(options.files.size());
+    runJobs(options.files.size(), threads, [&](size_t job) {
+        replays[job] = replayFile(options.files[job], options);
+    });
+    auto detected = std::chrono::steady_clock::now();
+    
+    // Re-pricing: fixed chunks over all files, merged in chunk order
+    std::vector<Chunk> chunks;
+    for (size_t file = 0; file < replays.size(); ++file) {
+        for (size_t begin = 0; begin < replays[file].detections.size(); begin += CHUNK_OPPORTUNITIES) {
+            chunks.push_back({file, begin, std::min(begin + CHUNK_OPPORTUNITIES, replays[file].detections.size())});
+        }
+    }
+    std::vector<Curves> partial(chunks.size());
+    runJobs(chunks.size(), threads, [&](size_t job) {
+        partial[job] = repriceChunk(replays[chunks[job].file], chunks[job], options);
+    });
+    
+    Curves curves;
+    for (const auto& chunk_curves : partial) {
+        mergeInto(curves, chunk_curves);
+    }
+    auto finished = std::chrono::steady_clock::now();
+    
+    uint64_t total_ticks = 0;
+    size_t total_detections = 0;
+    for (const auto& replay : replays) {
+        if (!replay.opened) {
+            std::printf("%s: cannot open or not a capture/archive file\n", replay.path.c_str());
+            continue;
+        }
+        total_ticks += replay.ticks;
+        total_detections += replay.detections.size();
+        std::printf("%s: %llu ticks, %zu opportunities%s\n", replay.path.c_str(),
+                    static_cast<unsigned long long>(replay.ticks), replay.detections.size(),
+                    replay.complete ? "" : " (corrupt block, truncated)");
+    }
+    std::printf("%llu ticks, %zu opportunities x %zu latencies; detection %.3f s, re-pricing %.3f s on %u threads\n\n",
+                static_cast<unsigned long long>(total_ticks), total_detections, options.latencies_us.size(),
+                std::chrono::duration<double>(detected - started).count(),
+                std::chrono::duration<double>(finished - detected).count(), threads);
+    
+    if (curves.empty()) {
+        std::printf("no opportunities\n");
+    }
+    for (const auto& [key, curve] : curves) {
+        printCurve(key, curve, options);
+    }
+    
+    if (!options.csv_path.empty() && !writeCsv(options.csv_path, curves, options)) {
+        std::fprintf(stderr, "cannot write %s\n", options.csv_path.c_str());
+        return 1;
+    }
+    
+    bool all_read = std::all_of(replays.begin(), replays.end(), [](const FileReplay& r) { return r.opened && r.complete; });
+    return all_read ? 0 : 1;
+}
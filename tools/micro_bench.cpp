@@ -0,0 +1,418 @@
+// Micro-benchmarks for the hot-path components (Google Benchmark)
+// Usage: arb_bench [--benchmark_filter=<regex>] [--benchmark_repetitions=N] ...
+//
+// Parser benchmarks run over a corpus of bookTicker frames in the shapes the
+// feeds receive (raw and combined-stream). Book, MarketState and detector
+// benchmarks run on synthetic symbols ("A0/USDT", "A0/BTC", ...); the /N
+// variants scale the symbol or route count. Detector route benchmarks use a
+// route table of one kind only, prices just below the threshold, so every
+// pass evaluates every route without reporting an opportunity.
+
+#include "src/config/ExchangeInfo.hpp"
+#include "src/core/ArbitrageDetector.hpp"
+#include "src/core/MarketState.hpp"
+#include "src/core/OrderBook.hpp"
+#include "src/core/ParallelRouteEvaluator.hpp"
+#include "src/util/JsonParser.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t CORPUS_SIZE = 4096;
+
+const std::vector<std::string> QUOTES = {"USDT", "BTC", "ETH", "FDUSD", "TRY", "EUR"};
+
+std::string assetName(size_t index) {
+    return "A" + std::to_string(index);
+}
+
+// Exchange symbols ("A0USDT") and their pair names ("A0/USDT"), every asset against every quote
+struct SymbolSet {
+    std::vector<std::string> symbols;
+    std::vector<std::string> pairs;
+};
+
+SymbolSet buildSymbols(size_t asset_count) {
+    SymbolSet set;
+    for (size_t a = 0; a < asset_count; ++a) {
+        for (const auto& quote : QUOTES) {
+            set.symbols.push_back(assetName(a) + quote);
+            set.pairs.push_back(assetName(a) + "/" + quote);
+        }
+    }
+    return set;
+}
+
+// Minimal exchangeInfo document for the symbol set
+std::string buildExchangeInfo(size_t asset_count) {
+    std::string json = "{\"timezone\":\"UTC\",\"symbols\":[";
+    for (size_t a = 0; a < asset_count; ++a) {
+        for (size_t q = 0; q < QUOTES.size(); ++q) {
+            if (a > 0 || q > 0) {
+                json += ',';
+            }
+            json += "{\"symbol\":\"" + assetName(a) + QUOTES[q] + "\",\"status\":\"TRADING\",\"baseAsset\":\"" +
+                    assetName(a) + "\",\"quoteAsset\":\"" + QUOTES[q] + "\",\"filters\":[" +
+                    "{\"filterType\":\"PRICE_FILTER\",\"tickSize\":\"0.00000100\"}," +
+                    "{\"filterType\":\"LOT_SIZE\",\"stepSize\":\"0.10000000\"}]}";
+        }
+    }
+    return json + "]}";
+}
+
+// bookTicker frames as Binance sends them: 8-decimal prices, one in four wrapped in a combined-stream envelope
+std::vector<std::string> buildCorpus(const SymbolSet& set) {
+    std::vector<std::string> corpus;
+    corpus.reserve(CORPUS_SIZE);
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> price(0.0001, 90000.0);
+    std::uniform_real_distribution<double> qty(0.1, 250000.0);
+    char buffer[512];
+    for (size_t i = 0; i < CORPUS_SIZE; ++i) {
+        const std::string& symbol = set.symbols[rng() % set.symbols.size()];
+        double bid = price(rng);
+        std::snprintf(buffer, sizeof(buffer),
+                      "{\"u\":%llu,\"s\":\"%s\",\"b\":\"%.8f\",\"B\":\"%.8f\",\"a\":\"%.8f\",\"A\":\"%.8f\"}",
+                      static_cast<unsigned long long>(40000000000ULL + i), symbol.c_str(),
+                      bid, qty(rng), bid * 1.0002, qty(rng));
+        std::string frame = buffer;
+        if (i % 4 == 0) {
+            std::string stream = symbol;
+            for (auto& c : stream) {
+                c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            }
+            frame = "{\"stream\":\"" + stream + "@bookTicker\",\"data\":" + frame + "}";
+        }
+        corpus.push_back(std::move(frame));
+    }
+    return corpus;
+}
+
+// Parser
+
+void BM_ParseBookTicker(benchmark::State& state) {
+    auto set = buildSymbols(64);
+    auto corpus = buildCorpus(set);
+    size_t bytes = 0;
+    size_t i = 0;
+    for (auto _ : state) {
+        const std::string& frame = corpus[i++ % corpus.size()];
+        benchmark::DoNotOptimize(JsonParser::parseBookTicker(frame));
+        bytes += frame.size();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseBookTicker);
+
+void BM_ParseBookTickerUniverse(benchmark::State& state) {
+    size_t assets = static_cast<size_t>(state.range(0));
+    auto universe = SymbolUniverse::parse(buildExchangeInfo(assets), UniverseFilter());
+    auto corpus = buildCorpus(buildSymbols(assets));
+    size_t bytes = 0;
+    size_t i = 0;
+    for (auto _ : state) {
+        const std::string& frame = corpus[i++ % corpus.size()];
+        benchmark::DoNotOptimize(JsonParser::parseBookTicker(frame, &universe.value()));
+        bytes += frame.size();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ParseBookTickerUniverse)->RangeMultiplier(8)->Range(8, 512);
+
+void BM_NormalizeSymbol(benchmark::State& state) {
+    auto set = buildSymbols(64);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(JsonParser::normalizeSymbol(set.symbols[i++ % set.symbols.size()]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NormalizeSymbol);
+
+void BM_NormalizeSymbolUniverse(benchmark::State& state) {
+    size_t assets = static_cast<size_t>(state.range(0));
+    auto universe = SymbolUniverse::parse(buildExchangeInfo(assets), UniverseFilter());
+    auto set = buildSymbols(assets);
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(JsonParser::normalizeSymbol(set.symbols[i++ % set.symbols.size()], &universe.value()));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NormalizeSymbolUniverse)->RangeMultiplier(8)->Range(8, 512);
+
+// Books
+
+void BM_OrderBookUpdate(benchmark::State& state) {
+    OrderBook book;
+    double price = 0.8;
+    int64_t timestamp_ms = 0;
+    for (auto _ : state) {
+        price += 0.0001;
+        book.update(price, 100.0, price * 1.0002, 120.0, ++timestamp_ms);
+    }
+    benchmark::DoNotOptimize(book.snapshot());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderBookUpdate);
+
+void BM_OrderBookSnapshot(benchmark::State& state) {
+    OrderBook book;
+    book.update(0.8, 100.0, 0.8002, 120.0, 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.snapshot());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderBookSnapshot);
+
+// Snapshot readers while thread 0 keeps writing
+void BM_OrderBookSnapshotContended(benchmark::State& state) {
+    static OrderBook book;
+    if (state.thread_index() == 0) {
+        double price = 0.8;
+        for (auto _ : state) {
+            price += 0.0001;
+            book.update(price, 100.0, price * 1.0002, 120.0, 1);
+        }
+    } else {
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(book.snapshot());
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OrderBookSnapshotContended)->Threads(2)->Threads(4);
+
+void BM_MarketStateGet(benchmark::State& state) {
+    auto set = buildSymbols(static_cast<size_t>(state.range(0)) / QUOTES.size() + 1);
+    MarketState market_state;
+    for (const auto& pair : set.pairs) {
+        market_state.get(pair);
+    }
+    // Visit symbols in a shuffled order so lookups are not a sequential walk
+    std::vector<size_t> order(set.pairs.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::shuffle(order.begin(), order.end(), std::mt19937_64(3));
+    size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(&market_state.get(set.pairs[order[i++ % order.size()]]));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MarketStateGet)->RangeMultiplier(8)->Range(8, 32768);
+
+// Detector
+
+// Books and routes for `count` routes of one kind over synthetic assets
+// Prices put every route about 0.05% below break-even
+DetectorConfig buildRoutes(MarketState& market_state, RouteKind kind, size_t count) {
+    DetectorConfig config;
+    config.threshold_percent = 0.10;
+
+    // Quote currencies against USDT
+    const double btc_usdt = 90000.0;
+    const double eur_usdt = 1.08;
+    market_state.get("BTC/USDT").update(btc_usdt, 5.0, btc_usdt * 1.0001, 5.0, 1);
+    market_state.get("EUR/USDT").update(eur_usdt, 5000.0, eur_usdt * 1.0001, 5000.0, 1);
+
+    for (size_t a = 0; a < count; ++a) {
+        std::string asset = assetName(a);
+        double mid = 0.5 + 0.001 * static_cast<double>(a);
+        auto set = [&](const std::string& pair, double price) {
+            market_state.get(pair).update(price * 0.9997, 1000.0, price * 1.0003, 1000.0, 1);
+        };
+        switch (kind) {
+            case RouteKind::CrossPair:
+                set(asset + "/BTC", mid / btc_usdt);
+                set(asset + "/USDT", mid);
+                config.routes.push_back({kind, {asset + "/BTC", "BTC/USDT", asset + "/USDT"}});
+                break;
+            case RouteKind::DirectComparison:
+                set(asset + "/FDUSD", mid);
+                set(asset + "/USDT", mid);
+                config.routes.push_back({kind, {asset + "/FDUSD", asset + "/USDT"}});
+                break;
+            case RouteKind::MultiLeg:
+                set(asset + "/EUR", mid / eur_usdt);
+                set(asset + "/BTC", mid / btc_usdt);
+                config.routes.push_back({kind, {asset + "/EUR", asset + "/BTC", "BTC/USDT"}});
+                break;
+        }
+    }
+    return config;
+}
+
+void checkRoutes(benchmark::State& state, RouteKind kind) {
+    MarketState market_state;
+    size_t count = static_cast<size_t>(state.range(0));
+    ArbitrageDetector detector(market_state, buildRoutes(market_state, kind, count));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(detector.checkOpportunities());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+    state.counters["routes"] = static_cast<double>(count);
+}
+
+void BM_CheckCrossPairRoutes(benchmark::State& state) {
+    checkRoutes(state, RouteKind::CrossPair);
+}
+BENCHMARK(BM_CheckCrossPairRoutes)->RangeMultiplier(4)->Range(1, 1024);
+
+void BM_CheckDirectComparisonRoutes(benchmark::State& state) {
+    checkRoutes(state, RouteKind::DirectComparison);
+}
+BENCHMARK(BM_CheckDirectComparisonRoutes)->RangeMultiplier(4)->Range(1, 1024);
+
+void BM_CheckMultiLegRoutes(benchmark::State& state) {
+    checkRoutes(state, RouteKind::MultiLeg);
+}
+BENCHMARK(BM_CheckMultiLegRoutes)->RangeMultiplier(4)->Range(1, 1024);
+
+// The built-in route table: what checkAllRoutes costs in the default engine
+void BM_CheckAllRoutesDefault(benchmark::State& state) {
+    MarketState market_state;
+    ArbitrageDetector detector(market_state, 0.10);
+    const std::vector<std::pair<std::string, double>> mids = {
+        {"ARB/USDT", 0.80}, {"ARB/BTC", 0.80 / 90000.0}, {"ARB/ETH", 0.80 / 3000.0}, {"ARB/FDUSD", 0.80},
+        {"ARB/USDC", 0.80}, {"ARB/TUSD", 0.80}, {"ARB/TRY", 0.80 * 34.0}, {"ARB/EUR", 0.80 / 1.08},
+        {"BTC/USDT", 90000.0}, {"ETH/USDT", 3000.0}, {"EUR/USDT", 1.08}, {"TRY/USDT", 1.0 / 34.0}};
+    for (const auto& [pair, mid] : mids) {
+        market_state.get(pair).update(mid * 0.9997, 1000.0, mid * 1.0003, 1000.0, 1);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(detector.checkOpportunities());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CheckAllRoutesDefault);
+
+// Every kind mixed in one table, N routes of each
+void BM_CheckAllRoutesMixed(benchmark::State& state) {
+    MarketState market_state;
+    size_t count = static_cast<size_t>(state.range(0));
+    DetectorConfig config = buildRoutes(market_state, RouteKind::CrossPair, count);
+    for (RouteKind kind : {RouteKind::DirectComparison, RouteKind::MultiLeg}) {
+        auto more = buildRoutes(market_state, kind, count);
+        config.routes.insert(config.routes.end(), more.routes.begin(), more.routes.end());
+    }
+    ArbitrageDetector detector(market_state, config);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(detector.checkOpportunities());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(config.routes.size()));
+    state.counters["routes"] = static_cast<double>(config.routes.size());
+}
+BENCHMARK(BM_CheckAllRoutesMixed)->RangeMultiplier(4)->Range(1, 1024);
+
+// Event path: book update plus trigger index check; crossed routes are checked
+// BTC/USDT is a leg of every route, so a crossing here reaches all of them
+void BM_OnBookUpdate(benchmark::State& state) {
+    MarketState market_state;
+    size_t count = static_cast<size_t>(state.range(0));
+    ArbitrageDetector detector(market_state, buildRoutes(market_state, RouteKind::CrossPair, count));
+    OrderBook& book = market_state.get("BTC/USDT");
+    std::mt19937_64 rng(5);
+    std::normal_distribution<double> step(0.0, 0.0001);
+    double mid = 90000.0;
+    for (auto _ : state) {
+        mid *= 1.0 + step(rng);
+        book.update(mid, 5.0, mid * 1.0001, 5.0, 1);
+        benchmark::DoNotOptimize(detector.onBookUpdate("BTC/USDT", book, 0));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["routes"] = static_cast<double>(count);
+}
+BENCHMARK(BM_OnBookUpdate)->RangeMultiplier(4)->Range(1, 1024);
+
+// Event path on a pair read by one route only: every other update crosses its
+// trigger, and the cost should not grow with the rest of the table
+void BM_OnBookUpdateOneRoute(benchmark::State& state) {
+    MarketState market_state;
+    size_t count = static_cast<size_t>(state.range(0));
+    ArbitrageDetector detector(market_state, buildRoutes(market_state, RouteKind::CrossPair, count));
+    std::string pair = assetName(0) + "/USDT";
+    OrderBook& book = market_state.get(pair);
+    double mid = 0.5;
+    bool up = false;
+    for (auto _ : state) {
+        // +0.3% lifts direction 1 over the threshold, the way back drops it again
+        up = !up;
+        double price = up ? mid * 1.003 : mid;
+        book.update(price * 0.9997, 1000.0, price * 1.0003, 1000.0, 1);
+        benchmark::DoNotOptimize(detector.onBookUpdate(pair, book, 0));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["routes"] = static_cast<double>(count);
+    state.counters["opportunities"] = static_cast<double>(detector.getOpportunityCount());
+}
+BENCHMARK(BM_OnBookUpdateOneRoute)->RangeMultiplier(4)->Range(1, 1024);
+
+// One ParallelRouteEvaluator pass over both directions of N assets x 3 quote
+// triangles, by worker count; wall time, since the pass is spread over the pool
+void BM_ParallelRouteEvaluator(benchmark::State& state) {
+    size_t asset_count = static_cast<size_t>(state.range(0));
+    size_t thread_count = static_cast<size_t>(state.range(1));
+    const std::vector<double> quote_usdt_mids = {90000.0, 3000.0, 1.08};  // Books 0..2
+
+    std::vector<BookQuote> quotes;
+    auto add_book = [&](double mid) {
+        quotes.push_back({mid * 0.9999, mid * 1.0001});
+        return static_cast<uint32_t>(quotes.size() - 1);
+    };
+    for (double mid : quote_usdt_mids) {
+        add_book(mid);
+    }
+
+    std::vector<IndexedRoute> routes;
+    double fee_factor = std::pow(1.0 - 0.075 / 100.0, 3);
+    for (size_t a = 0; a < asset_count; ++a) {
+        double asset_usdt = 0.5 + 0.001 * static_cast<double>(a);
+        uint32_t direct = add_book(asset_usdt);
+        for (uint32_t q = 0; q < quote_usdt_mids.size(); ++q) {
+            uint32_t cross = add_book(asset_usdt / quote_usdt_mids[q]);
+            IndexedRoute dir1;
+            dir1.legs[0] = {direct, QuoteSide::Bid, true};
+            dir1.legs[1] = {cross, QuoteSide::Ask, false};
+            dir1.legs[2] = {q, QuoteSide::Ask, false};
+            dir1.leg_count = 3;
+            dir1.id = static_cast<uint32_t>(routes.size());
+            dir1.fee_factor = fee_factor;
+            routes.push_back(dir1);
+
+            IndexedRoute dir2;
+            dir2.legs[0] = {cross, QuoteSide::Bid, true};
+            dir2.legs[1] = {q, QuoteSide::Bid, true};
+            dir2.legs[2] = {direct, QuoteSide::Ask, false};
+            dir2.leg_count = 3;
+            dir2.id = static_cast<uint32_t>(routes.size());
+            dir2.fee_factor = fee_factor;
+            routes.push_back(dir2);
+        }
+    }
+
+    ParallelRouteEvaluator evaluator(std::move(routes), 0.10, thread_count);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(evaluator.evaluate(quotes));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(evaluator.getRouteCount()));
+    state.counters["routes"] = static_cast<double>(evaluator.getRouteCount());
+    state.counters["threads"] = static_cast<double>(thread_count);
+}
+BENCHMARK(BM_ParallelRouteEvaluator)->ArgsProduct({{1024, 16384}, {1, 2, 4, 8}})->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,738 @@
+// Local Binance-compatible bookTicker stream server for end-to-end load tests
+// Usage: arb_mock_exchange [--port 9443] [--bind 127.0.0.1] [--rate 10000] [--threads 1]
+//                          [--replay capture.ticks] [--ping-interval 20] [--close-after 0]
+//                          [--duration 0]
+//
+// Speaks the wss://stream.binance.com protocol over TLS with a self-signed
+// certificate generated at startup (arb_engine does not verify certificates):
+//   /ws/<stream>[/<stream>...]      raw bookTicker frames
+//   /stream?streams=<a>/<b>/...     combined frames {"stream":"..","data":{..}}
+//   {"method":"SUBSCRIBE"|"UNSUBSCRIBE","params":[..],"id":N} on a live connection,
+//   answered with {"result":null,"id":N}
+// Every connection gets --rate messages/s (0 = as fast as the socket drains),
+// round-robin over its streams: a random walk per symbol, or the ticks of a
+// TickCapture file for the connection's symbols, looped. The server pings
+// every --ping-interval seconds and closes each connection with "going away"
+// after --close-after seconds (0 = never), like the real endpoint does after 24h.
+// Point the engine at it with: arb_engine --headless --feed 127.0.0.1:9443
+// Prints messages/s, MB/s and open connections once per second until SIGINT
+// or --duration seconds, then the totals.
+
+#include "src/util/TickCapture.hpp"
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace net = boost::asio;
+namespace ssl = net::ssl;
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace ws = beast::websocket;
+using tcp = net::ip::tcp;
+using Steady = std::chrono::steady_clock;
+
+constexpr const char* STREAM_SUFFIX = "@bookTicker";
+constexpr std::chrono::milliseconds IDLE_POLL{10};  // Connection without streams
+constexpr uint64_t FIRST_UPDATE_ID = 1000000000;
+
+struct Settings {
+    std::string bind = "127.0.0.1";
+    uint16_t port = 9443;
+    double rate = 10000.0;  // Messages/s per connection, 0 = unthrottled
+    size_t threads = 1;
+    std::string replay_path;
+    int ping_interval_s = 20;
+    int close_after_s = 0;
+    int duration_s = 0;
+};
+
+std::atomic<bool> shutdown_requested{false};
+
+extern "C" void onShutdownSignal(int) {
+    shutdown_requested.store(true);
+}
+
+// Ticks of a capture file, in recorded order
+struct ReplayData {
+    struct Tick {
+        uint32_t symbol;  // Index into symbols
+        uint64_t update_id;
+        double bid_price;
+        double bid_qty;
+        double ask_price;
+        double ask_qty;
+    };
+
+    std::vector<std::string> symbols;  // "ARBUSDT" form
+    std::vector<Tick> ticks;
+    uint64_t id_span = 1;  // Added to update ids on every loop so they keep increasing
+};
+
+std::optional<ReplayData> loadReplay(const std::string& path) {
+    auto reader = TickCaptureReader::open(path);
+    if (!reader.has_value()) {
+        return std::nullopt;
+    }
+
+    ReplayData data;
+    std::vector<int64_t> symbol_index;
+    uint64_t min_id = UINT64_MAX;
+    uint64_t max_id = 0;
+    for (size_t i = 0; i < reader->size(); ++i) {
+        const TickRecord& record = reader->at(i);
+        if (record.receive_time_ns == 0) {
+            continue;
+        }
+        if (record.symbol_id >= symbol_index.size()) {
+            symbol_index.resize(record.symbol_id + 1, -1);
+        }
+        if (symbol_index[record.symbol_id] < 0) {
+            std::string name = reader->symbolName(record.symbol_id);
+            name.erase(std::remove(name.begin(), name.end(), '/'), name.end());
+            symbol_index[record.symbol_id] = static_cast<int64_t>(data.symbols.size());
+            data.symbols.push_back(name);
+        }
+        data.ticks.push_back({static_cast<uint32_t>(symbol_index[record.symbol_id]), record.update_id,
+                              record.bid_price, record.bid_qty, record.ask_price, record.ask_qty});
+        min_id = std::min(min_id, record.update_id);
+        max_id = std::max(max_id, record.update_id);
+    }
+    if (data.ticks.empty()) {
+        return std::nullopt;
+    }
+    data.id_span = max_id - min_id + 1;
+    return data;
+}
+
+// Load a throwaway EC P-256 key and a self-signed CN=localhost certificate into the context
+bool useSelfSignedCertificate(ssl::context& ctx) {
+    EVP_PKEY* key = nullptr;
+    EVP_PKEY_CTX* key_ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+    bool ok = key_ctx != nullptr &&
+              EVP_PKEY_keygen_init(key_ctx) > 0 &&
+              EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_ctx, NID_X9_62_prime256v1) > 0 &&
+              EVP_PKEY_keygen(key_ctx, &key) > 0;
+    EVP_PKEY_CTX_free(key_ctx);
+
+    X509* cert = ok ? X509_new() : nullptr;
+    if (cert != nullptr) {
+        X509_set_version(cert, 2);
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 7L * 24 * 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                   reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        ok = X509_sign(cert, key, EVP_sha256()) > 0 &&
+             SSL_CTX_use_certificate(ctx.native_handle(), cert) == 1 &&
+             SSL_CTX_use_PrivateKey(ctx.native_handle(), key) == 1;
+    } else {
+        ok = false;
+    }
+    X509_free(cert);
+    EVP_PKEY_free(key);
+    return ok;
+}
+
+// Per worker thread; single writer, read by the stats loop
+struct alignas(64) WorkerCounters {
+    std::atomic<uint64_t> messages{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> connections{0};  // Currently open
+    std::atomic<uint64_t> accepted{0};
+    std::atomic<uint64_t> pings{0};
+    std::atomic<uint64_t> closes{0};        // Server-initiated
+};
+
+void bump(std::atomic<uint64_t>& counter, uint64_t amount = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+uint64_t hashName(const std::string& text) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (char c : text) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+// One client connection; every handler runs on its worker's single-threaded io_context
+class Session : public std::enable_shared_from_this<Session> {
+public:
+    Session(tcp::socket socket, ssl::context& ctx, const Settings& settings, const ReplayData* replay,
+            WorkerCounters& counters, uint64_t seed)
+        : ws_(std::move(socket), ctx),
+          timer_(ws_.get_executor()),
+          settings_(settings),
+          replay_(replay),
+          counters_(counters),
+          random_(seed | 1) {
+        if (replay_ != nullptr) {
+            replay_stream_.assign(replay_->symbols.size(), -1);
+        }
+    }
+
+    void start() {
+        auto self = shared_from_this();
+        ws_.next_layer().async_handshake(ssl::stream_base::server, [this, self](beast::error_code ec) {
+            if (ec) {
+                return;
+            }
+            http::async_read(ws_.next_layer(), buffer_, request_, [this, self](beast::error_code ec, size_t) {
+                if (ec || !ws::is_upgrade(request_)) {
+                    return;
+                }
+                parseTarget(std::string(request_.target()));
+                ws_.set_option(ws::stream_base::decorator([](ws::response_type& response) {
+                    response.set(http::field::server, "arb_mock_exchange");
+                }));
+                ws_.async_accept(request_, [this, self](beast::error_code ec) {
+                    if (ec) {
+                        return;
+                    }
+                    open_ = true;
+                    established_ = true;
+                    bump(counters_.accepted);
+                    bump(counters_.connections);
+                    Steady::time_point now = Steady::now();
+                    next_ping_ = now + std::chrono::seconds(settings_.ping_interval_s);
+                    close_at_ = now + std::chrono::seconds(settings_.close_after_s);
+                    pace_start_ = now;
+                    buffer_.clear();
+                    ws_.text(true);
+                    read();
+                    write();
+                });
+            });
+        });
+    }
+
+private:
+    struct StreamState {
+        std::string name;    // As requested, e.g. "arbusdt@bookTicker"
+        std::string symbol;  // "ARBUSDT"
+        double mid = 0.0;
+        uint64_t update_id = FIRST_UPDATE_ID;
+    };
+
+    // "/ws/a@bookTicker/b@bookTicker" or "/stream?streams=a@bookTicker/b@bookTicker"
+    void parseTarget(const std::string& target) {
+        std::string list;
+        if (target.compare(0, 7, "/stream") == 0) {
+            combined_ = true;
+            size_t query = target.find("streams=");
+            if (query != std::string::npos) {
+                list = target.substr(query + 8);
+            }
+        } else if (target.compare(0, 4, "/ws/") == 0) {
+            list = target.substr(4);
+        }
+
+        std::vector<std::string> names;
+        size_t begin = 0;
+        while (begin < list.size()) {
+            size_t end = list.find('/', begin);
+            if (end == std::string::npos) {
+                end = list.size();
+            }
+            names.push_back(list.substr(begin, end - begin));
+            begin = end + 1;
+        }
+        addStreams(names);
+    }
+
+    void addStreams(const std::vector<std::string>& names) {
+        for (const auto& name : names) {
+            size_t at = name.find('@');
+            if (at == std::string::npos || name.compare(at, std::string::npos, STREAM_SUFFIX) != 0) {
+                continue;  // Only bookTicker is served
+            }
+            bool present = std::any_of(streams_.begin(), streams_.end(), [&name](const StreamState& stream) {
+                return stream.name == name;
+            });
+            if (present) {
+                continue;
+            }
+            StreamState stream;
+            stream.name = name;
+            stream.symbol = name.substr(0, at);
+            std::transform(stream.symbol.begin(), stream.symbol.end(), stream.symbol.begin(),
+                           [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+            // Deterministic starting mid between 0.01 and ~10000 per symbol
+            uint64_t hash = hashName(stream.symbol);
+            stream.mid = 0.01 * std::pow(10.0, static_cast<double>(hash % 600) / 100.0);
+            stream.update_id = FIRST_UPDATE_ID + hash % 1000000;
+            streams_.push_back(std::move(stream));
+        }
+        rebuildReplayOrder();
+    }
+
+    void removeStreams(const std::vector<std::string>& names) {
+        streams_.erase(std::remove_if(streams_.begin(), streams_.end(), [&names](const StreamState& stream) {
+            return std::find(names.begin(), names.end(), stream.name) != names.end();
+        }), streams_.end());
+        rebuildReplayOrder();
+    }
+
+    // Capture ticks of the subscribed symbols, in recorded order
+    void rebuildReplayOrder() {
+        if (replay_ == nullptr) {
+            return;
+        }
+        std::fill(replay_stream_.begin(), replay_stream_.end(), -1);
+        for (size_t i = 0; i < streams_.size(); ++i) {
+            auto it = std::find(replay_->symbols.begin(), replay_->symbols.end(), streams_[i].symbol);
+            if (it != replay_->symbols.end()) {
+                replay_stream_[static_cast<size_t>(it - replay_->symbols.begin())] = static_cast<int>(i);
+            }
+        }
+        replay_order_.clear();
+        for (size_t i = 0; i < replay_->ticks.size(); ++i) {
+            if (replay_stream_[replay_->ticks[i].symbol] >= 0) {
+                replay_order_.push_back(static_cast<uint32_t>(i));
+            }
+        }
+        replay_position_ = 0;
+    }
+
+    void read() {
+        auto self = shared_from_this();
+        ws_.async_read(buffer_, [this, self](beast::error_code ec, size_t) {
+            if (ec) {
+                finish();
+                return;
+            }
+            handleRequest(beast::buffers_to_string(buffer_.data()));
+            buffer_.consume(buffer_.size());
+            read();
+        });
+    }
+
+    // {"method":"SUBSCRIBE","params":["a@bookTicker"],"id":1}
+    void handleRequest(const std::string& message) {
+        bool subscribe = message.find("\"SUBSCRIBE\"") != std::string::npos;
+        bool unsubscribe = message.find("\"UNSUBSCRIBE\"") != std::string::npos;
+        if (!subscribe && !unsubscribe) {
+            return;
+        }
+
+        std::vector<std::string> names;
+        size_t open = message.find('[');
+        size_t close = message.find(']', open == std::string::npos ? 0 : open);
+        if (open != std::string::npos && close != std::string::npos) {
+            size_t quote = message.find('"', open);
+            while (quote != std::string::npos && quote < close) {
+                size_t end = message.find('"', quote + 1);
+                if (end == std::string::npos || end > close) {
+                    break;
+                }
+                names.push_back(message.substr(quote + 1, end - quote - 1));
+                quote = message.find('"', end + 1);
+            }
+        }
+        if (subscribe) {
+            addStreams(names);
+        } else {
+            removeStreams(names);
+        }
+
+        std::string id = "null";
+        size_t id_pos = message.find("\"id\":");
+        if (id_pos != std::string::npos) {
+            id = std::to_string(std::strtoull(message.c_str() + id_pos + 5, nullptr, 10));
+        }
+        replies_.push_back("{\"result\":null,\"id\":" + id + "}");
+
+        // Answer now, like Binance, rather than with the next paced frame
+        if (waiting_) {
+            timer_.cancel();
+        }
+    }
+
+    // Single write chain: replies, then pings and closes when due, then paced data frames
+    void write() {
+        if (!open_) {
+            return;
+        }
+        auto self = shared_from_this();
+        Steady::time_point now = Steady::now();
+
+        if (settings_.close_after_s > 0 && now >= close_at_) {
+            open_ = false;
+            bump(counters_.closes);
+            ws_.async_close(ws::close_reason(ws::close_code::going_away), [this, self](beast::error_code) {
+                finish();
+            });
+            return;
+        }
+
+        if (settings_.ping_interval_s > 0 && now >= next_ping_) {
+            next_ping_ = now + std::chrono::seconds(settings_.ping_interval_s);
+            bump(counters_.pings);
+            ws_.async_ping({}, [this, self](beast::error_code ec) {
+                if (ec) {
+                    finish();
+                    return;
+                }
+                write();
+            });
+            return;
+        }
+
+        if (!replies_.empty()) {
+            frame_ = std::move(replies_.front());
+            replies_.erase(replies_.begin());
+            send();
+            return;
+        }
+
+        bool idle = replay_ != nullptr ? replay_order_.empty() : streams_.empty();
+        if (idle) {
+            pace_start_ = now;
+            paced_ = 0;
+            wait(now + IDLE_POLL);
+            return;
+        }
+
+        if (settings_.rate > 0.0) {
+            auto due = pace_start_ + std::chrono::nanoseconds(static_cast<int64_t>(paced_ * 1e9 / settings_.rate));
+            if (due > now) {
+                wait(due);
+                return;
+            }
+        }
+
+        buildFrame();
+        ++paced_;
+        send();
+    }
+
+    void send() {
+        auto self = shared_from_this();
+        ws_.async_write(net::buffer(frame_), [this, self](beast::error_code ec, size_t bytes) {
+            if (ec) {
+                finish();
+                return;
+            }
+            bump(counters_.messages);
+            bump(counters_.bytes, bytes);
+            write();
+        });
+    }
+
+    // Sleep until the next frame is due, waking for pings and closes
+    void wait(Steady::time_point until) {
+        if (settings_.ping_interval_s > 0) {
+            until = std::min(until, next_ping_);
+        }
+        if (settings_.close_after_s > 0) {
+            until = std::min(until, close_at_);
+        }
+        auto self = shared_from_this();
+        waiting_ = true;
+        timer_.expires_at(until);
+        timer_.async_wait([this, self](beast::error_code ec) {
+            waiting_ = false;
+            // Cancelled by handleRequest() to send a reply, or by finish(), after which write() stops
+            if (!ec || ec == net::error::operation_aborted) {
+                write();
+            }
+        });
+    }
+
+    uint64_t nextRandom() {
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 7;
+        random_ ^= random_ << 17;
+        return random_;
+    }
+
+    // Next bookTicker payload, wrapped in the combined envelope if needed
+    void buildFrame() {
+        const StreamState* stream;
+        uint64_t update_id;
+        double bid_price;
+        double bid_qty;
+        double ask_price;
+        double ask_qty;
+
+        if (replay_ != nullptr) {
+            const ReplayData::Tick& tick = replay_->ticks[replay_order_[replay_position_]];
+            stream = &streams_[static_cast<size_t>(replay_stream_[tick.symbol])];
+            update_id = tick.update_id + replay_loops_ * replay_->id_span;
+            bid_price = tick.bid_price;
+            bid_qty = tick.bid_qty;
+            ask_price = tick.ask_price;
+            ask_qty = tick.ask_qty;
+            if (++replay_position_ == replay_order_.size()) {
+                replay_position_ = 0;
+                ++replay_loops_;
+            }
+        } else {
+            // Random walk of +-1 bp per update around the symbol's mid, spread 1-3 bp
+            StreamState& state = streams_[next_stream_++ % streams_.size()];
+            double step = static_cast<double>(nextRandom() % 2001) / 1000.0 - 1.0;
+            state.mid *= 1.0 + step * 0.0001;
+            double half_spread = state.mid * (0.5 + static_cast<double>(nextRandom() % 1000) / 1000.0) * 0.0001;
+            update_id = ++state.update_id;
+            bid_price = state.mid - half_spread;
+            ask_price = state.mid + half_spread;
+            bid_qty = 1.0 + static_cast<double>(nextRandom() % 1000000) / 100.0;
+            ask_qty = 1.0 + static_cast<double>(nextRandom() % 1000000) / 100.0;
+            stream = &state;
+        }
+
+        char payload[256];
+        int length = std::snprintf(payload, sizeof(payload),
+                                   "{\"u\":%llu,\"s\":\"%s\",\"b\":\"%.8f\",\"B\":\"%.8f\",\"a\":\"%.8f\",\"A\":\"%.8f\"}",
+                                   static_cast<unsigned long long>(update_id), stream->symbol.c_str(),
+                                   bid_price, bid_qty, ask_price, ask_qty);
+        length = std::clamp(length, 0, static_cast<int>(sizeof(payload) - 1));
+
+        frame_.clear();
+        if (combined_) {
+            frame_ += "{\"stream\":\"";
+            frame_ += stream->name;
+            frame_ += "\",\"data\":";
+            frame_.append(payload, static_cast<size_t>(length));
+            frame_ += '}';
+        } else {
+            frame_.append(payload, static_cast<size_t>(length));
+        }
+    }
+
+    // Connection gone, either side; runs once for the read and once for the write chain
+    void finish() {
+        open_ = false;
+        timer_.cancel();
+        if (established_) {
+            established_ = false;
+            counters_.connections.store(counters_.connections.load(std::memory_order_relaxed) - 1,
+                                        std::memory_order_relaxed);
+        }
+    }
+
+    ws::stream<ssl::stream<tcp::socket>> ws_;
+    net::steady_timer timer_;
+    beast::flat_buffer buffer_;
+    http::request<http::string_body> request_;
+    const Settings& settings_;
+    const ReplayData* replay_;
+    WorkerCounters& counters_;
+    uint64_t random_;
+
+    bool open_ = false;         // Writes allowed
+    bool established_ = false;  // Counted in counters_.connections
+    bool waiting_ = false;      // Write chain asleep in wait()
+    bool combined_ = false;
+    std::vector<StreamState> streams_;
+    size_t next_stream_ = 0;
+    std::vector<std::string> replies_;
+    std::string frame_;
+
+    Steady::time_point next_ping_;
+    Steady::time_point close_at_;
+    Steady::time_point pace_start_;
+    uint64_t paced_ = 0;
+
+    std::vector<int> replay_stream_;      // Replay symbol -> index into streams_, -1 if not subscribed
+    std::vector<uint32_t> replay_order_;  // Ticks to send, in recorded order
+    size_t replay_position_ = 0;
+    uint64_t replay_loops_ = 0;
+};
+
+struct Worker {
+    net::io_context ioc{1};
+    net::executor_work_guard<net::io_context::executor_type> guard{ioc.get_executor()};
+    WorkerCounters counters;
+    std::thread thread;
+};
+
+bool parseSettings(int argc, char* argv[], Settings& settings) {
+    for (int i = 1; i < argc; ++i) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            std::fprintf(stderr, "Missing value for option: %s\n", flag.c_str());
+            return false;
+        }
+        std::string value = argv[++i];
+        if (flag == "--port") {
+            settings.port = static_cast<uint16_t>(std::clamp(std::atoi(value.c_str()), 1, 65535));
+        } else if (flag == "--bind") {
+            settings.bind = value;
+        } else if (flag == "--rate") {
+            settings.rate = std::max(0.0, std::atof(value.c_str()));
+        } else if (flag == "--threads") {
+            settings.threads = std::max<size_t>(1, std::strtoull(value.c_str(), nullptr, 10));
+        } else if (flag == "--replay") {
+            settings.replay_path = value;
+        } else if (flag == "--ping-interval") {
+            settings.ping_interval_s = std::max(0, std::atoi(value.c_str()));
+        } else if (flag == "--close-after") {
+            settings.close_after_s = std::max(0, std::atoi(value.c_str()));
+        } else if (flag == "--duration") {
+            settings.duration_s = std::max(0, std::atoi(value.c_str()));
+        } else {
+            std::fprintf(stderr, "Unknown option: %s\n", flag.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Totals {
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    uint64_t connections = 0;
+    uint64_t accepted = 0;
+    uint64_t pings = 0;
+    uint64_t closes = 0;
+};
+
+Totals sum(const std::vector<std::unique_ptr<Worker>>& workers) {
+    Totals total;
+    for (const auto& worker : workers) {
+        total.messages += worker->counters.messages.load(std::memory_order_relaxed);
+        total.bytes += worker->counters.bytes.load(std::memory_order_relaxed);
+        total.connections += worker->counters.connections.load(std::memory_order_relaxed);
+        total.accepted += worker->counters.accepted.load(std::memory_order_relaxed);
+        total.pings += worker->counters.pings.load(std::memory_order_relaxed);
+        total.closes += worker->counters.closes.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Settings settings;
+    if (!parseSettings(argc, argv, settings)) {
+        return 1;
+    }
+
+    std::optional<ReplayData> replay;
+    if (!settings.replay_path.empty()) {
+        replay = loadReplay(settings.replay_path);
+        if (!replay.has_value()) {
+            std::fprintf(stderr, "Cannot load tick capture: %s\n", settings.replay_path.c_str());
+            return 1;
+        }
+        std::printf("Replaying %zu ticks of %zu symbols from %s\n",
+                    replay->ticks.size(), replay->symbols.size(), settings.replay_path.c_str());
+    }
+
+    ssl::context ctx{ssl::context::tlsv12_server};
+    if (!useSelfSignedCertificate(ctx)) {
+        std::fprintf(stderr, "Cannot create a self-signed certificate\n");
+        return 1;
+    }
+
+    net::io_context accept_ioc{1};
+    tcp::acceptor acceptor(accept_ioc);
+    try {
+        tcp::endpoint endpoint(net::ip::make_address(settings.bind), settings.port);
+        acceptor.open(endpoint.protocol());
+        acceptor.set_option(net::socket_base::reuse_address(true));
+        acceptor.bind(endpoint);
+        acceptor.listen();
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Cannot listen on %s:%u: %s\n", settings.bind.c_str(), settings.port, e.what());
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (size_t i = 0; i < settings.threads; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+        Worker* worker = workers.back().get();
+        worker->thread = std::thread([worker]() { worker->ioc.run(); });
+    }
+
+    // Connections are spread round-robin over the workers
+    const ReplayData* replay_data = replay.has_value() ? &replay.value() : nullptr;
+    uint64_t next_connection = 0;
+    std::function<void()> accept = [&]() {
+        Worker& worker = *workers[next_connection % workers.size()];
+        acceptor.async_accept(worker.ioc, [&, target = &worker](beast::error_code ec, tcp::socket socket) {
+            if (ec) {
+                return;
+            }
+            socket.set_option(tcp::no_delay(true));
+            auto session = std::make_shared<Session>(std::move(socket), ctx, settings, replay_data,
+                                                     target->counters, hashName(std::to_string(next_connection)));
+            net::post(target->ioc, [session]() { session->start(); });
+            ++next_connection;
+            accept();
+        });
+    };
+    accept();
+    std::thread accept_thread([&accept_ioc]() { accept_ioc.run(); });
+
+    std::signal(SIGINT, onShutdownSignal);
+    std::signal(SIGTERM, onShutdownSignal);
+
+    std::printf("Listening on wss://%s:%u (rate %.0f msg/s per connection%s, %zu threads)\n",
+                settings.bind.c_str(), settings.port, settings.rate, settings.rate > 0.0 ? "" : " = unthrottled",
+                settings.threads);
+    std::fflush(stdout);
+
+    Steady::time_point started = Steady::now();
+    Totals previous;
+    int seconds = 0;
+    while (!shutdown_requested.load() && (settings.duration_s == 0 || seconds < settings.duration_s)) {
+        std::this_thread::sleep_until(started + std::chrono::seconds(seconds + 1));
+        ++seconds;
+        Totals current = sum(workers);
+        uint64_t messages = current.messages - previous.messages;
+        uint64_t bytes = current.bytes - previous.bytes;
+        std::printf("%4ds  %9llu msg/s  %7.2f MB/s  %4llu connections (%llu accepted, %llu closed by server)\n",
+                    seconds, static_cast<unsigned long long>(messages), static_cast<double>(bytes) / 1e6,
+                    static_cast<unsigned long long>(current.connections),
+                    static_cast<unsigned long long>(current.accepted),
+                    static_cast<unsigned long long>(current.closes));
+        std::fflush(stdout);
+        previous = current;
+    }
+
+    net::post(accept_ioc, [&acceptor]() { acceptor.close(); });
+    accept_ioc.stop();
+    accept_thread.join();
+    for (auto& worker : workers) {
+        worker->ioc.stop();
+        worker->thread.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(Steady::now() - started).count();
+    Totals total = sum(workers);
+    std::printf("Total: %llu messages, %.2f MB in %.1fs (%.0f msg/s), %llu connections, %llu pings\n",
+                static_cast<unsigned long long>(total.messages),
+                static_cast<double>(total.bytes) / 1e6, elapsed,
+                static_cast<double>(total.messages) / std::max(elapsed, 1e-9),
+                static_cast<unsigned long long>(total.accepted),
+                static_cast<unsigned long long>(total.pings));
+    return 0;
+}
@@ -0,0 +1,221 @@
+// Market state write path benchmark: shared locks vs single-writer SPSC pipeline
+// Usage: arb_pipeline_bench [producers=4] [updates_per_producer=200000] [rate_per_producer=0]
+//
+// Every producer thread plays one feed connection and owns a disjoint slice
+// of the built-in symbol set. The shared-lock run applies each update on the
+// producer thread (MarketState lookup, book lock, trigger lock), like the
+// default engine. The pipeline run publishes into per-producer rings and one
+// market-state thread applies and detects. rate_per_producer paces each
+// producer in updates/s; 0 publishes flat out (saturation throughput).
+
+#include "src/core/ArbitrageDetector.hpp"
+#include "src/core/MarketState.hpp"
+#include "src/core/MarketUpdatePipeline.hpp"
+#include "src/config/Symbols.hpp"
+#include "src/util/LatencyHistogram.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Steady = std::chrono::steady_clock;
+
+// Pre-generated random walk around a fixed mid per symbol
+std::vector<std::vector<BookUpdate>> buildUpdates(MarketState& market_state, const std::vector<std::string>& symbols,
+                                                  size_t producers, size_t per_producer) {
+    std::vector<std::vector<BookUpdate>> updates(producers);
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> step(0.0, 0.0004);
+    std::vector<double> mids(symbols.size());
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        mids[i] = symbols[i].find("ARB/") == 0 ? 0.8 : 1.0;
+    }
+    
+    for (size_t p = 0; p < producers; ++p) {
+        // Producer p owns symbols p, p + producers, ...
+        std::vector<size_t> owned;
+        for (size_t i = p; i < symbols.size(); i += producers) {
+            owned.push_back(i);
+        }
+        if (owned.empty()) {
+            continue;
+        }
+        updates[p].reserve(per_producer);
+        for (size_t n = 0; n < per_producer; ++n) {
+            size_t i = owned[n % owned.size()];
+            mids[i] *= 1.0 + step(rng);
+            BookUpdate update;
+            update.symbol_id = market_state.getSymbolId(symbols[i]);
+            update.update_id = n;
+            update.bid_price = mids[i] * 0.9995;
+            update.bid_qty = 100.0;
+            update.ask_price = mids[i] * 1.0005;
+            update.ask_qty = 100.0;
+            update.timestamp_ms = static_cast<int64_t>(n);
+            update.receive_ns = 0;
+            update.parsed_ns = 0;
+            updates[p].push_back(update);
+        }
+    }
+    return updates;
+}
+
+struct RunResult {
+    double seconds = 0.0;
+    uint64_t applied = 0;
+    uint64_t full_retries = 0;  // Pipeline only: publishes that found the ring full
+    HistogramSnapshot receive_to_detect;
+};
+
+// Sleep-free pacing: spin until the producer's next slot
+void pace(Steady::time_point started, size_t n, double rate) {
+    if (rate <= 0.0) {
+        return;
+    }
+    auto due = started + std::chrono::duration_cast<Steady::duration>(std::chrono::duration<double>(n / rate));
+    while (Steady::now() < due) {
+    }
+}
+
+HistogramSnapshot receiveToDetect() {
+    return PipelineLatency::merge()[static_cast<size_t>(PipelineStage::ReceiveToDetect)];
+}
+
+RunResult runSharedLock(const std::vector<std::string>& symbols, size_t producers, size_t per_producer, double rate) {
+    MarketState market_state;
+    auto updates = buildUpdates(market_state, symbols, producers, per_producer);
+    ArbitrageDetector detector(market_state, 0.10);
+    HistogramSnapshot before = receiveToDetect();
+    
+    // Feeds parse the symbol name out of the frame; no id lookup on their path
+    std::vector<std::string> names;
+    for (SymbolId id = 0; market_state.getSymbolName(id) != "?"; ++id) {
+        names.push_back(market_state.getSymbolName(id));
+    }
+    
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!go.load()) {
+            }
+            auto started = Steady::now();
+            for (size_t n = 0; n < updates[p].size(); ++n) {
+                pace(started, n, rate);
+                const BookUpdate& update = updates[p][n];
+                uint64_t receive_ns = PipelineLatency::nowNs();
+                const std::string& symbol = names[update.symbol_id];
+                market_state.get(symbol).update(update.bid_price, update.bid_qty, update.ask_price, update.ask_qty,
+                                                update.timestamp_ms);
+                detector.onBookUpdate(symbol, receive_ns);
+                PipelineLatency::record(PipelineStage::ReceiveToDetect, PipelineLatency::nowNs() - receive_ns);
+            }
+        });
+    }
+    
+    auto started = Steady::now();
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    RunResult result;
+    result.seconds = std::chrono::duration<double>(Steady::now() - started).count();
+    for (const auto& list : updates) {
+        result.applied += list.size();
+    }
+    result.receive_to_detect = receiveToDetect().since(before);
+    return result;
+}
+
+RunResult runPipeline(const std::vector<std::string>& symbols, size_t producers, size_t per_producer, double rate) {
+    MarketState market_state;
+    auto updates = buildUpdates(market_state, symbols, producers, per_producer);
+    ArbitrageDetector detector(market_state, 0.10);
+    MarketUpdatePipeline pipeline(market_state, &detector);
+    std::vector<size_t> handles;
+    uint64_t total = 0;
+    for (size_t p = 0; p < producers; ++p) {
+        handles.push_back(pipeline.addProducer());
+        total += updates[p].size();
+    }
+    HistogramSnapshot before = receiveToDetect();
+    pipeline.start();
+    
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p]() {
+            while (!go.load()) {
+            }
+            auto started = Steady::now();
+            for (size_t n = 0; n < updates[p].size(); ++n) {
+                pace(started, n, rate);
+                BookUpdate update = updates[p][n];
+                update.receive_ns = PipelineLatency::nowNs();
+                update.parsed_ns = update.receive_ns;
+                // The benchmark must not lose updates: retry on a full ring (counted as an overflow)
+                while (!pipeline.publish(handles[p], update)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    
+    auto started = Steady::now();
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    while (pipeline.getStats().applied < total) {
+        std::this_thread::yield();
+    }
+    
+    RunResult result;
+    result.seconds = std::chrono::duration<double>(Steady::now() - started).count();
+    pipeline.stop();
+    PipelineStats stats = pipeline.getStats();
+    result.applied = stats.applied;
+    result.full_retries = stats.overflows;
+    result.receive_to_detect = receiveToDetect().since(before);
+    return result;
+}
+
+void print(const char* name, const RunResult& result) {
+    std::printf("%-12s %10llu %9.3f %12.0f %10.2f %10.2f %10.2f %12llu\n", name,
+                static_cast<unsigned long long>(result.applied), result.seconds,
+                result.seconds > 0.0 ? result.applied / result.seconds : 0.0,
+                result.receive_to_detect.percentile(0.50) / 1000.0,
+                result.receive_to_detect.percentile(0.99) / 1000.0,
+                result.receive_to_detect.percentile(0.999) / 1000.0,
+                static_cast<unsigned long long>(result.full_retries));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t producers = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 4;
+    size_t per_producer = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+    double rate = argc > 3 ? std::atof(argv[3]) : 0.0;
+    if (producers == 0 || per_producer == 0) {
+        std::fprintf(stderr, "usage: arb_pipeline_bench [producers=4] [updates_per_producer=200000] [rate_per_producer=0]\n");
+        return 2;
+    }
+    
+    auto symbols = Symbols::getAllSymbols();
+    std::printf("%zu producers x %zu updates over %zu symbols, %s\n", producers, per_producer, symbols.size(),
+                rate > 0.0 ? (std::to_string(static_cast<long long>(rate)) + " updates/s each").c_str() : "unpaced");
+    std::printf("%-12s %10s %9s %12s %10s %10s %10s %12s\n", "mode", "updates", "seconds", "updates/s",
+                "p50_us", "p99_us", "p999_us", "ring_full");
+    
+    print("shared-lock", runSharedLock(symbols, producers, per_producer, rate));
+    print("spsc", runPipeline(symbols, producers, per_producer, rate));
+    return 0;
+}
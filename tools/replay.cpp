@@ -0,0 +1,393 @@
+// Deterministic replay of tick capture or archive files through the detection pipeline
+// Usage: arb_replay <capture/archive files...> [--config FILE] [--threads N] [--threshold PERCENT]
+//                   [--fee PERCENT] [--period-ms MS] [--opportunities out.csv]
+//
+// Routes, threshold and fee come from an engine config file (--config, the
+// built-in ARB table without it); --threshold and --fee override the file.
+//
+// Every file is an independent job with its own MarketState, detector and
+// tracker, driven by a simulated clock taken from the recorded receive times.
+// Nothing sleeps: files replay as fast as the CPU allows, one job per worker
+// thread, and the per-file results are merged into one report. Output depends
+// only on the input files, never on wall-clock time or thread scheduling.
+
+#include "src/core/ArbitrageDetector.hpp"
+#include "src/core/MarketState.hpp"
+#include "src/core/OpportunityFormatter.hpp"
+#include "src/core/OpportunityTracker.hpp"
+#include "src/config/EngineConfig.hpp"
+#include "src/util/Clock.hpp"
+#include "src/util/NumberParser.hpp"
+#include "src/util/TickSource.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Upper bounds (percent) of the profit distribution buckets; the last bucket is open
+constexpr std::array<double, 5> PROFIT_BUCKETS = {0.2, 0.5, 1.0, 2.0, 5.0};
+
+struct Options {
+    std::vector<std::string> files;
+    unsigned threads = 0;
+    std::string config_path;  // Empty: built-in routes
+    std::optional<double> threshold_percent;  // Overrides the config file
+    std::optional<double> fee_percent;        // Overrides the config file
+    int64_t period_ms = 100;  // Heartbeat period, as in the live detector thread
+    std::string opportunities_path;
+    DetectorConfig detector;  // Resolved from the above by loadDetectorConfig
+};
+
+// One opportunity reported by the event path
+struct ReplayOpportunity {
+    int64_t timestamp_ms;
+    std::string route;
+    int direction;
+    double profit_percent;
+    double max_tradable_amount;
+};
+
+struct RouteSummary {
+    uint64_t opportunities = 0;  // Event-path sightings
+    uint64_t episodes = 0;
+    double max_profit_percent = 0.0;
+    double profit_sum = 0.0;
+    int64_t longest_episode_ms = 0;
+    std::array<uint64_t, PROFIT_BUCKETS.size() + 1> profit_buckets{};  // Episode peak profit
+};
+
+struct ReplayResult {
+    std::string path;
+    bool opened = false;
+    bool complete = true;  // False if an archive block failed to decode
+    uint64_t ticks = 0;
+    uint64_t skipped = 0;  // Records with an unknown symbol or invalid book
+    int64_t first_ms = 0;
+    int64_t last_ms = 0;
+    double elapsed_seconds = 0.0;
+    std::map<std::string, RouteSummary> routes;  // "route name dirN"
+    std::vector<ReplayOpportunity> opportunities;
+};
+
+std::string routeKey(const ArbitrageOpportunity& opp, const MarketState& market_state) {
+    return OpportunityFormatter::routeName(opp, market_state) + " dir" + std::to_string(opp.direction);
+}
+
+void addEpisodes(ReplayResult& result, const std::vector<OpportunityEpisode>& closed, const MarketState& market_state) {
+    for (const auto& episode : closed) {
+        RouteSummary& summary = result.routes[routeKey(episode.peak, market_state)];
+        summary.episodes++;
+        summary.longest_episode_ms = std::max(summary.longest_episode_ms, episode.durationMs());
+        
+        size_t bucket = 0;
+        while (bucket < PROFIT_BUCKETS.size() && episode.peak.profit_percent >= PROFIT_BUCKETS[bucket]) {
+            ++bucket;
+        }
+        summary.profit_buckets[bucket]++;
+    }
+}
+
+template <typename Source>
+void replayTicks(Source& source, const Options& options, ReplayResult& result) {
+    MarketState market_state;
+    ArbitrageDetector detector(market_state, options.detector);
+    OpportunityTracker tracker;
+    SimulatedClock clock;
+    std::vector<OpportunityEpisode> closed;
+    
+    // Resolve the file dictionary once
+    const uint32_t dictionary_size = source.dictionarySize();
+    std::vector<const std::string*> names(dictionary_size, nullptr);
+    std::vector<OrderBook*> books(dictionary_size, nullptr);
+    for (uint32_t id = 0; id < dictionary_size; ++id) {
+        const std::string& name = source.symbolName(id);
+        if (name != "?") {
+            names[id] = &name;
+            books[id] = &market_state.get(name);
+        }
+    }
+    
+    auto heartbeat = [&](int64_t now_ms) {
+        detector.publishResults();
+        auto results = detector.getResults();
+        for (const auto& route : results->routes) {
+            if (route.has_opportunity) {
+                tracker.observe(route.opportunity, now_ms);
+            }
+        }
+        if (results->best_from_event_path) {
+            tracker.observe(results->best.value(), now_ms);
+        }
+        tracker.endPass(now_ms, closed);
+        addEpisodes(result, closed, market_state);
+        closed.clear();
+    };
+    
+    int64_t next_heartbeat_ms = 0;
+    while (const TickRecord* next = source.next()) {
+        const TickRecord& tick = *next;
+        if (tick.symbol_id >= dictionary_size || books[tick.symbol_id] == nullptr) {
+            result.skipped++;
+            continue;
+        }
+        
+        int64_t tick_ms = tick.receive_time_ns / 1000000;
+        if (result.ticks == 0) {
+            result.first_ms = tick_ms;
+            next_heartbeat_ms = tick_ms + options.period_ms;
+        }
+        
+        // Heartbeats that fell due before this tick
+        while (next_heartbeat_ms <= tick_ms) {
+            clock.set(next_heartbeat_ms);
+            heartbeat(clock.nowMs());
+            next_heartbeat_ms += options.period_ms;
+        }
+        clock.set(tick_ms);
+        
+        books[tick.symbol_id]->update(tick.bid_price, tick.bid_qty, tick.ask_price, tick.ask_qty, clock.nowMs());
+        auto opportunity = detector.onBookUpdate(*names[tick.symbol_id]);
+        if (opportunity.has_value()) {
+            const ArbitrageOpportunity& opp = opportunity.value();
+            std::string key = routeKey(opp, market_state);
+            RouteSummary& summary = result.routes[key];
+            summary.opportunities++;
+            summary.max_profit_percent = std::max(summary.max_profit_percent, opp.profit_percent);
+            summary.profit_sum += opp.profit_percent;
+            
+            if (!options.opportunities_path.empty()) {
+                result.opportunities.push_back({clock.nowMs(), OpportunityFormatter::routeName(opp, market_state),
+                                                opp.direction, opp.profit_percent, opp.max_tradable_amount});
+            }
+        }
+        result.ticks++;
+    }
+    
+    // Final pass, then close what is still open at the end of the file
+    if (result.ticks > 0) {
+        result.last_ms = clock.nowMs();
+        heartbeat(clock.nowMs());
+        tracker.closeAll(clock.nowMs(), closed);
+        addEpisodes(result, closed, market_state);
+    }
+    result.complete = source.isComplete();
+}
+
+// Capture or archive, recognised by the file header
+ReplayResult replayFile(const std::string& path, const Options& options) {
+    ReplayResult result;
+    result.path = path;
+    auto started = std::chrono::steady_clock::now();
+    
+    if (auto capture = TickCaptureReader::open(path)) {
+        result.opened = true;
+        CaptureTickSource source(std::move(capture.value()));
+        replayTicks(source, options, result);
+    } else if (auto archive = TickArchiveReader::open(path)) {
+        result.opened = true;
+        ArchiveTickSource source(std::move(archive.value()));
+        replayTicks(source, options, result);
+    }
+    
+    result.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    return result;
+}
+
+void mergeInto(std::map<std::string, RouteSummary>& total, const std::map<std::string, RouteSummary>& routes) {
+    for (const auto& [key, summary] : routes) {
+        RouteSummary& merged = total[key];
+        merged.opportunities += summary.opportunities;
+        merged.episodes += summary.episodes;
+        merged.max_profit_percent = std::max(merged.max_profit_percent, summary.max_profit_percent);
+        merged.profit_sum += summary.profit_sum;
+        merged.longest_episode_ms = std::max(merged.longest_episode_ms, summary.longest_episode_ms);
+        for (size_t i = 0; i < merged.profit_buckets.size(); ++i) {
+            merged.profit_buckets[i] += summary.profit_buckets[i];
+        }
+    }
+}
+
+bool writeOpportunities(const std::string& path, const std::vector<ReplayResult>& results) {
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fprintf(file, "file,timestamp_ms,route,direction,profit_percent,max_tradable_amount\n");
+    for (const auto& result : results) {
+        for (const auto& opp : result.opportunities) {
+            std::fprintf(file, "%s,%lld,%s,%d,%.6f,%.8f\n", result.path.c_str(), static_cast<long long>(opp.timestamp_ms),
+                         opp.route.c_str(), opp.direction, opp.profit_percent, opp.max_tradable_amount);
+        }
+    }
+    std::fclose(file);
+    return true;
+}
+
+void printReport(const std::vector<ReplayResult>& results, double wall_seconds) {
+    uint64_t total_ticks = 0;
+    uint64_t total_skipped = 0;
+    std::printf("%-40s %12s %10s %10s %14s\n", "file", "ticks", "span_s", "cpu_s", "ticks/s");
+    for (const auto& result : results) {
+        if (!result.opened) {
+            std::printf("%-40s  cannot open or not a capture/archive file\n", result.path.c_str());
+            continue;
+        }
+        total_ticks += result.ticks;
+        total_skipped += result.skipped;
+        double rate = result.elapsed_seconds > 0.0 ? result.ticks / result.elapsed_seconds : 0.0;
+        std::printf("%-40s %12llu %10.1f %10.3f %14.0f%s\n", result.path.c_str(),
+                    static_cast<unsigned long long>(result.ticks), (result.last_ms - result.first_ms) / 1000.0,
+                    result.elapsed_seconds, rate, result.complete ? "" : "  (corrupt block, truncated)");
+    }
+    std::printf("total: %llu ticks (%llu skipped) in %.3f s wall, %.0f ticks/s\n\n",
+                static_cast<unsigned long long>(total_ticks), static_cast<unsigned long long>(total_skipped),
+                wall_seconds, wall_seconds > 0.0 ? total_ticks / wall_seconds : 0.0);
+    
+    std::map<std::string, RouteSummary> routes;
+    for (const auto& result : results) {
+        mergeInto(routes, result.routes);
+    }
+    if (routes.empty()) {
+        std::printf("no opportunities\n");
+        return;
+    }
+    
+    std::printf("%-36s %8s %8s %9s %9s %10s", "route", "opps", "episodes", "max_%", "mean_%", "longest_ms");
+    char label[16];
+    for (double upper : PROFIT_BUCKETS) {
+        std::snprintf(label, sizeof(label), "<%.1f", upper);
+        std::printf(" %6s", label);
+    }
+    std::snprintf(label, sizeof(label), ">=%.1f", PROFIT_BUCKETS.back());
+    std::printf(" %6s\n", label);
+    
+    for (const auto& [key, summary] : routes) {
+        double mean = summary.opportunities > 0 ? summary.profit_sum / summary.opportunities : 0.0;
+        std::printf("%-36s %8llu %8llu %9.4f %9.4f %10lld", key.c_str(),
+                    static_cast<unsigned long long>(summary.opportunities), static_cast<unsigned long long>(summary.episodes),
+                    summary.max_profit_percent, mean, static_cast<long long>(summary.longest_episode_ms));
+        for (uint64_t count : summary.profit_buckets) {
+            std::printf(" %6llu", static_cast<unsigned long long>(count));
+        }
+        std::printf("\n");
+    }
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    constexpr double ANY = std::numeric_limits<double>::max();
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--threads" && has_value) {
+            auto threads = NumberParser::parseInteger(argv[++i], 1, 1024);
+            if (!threads.has_value()) {
+                return false;
+            }
+            options.threads = static_cast<unsigned>(threads.value());
+        } else if (arg == "--config" && has_value) {
+            options.config_path = argv[++i];
+        } else if ((arg == "--threshold" || arg == "--fee") && has_value) {
+            // Ranges are checked with the rest of the config by DetectorConfig::validate
+            auto percent = NumberParser::parseDouble(argv[++i], -ANY, ANY);
+            if (!percent.has_value()) {
+                return false;
+            }
+            (arg == "--threshold" ? options.threshold_percent : options.fee_percent) = percent;
+        } else if (arg == "--period-ms" && has_value) {
+            auto period_ms = NumberParser::parseInteger(argv[++i], 1, std::numeric_limits<int64_t>::max());
+            if (!period_ms.has_value()) {
+                return false;
+            }
+            options.period_ms = period_ms.value();
+        } else if (arg == "--opportunities" && has_value) {
+            options.opportunities_path = argv[++i];
+        } else if (arg.rfind("--", 0) == 0) {
+            return false;
+        } else {
+            options.files.push_back(arg);
+        }
+    }
+    return !options.files.empty();
+}
+
+// Routes, threshold and fee from --config (built-in table without it), then the command line overrides
+bool loadDetectorConfig(Options& options, std::string& error) {
+    DetectorConfig config = DetectorConfig::defaults();
+    if (!options.config_path.empty()) {
+        auto loaded = EngineConfig::loadFromFile(options.config_path, &error);
+        if (!loaded.has_value()) {
+            error = options.config_path + ": " + error;
+            return false;
+        }
+        config = std::move(loaded->detector);
+    }
+    if (options.threshold_percent.has_value()) {
+        config.threshold_percent = options.threshold_percent.value();
+    }
+    if (options.fee_percent.has_value()) {
+        config.fee_percent = options.fee_percent.value();
+    }
+    if (!config.validate(&error)) {
+        error = "invalid detector config: " + error;
+        return false;
+    }
+    options.detector = std::move(config);
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::fprintf(stderr, "usage: arb_replay <capture/archive files...> [--config FILE] [--threads N] "
+                             "[--threshold PERCENT] [--fee PERCENT] [--period-ms MS] [--opportunities out.csv]\n");
+        return 2;
+    }
+    std::string error;
+    if (!loadDetectorConfig(options, error)) {
+        std::fprintf(stderr, "arb_replay: %s\n", error.c_str());
+        return 2;
+    }
+    
+    unsigned threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<unsigned>(threads, static_cast<unsigned>(options.files.size()));
+    
+    // Workers pull whole files; results keep command line order
+    std::vector<ReplayResult> results(options.files.size());
+    std::atomic<size_t> next_job{0};
+    auto started = std::chrono::steady_clock::now();
+    
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&]() {
+            for (size_t job = next_job.fetch_add(1); job < options.files.size(); job = next_job.fetch_add(1)) {
+                results[job] = replayFile(options.files[job], options);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    printReport(results, wall_seconds);
+    
+    if (!options.opportunities_path.empty() && !writeOpportunities(options.opportunities_path, results)) {
+        std::fprintf(stderr, "cannot write %s\n", options.opportunities_path.c_str());
+        return 1;
+    }
+    
+    bool all_read = std::all_of(results.begin(), results.end(), [](const ReplayResult& r) { return r.opened && r.complete; });
+    return all_read ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+// Route evaluation scaling benchmark on a synthetic symbol universe
+// Usage: arb_route_scaling [assets=2000] [max_threads=hardware] [passes=500]
+//
+// Builds every USDT triangle (ASSET/QUOTE, QUOTE/USDT vs ASSET/USDT, both
+// directions) for a synthetic set of assets and quote currencies, then times
+// ParallelRouteEvaluator passes from 1 to max_threads workers.
+
+#include "src/core/ParallelRouteEvaluator.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct SyntheticUniverse {
+    std::vector<IndexedRoute> routes;
+    std::vector<BookQuote> quotes;
+    std::vector<double> mids;
+};
+
+// Books are laid out asset by asset so that the routes of one asset read adjacent quotes
+SyntheticUniverse buildUniverse(size_t asset_count) {
+    const std::vector<double> quote_usdt_mids = {90000.0, 3000.0, 600.0, 1.08, 1.0 / 34.0, 1.0};  // BTC ETH BNB EUR TRY FDUSD
+    SyntheticUniverse universe;
+
+    // Quote currencies against USDT come first
+    for (double mid : quote_usdt_mids) {
+        universe.mids.push_back(mid);
+    }
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> asset_price(0.01, 50.0);
+
+    uint32_t route_id = 0;
+    for (size_t a = 0; a < asset_count; ++a) {
+        double asset_usdt = asset_price(rng);
+
+        uint32_t asset_usdt_book = static_cast<uint32_t>(universe.mids.size());
+        universe.mids.push_back(asset_usdt);
+
+        for (size_t q = 0; q < quote_usdt_mids.size(); ++q) {
+            uint32_t asset_quote_book = static_cast<uint32_t>(universe.mids.size());
+            universe.mids.push_back(asset_usdt / quote_usdt_mids[q]);
+            uint32_t quote_usdt_book = static_cast<uint32_t>(q);
+
+            // Direction 1: buy ASSET/QUOTE, buy QUOTE/USDT, sell ASSET/USDT
+            IndexedRoute dir1;
+            dir1.legs[0] = {asset_usdt_book, QuoteSide::Bid, true};
+            dir1.legs[1] = {asset_quote_book, QuoteSide::Ask, false};
+            dir1.legs[2] = {quote_usdt_book, QuoteSide::Ask, false};
+            dir1.leg_count = 3;
+            dir1.id = route_id++;
+            universe.routes.push_back(dir1);
+
+            // Direction 2: buy ASSET/USDT, sell ASSET/QUOTE, sell QUOTE/USDT
+            IndexedRoute dir2;
+            dir2.legs[0] = {asset_quote_book, QuoteSide::Bid, true};
+            dir2.legs[1] = {quote_usdt_book, QuoteSide::Bid, true};
+            dir2.legs[2] = {asset_usdt_book, QuoteSide::Ask, false};
+            dir2.leg_count = 3;
+            dir2.id = route_id++;
+            universe.routes.push_back(dir2);
+        }
+    }
+
+    universe.quotes.resize(universe.mids.size());
+    return universe;
+}
+
+// Random walk every book by a few basis points with a 2 bp spread
+void tick(SyntheticUniverse& universe, std::mt19937_64& rng) {
+    std::normal_distribution<double> step(0.0, 0.0003);
+    for (size_t i = 0; i < universe.mids.size(); ++i) {
+        double mid = universe.mids[i] * (1.0 + step(rng));
+        universe.quotes[i].bid_price = mid * (1.0 - 0.0001);
+        universe.quotes[i].ask_price = mid * (1.0 + 0.0001);
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    size_t asset_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000;
+    size_t max_threads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::thread::hardware_concurrency();
+    size_t passes = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 500;
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    SyntheticUniverse universe = buildUniverse(asset_count);
+    std::printf("books=%zu routes=%zu passes=%zu\n", universe.quotes.size(), universe.routes.size(), passes);
+    std::printf("%8s %12s %14s %10s %10s\n", "threads", "passes/s", "routes/s", "speedup", "above_thr");
+
+    double single_thread_rate = 0.0;
+    for (size_t threads = 1; threads <= max_threads; ++threads) {
+        ParallelRouteEvaluator evaluator(universe.routes, 0.10, threads);
+        std::mt19937_64 rng(7);
+
+        // Only the evaluation passes are timed, not the synthetic market moves
+        size_t above_threshold = 0;
+        double elapsed = 0.0;
+        for (size_t p = 0; p < passes; ++p) {
+            tick(universe, rng);
+            auto start = std::chrono::steady_clock::now();
+            above_threshold += evaluator.evaluate(universe.quotes).routes_above_threshold;
+            elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        double rate = passes / elapsed;
+        if (threads == 1) {
+            single_thread_rate = rate;
+        }
+        std::printf("%8zu %12.1f %14.0f %10.2f %10zu\n", threads, rate,
+                    rate * evaluator.getRouteCount(), rate / single_thread_rate, above_threshold);
+    }
+
+    return 0;
+}